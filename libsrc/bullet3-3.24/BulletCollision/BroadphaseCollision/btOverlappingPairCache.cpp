@@ -226,6 +226,24 @@ btBroadphasePair* btHashedOverlappingPairCache::internalAddPair(btBroadphaseProx
 	return pair;
 }
 
+// ROCKETSIM CHANGE: Remove every pair at once, used by btRSBroadphase every tick
+void btHashedOverlappingPairCache::removeAllOverlappingPairs(btCollisionDispatcher* dispatcher)
+{
+	for (int i = 0; i < m_overlappingPairArray.size(); i++)
+	{
+		btBroadphasePair& pair = m_overlappingPairArray[i];
+		cleanOverlappingPair(pair, dispatcher);
+
+		if (m_ghostPairCallback)
+			m_ghostPairCallback->removeOverlappingPair(pair.m_pProxy0, pair.m_pProxy1, dispatcher);
+	}
+	m_overlappingPairArray.resize(0);
+
+	// m_next is rewritten as pairs are added, so only the hash table needs clearing
+	for (int i = 0; i < m_hashTable.size(); i++)
+		m_hashTable[i] = BT_NULL_PAIR;
+}
+
 void* btHashedOverlappingPairCache::removeOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1, btCollisionDispatcher* dispatcher)
 {
 	if (proxy0->m_uniqueId > proxy1->m_uniqueId)
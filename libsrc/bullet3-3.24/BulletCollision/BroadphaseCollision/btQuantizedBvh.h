@@ -429,6 +429,31 @@ public:
 		return m_useQuantization;
 	}
 
+	// ROCKETSIM CHANGE: Access to the quantization values and node count of a built tree, so it can be stored
+	const btVector3& getBvhAabbMin() const { return m_bvhAabbMin; }
+	const btVector3& getBvhAabbMax() const { return m_bvhAabbMax; }
+	const btVector3& getBvhQuantization() const { return m_bvhQuantization; }
+	int getNumUsedNodes() const { return m_curNodeIndex; }
+
+	// ROCKETSIM CHANGE: Use a stored quantized tree in place, instead of building one
+	// The nodes and subtree headers are not copied or freed, and must outlive this BVH
+	void initializeQuantizedFromBuffers(const btVector3& bvhAabbMin, const btVector3& bvhAabbMax, const btVector3& bvhQuantization,
+		btQuantizedBvhNode* nodes, int numNodes, btBvhSubtreeInfo* subtreeHeaders, int numSubtreeHeaders)
+	{
+		m_bvhAabbMin = bvhAabbMin;
+		m_bvhAabbMax = bvhAabbMax;
+		m_bvhQuantization = bvhQuantization;
+		m_useQuantization = true;
+		m_curNodeIndex = numNodes;
+
+		m_leafNodes.clear();
+		m_contiguousNodes.clear();
+		m_quantizedLeafNodes.clear();
+		m_quantizedContiguousNodes.initializeFromBuffer(nodes, numNodes, numNodes);
+		m_SubtreeHeaders.initializeFromBuffer(subtreeHeaders, numSubtreeHeaders, numSubtreeHeaders);
+		m_subtreeHeaderCount = numSubtreeHeaders;
+	}
+
 private:
 	// Special "copy" constructor that allows for in-place deserialization
 	// Prevents btVector3's default constructor from being called, but doesn't inialize much else
@@ -25,10 +25,10 @@ subject to the following restrictions:
 #include "../CollisionShapes/btBvhTriangleMeshShape.h"
 
 #include <new>
+#include <algorithm>
 #include <string>
 #include <stdexcept>
 #include <iostream>
-#include <mutex>
 
 #define THROW_ERR(msg) { std::string fullMsg = std::string() + "btRSBroadphase fatal error: " msg; std::cout << msg << std::endl; throw std::runtime_error(fullMsg); }
 
@@ -40,31 +40,7 @@ void btRSBroadphase::validate() {
 	}
 }
 
-btRSBroadphase::btRSBroadphase(btVector3 min, btVector3 max, float cellSize, btOverlappingPairCache* overlappingPairCache, int maxProxies)
-	: m_pairCache(overlappingPairCache),
-	m_ownsPairCache(false),
-	m_invalidPair(0) {
-
-	if (!overlappingPairCache)
-		THROW_ERR("overlappingPairCache is NULL");
-
-	// allocate handles buffer and put all handles on free list
-	m_pHandlesRawPtr = btAlignedAlloc(sizeof(btRSBroadphaseProxy) * maxProxies, 16);
-	m_pHandles = new (m_pHandlesRawPtr) btRSBroadphaseProxy[maxProxies];
-	m_maxHandles = maxProxies;
-	m_numHandles = 0;
-	m_firstFreeHandle = 0;
-	m_LastHandleIndex = -1;
-
-	{
-		for (int i = m_firstFreeHandle; i < maxProxies; i++) {
-			m_pHandles[i].SetNextFree(i + 1);
-			m_pHandles[i].m_uniqueId = i + 2;  //any UID will do, we just avoid too trivial values (0,1) for debugging purposes
-		}
-		m_pHandles[maxProxies - 1].SetNextFree(0);
-	}
-
-	// Build grid
+btRSBroadphaseGrid::btRSBroadphaseGrid(btVector3 min, btVector3 max, float cellSize) {
 	minPos = min;
 	maxPos = max;
 	if (!(minPos < maxPos))
@@ -79,31 +55,37 @@ btRSBroadphase::btRSBroadphase(btVector3 min, btVector3 max, float cellSize, btO
 	cellsY = btMax(1, (int)ceil(range.y() / cellSize));
 	cellsZ = btMax(1, (int)ceil(range.z() / cellSize));
 	totalCells = cellsX * cellsY * cellsZ;
-
-	cells = std::vector<Cell>(totalCells);
 }
 
-btRSBroadphase::~btRSBroadphase() {
-	btAlignedFree(m_pHandlesRawPtr);
+// Allocates a handles buffer of maxProxies and puts all handles on the free list, with unique IDs starting from firstUniqueId
+static btRSBroadphaseProxy* _AllocHandles(int maxProxies, int firstUniqueId, void*& rawPtrOut) {
+	rawPtrOut = btAlignedAlloc(sizeof(btRSBroadphaseProxy) * maxProxies, 16);
+	btRSBroadphaseProxy* handles = new (rawPtrOut) btRSBroadphaseProxy[maxProxies];
 
-	if (m_ownsPairCache) {
-		m_pairCache->~btOverlappingPairCache();
-		btAlignedFree(m_pairCache);
+	for (int i = 0; i < maxProxies; i++) {
+		handles[i].SetNextFree(i + 1);
+		handles[i].m_uniqueId = i + firstUniqueId;
 	}
+	if (maxProxies > 0)
+		handles[maxProxies - 1].SetNextFree(0);
+
+	return handles;
 }
 
-template <bool ADD>
-void _UpdateCellsStatic(btRSBroadphase* _this, btRSBroadphaseProxy* proxy) {
+// Calls fn(cellIdx) for every cell that a static proxy should be listed in (in no particular order, and possibly more than once)
+// If skipEmptyCells is set, cells with no triangles of a triangle mesh proxy are skipped
+template <typename FN>
+void _ForEachStaticProxyCell(const btRSBroadphaseGrid& grid, btRSBroadphaseProxy* proxy, bool skipEmptyCells, FN fn) {
 
 	// Fix dumb massive value aabb bug
 	btVector3 aabbMax = proxy->m_aabbMax;
 	for (int i = 0; i < 3; i++)
-		aabbMax[i] = btMin(aabbMax[i], _this->maxPos[i]);
+		aabbMax[i] = btMin(aabbMax[i], grid.maxPos[i]);
 
 	int iMin, jMin, kMin;
 	int iMax, jMax, kMax;
-	_this->GetCellIndices(proxy->m_aabbMin, iMin, jMin, kMin);
-	_this->GetCellIndices(aabbMax, iMax, jMax, kMax);
+	grid.GetCellIndices(proxy->m_aabbMin, iMin, jMin, kMin);
+	grid.GetCellIndices(aabbMax, iMax, jMax, kMax);
 
 	btCollisionObject* colObj = (btCollisionObject*)proxy->m_clientObject;
 
@@ -116,87 +98,217 @@ void _UpdateCellsStatic(btRSBroadphase* _this, btRSBroadphaseProxy* proxy) {
 		bool hit = false;
 
 		BoolHitTriangleCallback() {}
-		virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex) {
+		virtual void processTriangle(btVector3* /*triangle*/, int /*partId*/, int /*triangleIndex*/) {
 			hit = true;
 		}
 	};
 	BoolHitTriangleCallback callbackInst = {};
 
-	int numSkipped = 0;
 	for (int i = iMin; i <= iMax; i++) {
 		for (int j = jMin; j <= jMax; j++) {
 			for (int k = kMin; k <= kMax; k++) {
-				std::vector<btRSBroadphase::Cell*> cells = {};
-				for (int i1 = -1; i1 <= 1; i1++) {
-					for (int j1 = -1; j1 <= 1; j1++) {
-						for (int k1 = -1; k1 <= 1; k1++) {
-							int ci = i + i1;
-							int cj = j + j1;
-							int ck = k + k1;
-							if (ci < 0 || cj < 0 || ck < 0)
-								continue;
-							if (ci >= _this->cellsX || cj >= _this->cellsY || ck >= _this->cellsZ)
-								continue;
-							cells.push_back(&_this->GetCell(ci, cj, ck));
-						}
-					}
-				}
-				
-				if (isTriMesh) {
+				if (isTriMesh && skipEmptyCells) {
 					auto triMeshShape = (btTriangleMeshShape*)colObj->m_collisionShape;
-					btVector3 cellMin = _this->GetCellMinPos(i, j, k);
-					btVector3 cellMax = cellMin + btVector3(_this->cellSize, _this->cellSize, _this->cellSize);
+					btVector3 cellMin = grid.GetCellMinPos(i, j, k);
+					btVector3 cellMax = cellMin + btVector3(grid.cellSize, grid.cellSize, grid.cellSize);
 
 					callbackInst.hit = false;
 					triMeshShape->processAllTriangles(&callbackInst, cellMin, cellMax);
 
-					if (!callbackInst.hit) {
-						numSkipped++;
-
-						if (ADD) {
-							continue; // No tris in this AABB, ignore
-						} else {
-							// Remove it anyway
-						}
-					}
+					if (!callbackInst.hit)
+						continue; // No tris in this AABB, ignore
 				}
 
-				for (auto cell : cells) {
-					if (ADD) {
-						bool alreadyExists = false;
-						for (auto staticHandle : cell->staticHandles) {
-							if (staticHandle == proxy) {
-								alreadyExists = true;
-								break;
-							}
-						}
-						if (!alreadyExists)
-							cell->staticHandles.push_back(proxy);
-					} else {
-						cell->RemoveStatic(proxy);
-					}
-				}
+				for (int ci = btMax(0, i - 1); ci <= btMin(grid.cellsX - 1, i + 1); ci++)
+					for (int cj = btMax(0, j - 1); cj <= btMin(grid.cellsY - 1, j + 1); cj++)
+						for (int ck = btMax(0, k - 1); ck <= btMin(grid.cellsZ - 1, k + 1); ck++)
+							fn(grid.GetCellIdx(ci, cj, ck));
 			}
 		}
 	}
 }
 
-template <bool ADD>
-void _UpdateCellsDynamic(btRSBroadphase* _this, btRSBroadphaseProxy* proxy, int ci, int cj, int ck) {
+btRSBroadphaseStatics::btRSBroadphaseStatics(btVector3 min, btVector3 max, float cellSize, int maxProxies)
+	: btRSBroadphaseGrid(min, max, cellSize) {
 
-	int mni = btMax(0, ci - 1), mnj = btMax(0, cj - 1), mnk = btMax(0, ck - 1);
-	int mxi = btMin(_this->cellsX - 1, ci + 1), mxj = btMin(_this->cellsY - 1, cj + 1), mxk = btMin(_this->cellsZ - 1, ck + 1);
+	m_pHandles = _AllocHandles(maxProxies, 2, m_pHandlesRawPtr);
+	m_maxHandles = maxProxies;
+	m_numHandles = 0;
+}
 
-	for (int ci = mni; ci <= mxi; ci++) {
-		for (int cj = mnj; cj <= mxj; cj++) {
-			for (int ck = mnk; ck <= mxk; ck++) {
-				auto& cell = _this->GetCell(ci, cj, ck);
-				if (ADD) {
-					cell.dynHandles.push_back(proxy);
-				} else {
-					cell.RemoveDyn(proxy);
-				}
-			}
+btRSBroadphaseStatics::~btRSBroadphaseStatics() {
+	btAlignedFree(m_pHandlesRawPtr);
+}
+
+btRSBroadphaseProxy* btRSBroadphaseStatics::createProxy(const btVector3& aabbMin, const btVector3& aabbMax, int shapeType, void* userPtr, int collisionFilterGroup, int collisionFilterMask) {
+	if (m_numHandles >= m_maxHandles)
+		THROW_ERR("Too many static proxies");
+
+	if (cellLists.isBuilt())
+		THROW_ERR("Cannot create static proxies after build()");
+
+	int iIdx, jIdx, kIdx;
+	GetCellIndices(aabbMin, iIdx, jIdx, kIdx);
+
+	return new (&m_pHandles[m_numHandles++]) btRSBroadphaseProxy(
+		aabbMin, aabbMax, shapeType, userPtr, collisionFilterGroup, collisionFilterMask,
+		true,
+		GetCellIdx(iIdx, jIdx, kIdx), iIdx, jIdx, kIdx
+	);
+}
+
+void btRSBroadphaseCellLists::build(int totalCells, const std::vector<std::pair<int, btRSBroadphaseProxy*>>& entries) {
+	// Counting sort by cell, which keeps the order of entries within each cell
+	starts.assign(totalCells + 1, 0);
+	for (auto& entry : entries)
+		starts[entry.first + 1]++;
+	for (int i = 0; i < totalCells; i++)
+		starts[i + 1] += starts[i];
+
+	handles.resize(entries.size());
+	std::vector<int> nextIdx(starts.begin(), starts.end() - 1);
+	for (auto& entry : entries)
+		handles[nextIdx[entry.first]++] = entry.second;
+}
+
+// Returns every cell that a static proxy should be listed in, sorted and without duplicates
+static std::vector<int> _GetStaticProxyCells(const btRSBroadphaseGrid& grid, btRSBroadphaseProxy* proxy) {
+	std::vector<int> cellIdxs;
+	_ForEachStaticProxyCell(grid, proxy, true,
+		[&](int cellIdx) {
+			cellIdxs.push_back(cellIdx);
+		}
+	);
+	std::sort(cellIdxs.begin(), cellIdxs.end());
+	cellIdxs.erase(std::unique(cellIdxs.begin(), cellIdxs.end()), cellIdxs.end());
+	return cellIdxs;
+}
+
+void btRSBroadphaseStatics::build() {
+	std::vector<std::pair<int, btRSBroadphaseProxy*>> entries;
+	for (int i = 0; i < m_numHandles; i++) {
+		btRSBroadphaseProxy* proxy = &m_pHandles[i];
+		for (int cellIdx : _GetStaticProxyCells(*this, proxy))
+			entries.push_back({ cellIdx, proxy });
+	}
+
+	cellLists.build(totalCells, entries);
+}
+
+btRSBroadphase::btRSBroadphase(btVector3 min, btVector3 max, float cellSize, btOverlappingPairCache* overlappingPairCache, int maxProxies)
+	: btRSBroadphaseGrid(min, max, cellSize),
+	m_pairCache(dynamic_cast<btHashedOverlappingPairCache*>(overlappingPairCache)),
+	m_ownsPairCache(false),
+	m_invalidPair(0) {
+
+	if (!m_pairCache)
+		THROW_ERR("overlappingPairCache must be a btHashedOverlappingPairCache");
+
+	//any UID will do, we just avoid too trivial values (0,1) for debugging purposes
+	m_pHandles = _AllocHandles(maxProxies, 2, m_pHandlesRawPtr);
+	m_maxHandles = maxProxies;
+	m_numHandles = 0;
+	m_firstFreeHandle = 0;
+	m_LastHandleIndex = -1;
+
+	staticCellLists.build(totalCells, {});
+}
+
+btRSBroadphase::btRSBroadphase(const btRSBroadphaseStatics* sharedStatics, btOverlappingPairCache* overlappingPairCache, int maxProxies)
+	: btRSBroadphaseGrid(*sharedStatics),
+	sharedStatics(sharedStatics),
+	m_pairCache(dynamic_cast<btHashedOverlappingPairCache*>(overlappingPairCache)),
+	m_ownsPairCache(false),
+	m_invalidPair(0) {
+
+	if (!m_pairCache)
+		THROW_ERR("overlappingPairCache must be a btHashedOverlappingPairCache");
+
+	if (!sharedStatics->cellLists.isBuilt())
+		THROW_ERR("Shared statics have not been built");
+
+	// Our unique IDs continue after the shared statics, so pairs are ordered the same as if the statics were our own
+	m_pHandles = _AllocHandles(maxProxies, sharedStatics->m_numHandles + 2, m_pHandlesRawPtr);
+	m_maxHandles = maxProxies;
+	m_numHandles = 0;
+	m_firstFreeHandle = 0;
+	m_LastHandleIndex = -1;
+}
+
+btRSBroadphase::~btRSBroadphase() {
+	btAlignedFree(m_pHandlesRawPtr);
+
+	if (m_ownsPairCache) {
+		m_pairCache->~btOverlappingPairCache();
+		btAlignedFree(m_pairCache);
+	}
+}
+
+// Lists a static proxy of our own after all the others
+void _AddStaticProxy(btRSBroadphase* _this, btRSBroadphaseProxy* proxy) {
+	for (int cellIdx : _GetStaticProxyCells(*_this, proxy))
+		_this->pendingStaticEntries.push_back({ cellIdx, proxy });
+}
+
+void _RemoveStaticProxy(btRSBroadphase* _this, btRSBroadphaseProxy* proxy) {
+	auto& pendingEntries = _this->pendingStaticEntries;
+	pendingEntries.erase(
+		std::remove_if(pendingEntries.begin(), pendingEntries.end(), [proxy](auto& entry) { return entry.second == proxy; }),
+		pendingEntries.end()
+	);
+
+	_this->pendingStaticRemovals.push_back(proxy);
+}
+
+void btRSBroadphase::updateStaticCells() {
+	if (pendingStaticEntries.empty() && pendingStaticRemovals.empty())
+		return;
+
+	// Keep the current lists (minus removed proxies), and add the new entries after them
+	std::vector<std::pair<int, btRSBroadphaseProxy*>> entries;
+	entries.reserve(staticCellLists.handles.size() + pendingStaticEntries.size());
+	for (int cellIdx = 0; cellIdx < totalCells; cellIdx++) {
+		btRSBroadphaseProxy* const* statics;
+		int numStatics;
+		staticCellLists.get(cellIdx, statics, numStatics);
+		for (int s = 0; s < numStatics; s++) {
+			bool removed = false;
+			for (auto removedProxy : pendingStaticRemovals)
+				removed |= (statics[s] == removedProxy);
+
+			if (!removed)
+				entries.push_back({ cellIdx, statics[s] });
+		}
+	}
+	entries.insert(entries.end(), pendingStaticEntries.begin(), pendingStaticEntries.end());
+
+	staticCellLists.build(totalCells, entries);
+	staticCellLists.handles.shrink_to_fit();
+
+	// Free the queues, they can be quite big after adding the arena's statics
+	std::vector<std::pair<int, btRSBroadphaseProxy*>>().swap(pendingStaticEntries);
+	std::vector<btRSBroadphaseProxy*>().swap(pendingStaticRemovals);
+}
+
+void btRSBroadphase::beginStaticVisits() {
+	size_t numStaticHandles = sharedStatics ? sharedStatics->m_numHandles : m_maxHandles;
+	if (staticVisitStamps.size() != numStaticHandles)
+		staticVisitStamps.assign(numStaticHandles, 0);
+
+	curStaticVisitStamp++;
+	if (curStaticVisitStamp == 0) {
+		// Wrapped around, old stamps could now match
+		std::fill(staticVisitStamps.begin(), staticVisitStamps.end(), 0);
+		curStaticVisitStamp = 1;
+	}
+}
+
+void _RemoveDynProxy(btRSBroadphase* _this, btRSBroadphaseProxy* proxy) {
+	auto& dynProxies = _this->dynProxies;
+	for (size_t i = 0; i < dynProxies.size(); i++) {
+		if (dynProxies[i] == proxy) {
+			dynProxies.erase(dynProxies.begin() + i);
+			return;
 		}
 	}
 }
@@ -223,14 +335,17 @@ btBroadphaseProxy* btRSBroadphase::createProxy(const btVector3& aabbMin, const b
 	);
 
 	if (isStatic) {
-		_UpdateCellsStatic<true>(this, proxy);
+		if (sharedStatics)
+			THROW_ERR("Cannot add static proxies to a broadphase with shared statics");
+
+		_AddStaticProxy(this, proxy);
 
 	} else {
 		if (aabbMin.distance2(aabbMax) > cellSizeSq)
 			THROW_ERR("Object AABB size exceeds maximum cell size (" + std::to_string(aabbMin.distance(aabbMax)) + " > " + std::to_string(cellSize) + ")");
 
-		_UpdateCellsDynamic<true>(this, proxy, iIdx, jIdx, kIdx);
-		numDynProxies++;
+		dynProxies.push_back(proxy);
+		dynProxiesByHandle.insert(std::lower_bound(dynProxiesByHandle.begin(), dynProxiesByHandle.end(), proxy), proxy);
 	}
 
 	return proxy;
@@ -268,10 +383,10 @@ void btRSBroadphase::destroyProxy(btBroadphaseProxy* proxyOrg, btCollisionDispat
 	m_pairCache->removeOverlappingPairsContainingProxy(proxyOrg, dispatcher);
 	
 	if (sbp->isStatic) {
-		_UpdateCellsStatic<false>(this, sbp);
+		_RemoveStaticProxy(this, sbp);
 	} else {
-		_UpdateCellsDynamic<false>(this, sbp, sbp->iIdx, sbp->jIdx, sbp->kIdx);
-		numDynProxies--;
+		_RemoveDynProxy(this, sbp);
+		dynProxiesByHandle.erase(std::lower_bound(dynProxiesByHandle.begin(), dynProxiesByHandle.end(), sbp));
 	}
 
 	btRSBroadphaseProxy* proxy0 = static_cast<btRSBroadphaseProxy*>(proxyOrg);
@@ -289,12 +404,12 @@ void btRSBroadphase::setAabb(btBroadphaseProxy* proxy, const btVector3& aabbMin,
 	
 	if (sbp->m_aabbMin != aabbMin || sbp->m_aabbMax != aabbMax) {
 		if (sbp->isStatic) {
-			_UpdateCellsStatic<false>(this, sbp);
+			_RemoveStaticProxy(this, sbp);
 
 			sbp->m_aabbMin = aabbMin;
 			sbp->m_aabbMax = aabbMax;
 
-			_UpdateCellsStatic<true>(this, sbp);
+			_AddStaticProxy(this, sbp);
 		} else {
 
 			int oldIndex = sbp->cellIdx;
@@ -306,69 +421,164 @@ void btRSBroadphase::setAabb(btBroadphaseProxy* proxy, const btVector3& aabbMin,
 
 			if (oldIndex != newIndex) {
 
-				if (numDynProxies > 1) {
-					_UpdateCellsDynamic<false>(this, sbp, sbp->iIdx, sbp->jIdx, sbp->kIdx);
-
-					// TODO: Can determine newIndex from these
-					int iNew, jNew, kNew;
-					GetCellIndices(aabbMin, iNew, jNew, kNew);
-					sbp->iIdx = iNew;
-					sbp->jIdx = jNew;
-					sbp->kIdx = kNew;
-
-					_UpdateCellsDynamic<true>(this, sbp, iNew, jNew, kNew);
+				// NOTE: With only one dynamic proxy, it stays listed around its old cell
+				if (dynProxies.size() > 1) {
+					// Re-list it around its new cell, which puts it last in the order of every cell it's near
+					_RemoveDynProxy(this, sbp);
+					GetCellIndicesFromIdx(newIndex, sbp->iIdx, sbp->jIdx, sbp->kIdx);
+					dynProxies.push_back(sbp);
 				}
 			}
 		}
 	}
 }
 
+// Returns true if the ray (swept by aabbMin/aabbMax, if it is a shape cast) can hit the proxy's AABB
+static bool _RayHitsProxyAabb(const btVector3& rayFrom, const btBroadphaseRayCallback& rayCallback, const btVector3& aabbMin, const btVector3& aabbMax, const btRSBroadphaseProxy* proxy) {
+	btVector3 bounds[2] = {
+		proxy->m_aabbMin - aabbMax,
+		proxy->m_aabbMax - aabbMin
+	};
+	btScalar tmin = 1;
+	return btRayAabb2(rayFrom, rayCallback.m_rayDirectionInverse, rayCallback.m_signs, bounds, tmin, 0, rayCallback.m_lambda_max);
+}
+
 void btRSBroadphase::rayTest(const btVector3& rayFrom, const btVector3& rayTo, btBroadphaseRayCallback& rayCallback, const btVector3& aabbMin, const btVector3& aabbMax) {
+	updateStaticCells();
+
 	float rayLenSq = rayFrom.distance2(rayTo);
 
 	if (rayLenSq < cellSizeSq) {
-
-		Cell& cell = cells[GetCellIdx(rayFrom)];
-		for (auto& otherProxy : cell.staticHandles)
-			if (otherProxy->m_clientObject)
-				rayCallback.process(otherProxy);
-		for (auto& otherProxy : cell.dynHandles)
-			if (otherProxy->m_clientObject)
+		int i, j, k;
+		GetCellIndices(rayFrom, i, j, k);
+
+		btRSBroadphaseProxy* const* statics;
+		int numStatics;
+		getCellStatics(GetCellIdx(i, j, k), statics, numStatics);
+		for (int s = 0; s < numStatics; s++)
+			if (statics[s]->m_clientObject && _RayHitsProxyAabb(rayFrom, rayCallback, aabbMin, aabbMax, statics[s]))
+				rayCallback.process(statics[s]);
+
+		for (auto& otherProxy : dynProxies)
+			if (otherProxy->m_clientObject && isDynProxyNearCell(otherProxy, i, j, k))
 				rayCallback.process(otherProxy);
-	} else {
-		static std::once_flag onceFlag;
-		std::call_once(onceFlag, 
-			[this]() {
-				std::cout <<
-					"[!] btRSBroadphase WARNING:" <<
-					"\nRay casts in RocketSim that are longer than " << this->cellSize << "uu are very expensive and not properly optimized." <<
-					"\nIf you have a project that requires these long rays, tell ZealanL to implement proper DDA for the custom voxel broadphase." <<
-					std::endl;
+		return;
+	}
+
+	// Statics are listed in every cell within one cell of them, so walking the cells along the ray finds all statics it can hit
+	// That only holds if the ray stays in the grid, and the shape being cast (if any) is no bigger than a cell
+	bool canWalkCells = true;
+	for (int i = 0; i < 3; i++) {
+		if (rayFrom[i] < minPos[i] || rayFrom[i] > maxPos[i] || rayTo[i] < minPos[i] || rayTo[i] > maxPos[i])
+			canWalkCells = false;
+		if (-aabbMin[i] > cellSize || aabbMax[i] > cellSize)
+			canWalkCells = false;
+	}
+
+	if (canWalkCells) {
+		beginStaticVisits();
+
+		// 3D-DDA through the grid (Amanatides & Woo), with t going from 0 at rayFrom to 1 at rayTo
+		btVector3 rayDelta = rayTo - rayFrom;
+		int idx[3], endIdx[3], step[3];
+		float tMax[3], tDelta[3];
+		GetCellIndices(rayFrom, idx[0], idx[1], idx[2]);
+		GetCellIndices(rayTo, endIdx[0], endIdx[1], endIdx[2]);
+		btVector3 startCellMin = GetCellMinPos(idx[0], idx[1], idx[2]);
+		for (int i = 0; i < 3; i++) {
+			if (rayDelta[i] > 0) {
+				step[i] = 1;
+				tDelta[i] = cellSize / rayDelta[i];
+				tMax[i] = (startCellMin[i] + cellSize - rayFrom[i]) / rayDelta[i];
+			} else if (rayDelta[i] < 0) {
+				step[i] = -1;
+				tDelta[i] = -cellSize / rayDelta[i];
+				tMax[i] = (startCellMin[i] - rayFrom[i]) / rayDelta[i];
+			} else {
+				step[i] = 0;
+				tDelta[i] = tMax[i] = BT_LARGE_FLOAT;
+			}
+		}
+
+		int cellLimits[3] = { cellsX, cellsY, cellsZ };
+		int maxSteps = cellsX + cellsY + cellsZ;
+		for (int n = 0; n <= maxSteps; n++) {
+			btRSBroadphaseProxy* const* statics;
+			int numStatics;
+			getCellStatics(GetCellIdx(idx[0], idx[1], idx[2]), statics, numStatics);
+			for (int s = 0; s < numStatics; s++) {
+				btRSBroadphaseProxy* proxy = statics[s];
+				if (!proxy->m_clientObject || !markStaticVisited(proxy))
+					continue;
+
+				if (_RayHitsProxyAabb(rayFrom, rayCallback, aabbMin, aabbMax, proxy))
+					if (!rayCallback.process(proxy))
+						return; // Can't get any closer
 			}
-		);
+
+			if (idx[0] == endIdx[0] && idx[1] == endIdx[1] && idx[2] == endIdx[2])
+				break;
+
+			int axis = (tMax[0] < tMax[1]) ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+			if (tMax[axis] > 1)
+				break;
+
+			idx[axis] += step[axis];
+			if (idx[axis] < 0 || idx[axis] >= cellLimits[axis])
+				break;
+			tMax[axis] += tDelta[axis];
+		}
+	} else {
+		const btRSBroadphaseProxy* statics = sharedStatics ? sharedStatics->m_pHandles : NULL;
+		int numSharedStatics = sharedStatics ? sharedStatics->m_numHandles : 0;
+		for (int i = 0; i < numSharedStatics; i++) {
+			const btRSBroadphaseProxy* proxy = &statics[i];
+			if (proxy->m_clientObject && _RayHitsProxyAabb(rayFrom, rayCallback, aabbMin, aabbMax, proxy))
+				rayCallback.process(proxy);
+		}
 
 		for (int i = 0; i <= m_LastHandleIndex; i++) {
 			btRSBroadphaseProxy* proxy = &m_pHandles[i];
-			if (!proxy->m_clientObject) {
-				continue;
-			}
-			rayCallback.process(proxy);
+			if (proxy->isStatic && proxy->m_clientObject && _RayHitsProxyAabb(rayFrom, rayCallback, aabbMin, aabbMax, proxy))
+				rayCallback.process(proxy);
 		}
 	}
+
+	for (auto& otherProxy : dynProxies)
+		if (otherProxy->m_clientObject && _RayHitsProxyAabb(rayFrom, rayCallback, aabbMin, aabbMax, otherProxy))
+			rayCallback.process(otherProxy);
 }
 
 void btRSBroadphase::aabbTest(const btVector3& aabbMin, const btVector3& aabbMax, btBroadphaseAabbCallback& callback) {
-	// TODO: Optimize
-
-	for (int i = 0; i <= m_LastHandleIndex; i++) {
-		btRSBroadphaseProxy* proxy = &m_pHandles[i];
-		if (!proxy->m_clientObject)
-			continue;
-		
-		if (TestAabbAgainstAabb2(aabbMin, aabbMax, proxy->m_aabbMin, proxy->m_aabbMax)) {
-			callback.process(proxy);
+	updateStaticCells();
+	beginStaticVisits();
+
+	// Statics are listed in every cell within one cell of them, so the cells the AABB covers are enough
+	// NOTE: Triangle mesh statics are only reported if they have triangles near the AABB
+	int iMin, jMin, kMin, iMax, jMax, kMax;
+	GetCellIndices(aabbMin, iMin, jMin, kMin);
+	GetCellIndices(aabbMax, iMax, jMax, kMax);
+	for (int i = iMin; i <= iMax; i++) {
+		for (int j = jMin; j <= jMax; j++) {
+			for (int k = kMin; k <= kMax; k++) {
+				btRSBroadphaseProxy* const* statics;
+				int numStatics;
+				getCellStatics(GetCellIdx(i, j, k), statics, numStatics);
+				for (int s = 0; s < numStatics; s++) {
+					btRSBroadphaseProxy* proxy = statics[s];
+					if (!proxy->m_clientObject || !markStaticVisited(proxy))
+						continue;
+
+					if (TestAabbAgainstAabb2(aabbMin, aabbMax, proxy->m_aabbMin, proxy->m_aabbMax))
+						callback.process(proxy);
+				}
+			}
 		}
 	}
+
+	for (auto& otherProxy : dynProxies)
+		if (otherProxy->m_clientObject && TestAabbAgainstAabb2(aabbMin, aabbMax, otherProxy->m_aabbMin, otherProxy->m_aabbMax))
+			callback.process(otherProxy);
 }
 
 bool btRSBroadphase::aabbOverlap(btRSBroadphaseProxy* proxy0, btRSBroadphaseProxy* proxy1) {
@@ -391,80 +601,67 @@ std::string ToStr(const btVector3& vec) {
 }
 
 void btRSBroadphase::calculateOverlappingPairs(btCollisionDispatcher* dispatcher) {
+	updateStaticCells();
 
-	int lastRealPairs = totalRealPairs;
+	m_pairCache->removeAllOverlappingPairs(dispatcher);
 
-	bool shouldRemove = !m_pairCache->hasDeferredRemoval();
+	// Adds the pair if it isn't already added, with only one lookup
+	auto fnAddPair = [this](btRSBroadphaseProxy* proxy, btRSBroadphaseProxy* otherProxy) {
+		int prevNumPairs = m_pairCache->getNumOverlappingPairs();
+		m_pairCache->addOverlappingPair(proxy, otherProxy);
+		if (m_pairCache->getNumOverlappingPairs() > prevNumPairs)
+			totalRealPairs++;
+	};
 
-	if (shouldRemove) {
-		for (auto pair : activePairs) {
-			m_pairCache->removeOverlappingPair(pair.first, pair.second, dispatcher);
-		}
-		activePairs.clear();
-	} else {
-		THROW_ERR("Pair cache cannot have deferred removal");
-	}
+	for (btRSBroadphaseProxy* proxy : dynProxiesByHandle) {
+		if (!proxy->m_clientObject)
+			continue;
 
-	if (m_numHandles >= 0) {
+		totalItrs++;
 
-		int new_largest_index = -1;
-		for (int i = 0; i <= m_LastHandleIndex; i++) {
-			btRSBroadphaseProxy* proxy = &m_pHandles[i];
-			if (proxy->isStatic)
-				continue; // TODO: Use separate list
+		btRSBroadphaseProxy* const* statics;
+		int numStatics;
+		getCellStatics(proxy->cellIdx, statics, numStatics);
 
-			if (!proxy->m_clientObject)
+		for (int s = 0; s < numStatics; s++) {
+			btRSBroadphaseProxy* otherProxy = statics[s];
+			if (!otherProxy->m_clientObject)
 				continue;
-			
-			totalItrs++;
 
-			new_largest_index = i;
+			totalStaticPairs++;
 
-			Cell& cell = cells[proxy->cellIdx];
-			
-			for (auto& otherProxy : cell.staticHandles) {
-				if (!otherProxy->m_clientObject)
-					continue;
+			if (aabbOverlap(proxy, otherProxy))
+				fnAddPair(proxy, otherProxy);
+		}
 
-				totalStaticPairs++;
+		if (dynProxies.size() > 1) {
+			int ci, cj, ck;
+			GetCellIndicesFromIdx(proxy->cellIdx, ci, cj, ck);
 
-				
-				if (aabbOverlap(proxy, otherProxy)) {
-					if (!m_pairCache->findPair(proxy, otherProxy)) {
-						m_pairCache->addOverlappingPair(proxy, otherProxy);
-						activePairs.push_back({ proxy, otherProxy });
-						totalRealPairs++;
-					}
-				}
-			}
+			// We might not be listed near our own cell (see setAabb()), so check that there is more than 1 proxy near it
+			int numNearCell = 0;
+			for (auto& otherProxy : dynProxies)
+				if (isDynProxyNearCell(otherProxy, ci, cj, ck))
+					numNearCell++;
+
+			if (numNearCell > 1) {
+				for (auto& otherProxy : dynProxies) {
+					if (otherProxy == proxy)
+						continue;
 
-			if (numDynProxies > 1) {
-				if (cell.dynHandles.size() > 1) { // We are dynamic, so there will always be 1
-					for (auto& otherProxy : cell.dynHandles) {
-						if (otherProxy == proxy)
-							continue;
-
-						if (!otherProxy->m_clientObject)
-							continue;
-
-						totalDynPairs++;
-
-						if (aabbOverlap(proxy, otherProxy)) {
-							if (!m_pairCache->findPair(proxy, otherProxy)) {
-								m_pairCache->addOverlappingPair(proxy, otherProxy);
-								activePairs.push_back({ proxy, otherProxy });
-								totalRealPairs++;
-							}
-						}
-					}
+					if (!isDynProxyNearCell(otherProxy, ci, cj, ck))
+						continue;
+
+					if (!otherProxy->m_clientObject)
+						continue;
+
+					totalDynPairs++;
+
+					if (aabbOverlap(proxy, otherProxy))
+						fnAddPair(proxy, otherProxy);
 				}
 			}
 		}
-
-		m_LastHandleIndex = new_largest_index;
-
-		if (m_ownsPairCache)
-			THROW_ERR("Cannot own pair cache!");
 	}
 }
 
@@ -475,5 +672,19 @@ bool btRSBroadphase::testAabbOverlap(btBroadphaseProxy* proxy0, btBroadphaseProx
 }
 
 void btRSBroadphase::resetPool(btCollisionDispatcher* dispatcher) {
-	// TODO: ?
+	// Relink the free handles in ascending order, like a new broadphase has them
+	// New proxies then get the same handles (and unique IDs) as they would in a new broadphase with the same live proxies
+	int nextFree = 0;
+	m_LastHandleIndex = -1;
+	for (int i = m_maxHandles - 1; i >= 0; i--) {
+		btRSBroadphaseProxy& handle = m_pHandles[i];
+		if (handle.m_clientObject) {
+			if (m_LastHandleIndex < 0)
+				m_LastHandleIndex = i;
+		} else {
+			handle.SetNextFree(nextFree);
+			nextFree = i;
+		}
+	}
+	m_firstFreeHandle = nextFree;
 }
@@ -2,12 +2,15 @@
 
 #include "btOverlappingPairCache.h"
 #include <vector>
+#include <cstdlib>
 
 struct btRSBroadphaseProxy : public btBroadphaseProxy
 {
 	bool isStatic;
 
 	int cellIdx;
+
+	// Cell that a dynamic proxy is listed around, can lag behind cellIdx (see btRSBroadphase::setAabb())
 	int iIdx, jIdx, kIdx;
 
 	int shapeType;
@@ -30,61 +33,18 @@ struct btRSBroadphaseProxy : public btBroadphaseProxy
 	SIMD_FORCE_INLINE int GetNextFree() const { return m_nextFree; }
 };
 
-// Custom broadphase implementation for RocketSim
-// Uses spacial division with a fixed voxel grid
-// Somewhat based off of btSimpleBroadphase
-class btRSBroadphase : public btBroadphaseInterface
+// The fixed voxel grid of btRSBroadphase
+struct btRSBroadphaseGrid
 {
-public:
-	int m_numHandles;  // number of active handles
-	int m_maxHandles;  // max number of handles
-	int m_LastHandleIndex;
-
 	btVector3 minPos, maxPos;
 	float cellSize, cellSizeSq;
 	int cellsX, cellsY, cellsZ;
 	int totalCells;
 
-	int numDynProxies = 0;
-
-	int totalStaticPairs = 0, totalDynPairs = 0;
-	int totalRealPairs = 0;
-	int totalItrs = 0;
-
-	std::vector<std::pair<btRSBroadphaseProxy*, btRSBroadphaseProxy*>> activePairs;
-
-	struct Cell {
-		constexpr static int RESERVED_SIZE = 4;
-		std::vector<btRSBroadphaseProxy*> dynHandles;
-		std::vector<btRSBroadphaseProxy*> staticHandles;
-		Cell() {
-			dynHandles.reserve(RESERVED_SIZE);
-			staticHandles.reserve(RESERVED_SIZE);
-		}
-
-		void RemoveDyn(btRSBroadphaseProxy* proxy) {
-			for (int i = 0; i < dynHandles.size(); i++) {
-				if (dynHandles[i] == proxy) {
-					dynHandles.erase(dynHandles.begin() + i);
-					return;
-				}
-			}
-		}
+	btRSBroadphaseGrid(btVector3 min, btVector3 max, float cellSize);
 
-		void RemoveStatic(btRSBroadphaseProxy* proxy) {
-			for (int i = 0; i < staticHandles.size(); i++) {
-				if (staticHandles[i] == proxy) {
-					staticHandles.erase(staticHandles.begin() + i);
-					return;
-				}
-			}
-		}
-	};
-	std::vector<Cell> cells;
-
-	Cell& GetCell(int i, int j, int k) {
-		int idx = i * cellsY * cellsZ + j * cellsZ + k;
-		return cells[idx];
+	bool operator==(const btRSBroadphaseGrid& other) const {
+		return minPos == other.minPos && maxPos == other.maxPos && cellSize == other.cellSize;
 	}
 
 	void GetCellIndices(btVector3 pos, int& i, int& j, int& k) const {
@@ -97,14 +57,130 @@ public:
 		btClamp(k, 0, cellsZ - 1);
 	}
 
+	void GetCellIndicesFromIdx(int idx, int& i, int& j, int& k) const {
+		i = idx / (cellsY * cellsZ);
+		j = (idx / cellsZ) % cellsY;
+		k = idx % cellsZ;
+	}
+
 	btVector3 GetCellMinPos(int i, int j, int k) const {
 		return minPos + btVector3(i, j, k) * cellSize;
 	}
 
+	int GetCellIdx(int i, int j, int k) const {
+		return i * cellsY * cellsZ + j * cellsZ + k;
+	}
+
 	int GetCellIdx(const btVector3& pos) const {
 		int i, j, k;
 		GetCellIndices(pos, i, j, k);
-		return i * cellsY * cellsZ + j * cellsZ + k;
+		return GetCellIdx(i, j, k);
+	}
+};
+
+// Lists of the proxies near each cell, stored contiguously
+// The proxies near cell i are handles[starts[i]] to handles[starts[i + 1] - 1]
+struct btRSBroadphaseCellLists
+{
+	std::vector<int> starts;
+	std::vector<btRSBroadphaseProxy*> handles;
+
+	bool isBuilt() const {
+		return !starts.empty();
+	}
+
+	void get(int cellIdx, btRSBroadphaseProxy* const*& proxiesOut, int& numProxiesOut) const {
+		int start = starts[cellIdx];
+		proxiesOut = handles.data() + start;
+		numProxiesOut = starts[cellIdx + 1] - start;
+	}
+
+	// Builds the lists from (cell index, proxy) entries, keeping the order the entries of each cell are in
+	void build(int totalCells, const std::vector<std::pair<int, btRSBroadphaseProxy*>>& entries);
+};
+
+// Static proxies and the cells they are near, built once and then only read
+// Can be shared between any number of btRSBroadphases with the same grid, which then only store their own dynamic proxies
+class btRSBroadphaseStatics : public btRSBroadphaseGrid
+{
+public:
+	btRSBroadphaseProxy* m_pHandles;
+	void* m_pHandlesRawPtr;
+	int m_numHandles;
+	int m_maxHandles;
+
+	// The statics near each cell, in the order they were created
+	btRSBroadphaseCellLists cellLists;
+
+	btRSBroadphaseStatics(btVector3 min, btVector3 max, float cellSize, int maxProxies);
+	~btRSBroadphaseStatics();
+
+	btRSBroadphaseStatics(const btRSBroadphaseStatics& other) = delete;
+	btRSBroadphaseStatics& operator=(const btRSBroadphaseStatics& other) = delete;
+
+	// All proxies must be created before calling build()
+	btRSBroadphaseProxy* createProxy(const btVector3& aabbMin, const btVector3& aabbMax, int shapeType, void* userPtr, int collisionFilterGroup, int collisionFilterMask);
+	void build();
+};
+
+// Custom broadphase implementation for RocketSim
+// Uses spacial division with a fixed voxel grid
+// Somewhat based off of btSimpleBroadphase
+class btRSBroadphase : public btBroadphaseInterface, public btRSBroadphaseGrid
+{
+public:
+	int m_numHandles;  // number of active handles
+	int m_maxHandles;  // max number of handles
+	int m_LastHandleIndex;
+
+	int totalStaticPairs = 0, totalDynPairs = 0;
+	int totalRealPairs = 0;
+	int totalItrs = 0;
+
+	// Static proxies shared with other broadphases, if this broadphase was made with them
+	// These replace the per-cell static lists, so we then can't have static proxies of our own
+	const btRSBroadphaseStatics* sharedStatics = NULL;
+
+	// Our own statics near each cell, in the order they were listed (not used if we have sharedStatics)
+	// Changes are queued up and applied all at once by updateStaticCells(), as they require rebuilding the lists
+	btRSBroadphaseCellLists staticCellLists;
+	std::vector<std::pair<int, btRSBroadphaseProxy*>> pendingStaticEntries; // (cell index, proxy) to add
+	std::vector<btRSBroadphaseProxy*> pendingStaticRemovals;
+
+	void updateStaticCells();
+
+	// Dynamic proxies, in the order they were last listed around their cell
+	// A dynamic proxy is near every cell within one cell of (iIdx, jIdx, kIdx), so there is no need to store per-cell lists of them
+	std::vector<btRSBroadphaseProxy*> dynProxies;
+
+	// Dynamic proxies in handle order, which is the order pairs are found in
+	std::vector<btRSBroadphaseProxy*> dynProxiesByHandle;
+
+	static bool isDynProxyNearCell(const btRSBroadphaseProxy* proxy, int i, int j, int k) {
+		return abs(proxy->iIdx - i) <= 1 && abs(proxy->jIdx - j) <= 1 && abs(proxy->kIdx - k) <= 1;
+	}
+
+	// NOTE: updateStaticCells() must have been called since our static proxies last changed
+	void getCellStatics(int cellIdx, btRSBroadphaseProxy* const*& staticsOut, int& numStaticsOut) const {
+		const btRSBroadphaseCellLists& cellLists = sharedStatics ? sharedStatics->cellLists : staticCellLists;
+		cellLists.get(cellIdx, staticsOut, numStaticsOut);
+	}
+
+	// Visit stamps of static proxies, so queries that look at several cells only process each static once
+	std::vector<unsigned int> staticVisitStamps;
+	unsigned int curStaticVisitStamp = 0;
+
+	// Starts a new query, after which each static is only reported once by markStaticVisited()
+	void beginStaticVisits();
+
+	// Returns false if this static proxy was already visited since beginStaticVisits()
+	bool markStaticVisited(const btRSBroadphaseProxy* proxy) {
+		const btRSBroadphaseProxy* handles = sharedStatics ? sharedStatics->m_pHandles : m_pHandles;
+		unsigned int& stamp = staticVisitStamps[proxy - handles];
+		if (stamp == curStaticVisitStamp)
+			return false;
+		stamp = curStaticVisitStamp;
+		return true;
 	}
 
 	btRSBroadphaseProxy* m_pHandles;  // handles pool
@@ -137,7 +213,9 @@ public:
 		m_numHandles--;
 	}
 
-	btOverlappingPairCache* m_pairCache;
+	// Pairs are not kept across ticks: every pair is removed at the start of calculateOverlappingPairs() and re-added in handle order
+	// Keeping them would keep their contact manifolds across ticks, and make the pair order depend on earlier ticks
+	btHashedOverlappingPairCache* m_pairCache;
 	bool m_ownsPairCache;
 
 	int m_invalidPair;
@@ -160,6 +238,9 @@ public:
 protected:
 public:
 	btRSBroadphase(btVector3 min, btVector3 max, float cellSize, btOverlappingPairCache* overlappingPairCache, int maxProxies = 65536);
+
+	// Uses the grid and static proxies of sharedStatics, which must outlive this broadphase
+	btRSBroadphase(const btRSBroadphaseStatics* sharedStatics, btOverlappingPairCache* overlappingPairCache, int maxProxies = 65536);
 	virtual ~btRSBroadphase();
 
 	static bool aabbOverlap(btRSBroadphaseProxy* proxy0, btRSBroadphaseProxy* proxy1);
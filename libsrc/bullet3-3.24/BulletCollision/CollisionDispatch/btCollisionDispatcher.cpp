@@ -252,6 +252,7 @@ void btCollisionDispatcher::defaultNearCallback(btBroadphasePair& collisionPair,
 		if (collisionPair.m_algorithm)
 		{
 			btManifoldResult contactPointResult(&obj0Wrap, &obj1Wrap);
+			contactPointResult.setContactAddedCallback(dispatcher.getContactAddedCallback(), dispatcher.getContactAddedUserInfo()); // ROCKETSIM CHANGE: Use the dispatcher's contact added callback
 
 			if (dispatchInfo.m_dispatchFunc == btDispatcherInfo::DISPATCH_DISCRETE)
 			{
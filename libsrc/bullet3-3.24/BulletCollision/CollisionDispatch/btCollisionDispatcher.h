@@ -57,6 +57,10 @@ protected:
 
 	btCollisionConfiguration* m_collisionConfiguration;
 
+	// ROCKETSIM CHANGE: Per-dispatcher contact added callback
+	btContactAddedCallback m_contactAddedCallback = 0;
+	void* m_contactAddedUserInfo = 0;
+
 public:
 	enum DispatcherFlags
 	{
@@ -134,6 +138,24 @@ public:
 		return m_nearCallback;
 	}
 
+	// ROCKETSIM CHANGE: Called for contacts added by this dispatcher's near callback, instead of gContactAddedCallback
+	// Unlike gContactAddedCallback, this is not shared with other worlds, so each world can handle contacts differently
+	void setContactAddedCallback(btContactAddedCallback callback, void* userInfo)
+	{
+		m_contactAddedCallback = callback;
+		m_contactAddedUserInfo = userInfo;
+	}
+
+	btContactAddedCallback getContactAddedCallback() const
+	{
+		return m_contactAddedCallback;
+	}
+
+	void* getContactAddedUserInfo() const
+	{
+		return m_contactAddedUserInfo;
+	}
+
 	//by default, Bullet will use this near callback
 	static void defaultNearCallback(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo);
 
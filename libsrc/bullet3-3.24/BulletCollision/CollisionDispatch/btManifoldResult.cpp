@@ -189,7 +189,8 @@ void btManifoldResult::addContactPoint(const btVector3& normalOnBInWorld, const
 	}
 
 	//User can override friction and/or restitution
-	if (gContactAddedCallback &&
+	// ROCKETSIM CHANGE: Use the per-dispatcher callback if set, otherwise gContactAddedCallback
+	if ((m_contactAddedCallback || gContactAddedCallback) &&
 		//and if either of the two bodies requires custom material
 		((m_body0Wrap->getCollisionObject()->getCollisionFlags() & btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK) ||
 		 (m_body1Wrap->getCollisionObject()->getCollisionFlags() & btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK)))
@@ -197,7 +198,10 @@ void btManifoldResult::addContactPoint(const btVector3& normalOnBInWorld, const
 		//experimental feature info, for per-triangle material etc.
 		const btCollisionObjectWrapper* obj0Wrap = isSwapped ? m_body1Wrap : m_body0Wrap;
 		const btCollisionObjectWrapper* obj1Wrap = isSwapped ? m_body0Wrap : m_body1Wrap;
-		(*gContactAddedCallback)(m_manifoldPtr->getContactPoint(insertIndex), obj0Wrap, newPt.m_partId0, newPt.m_index0, obj1Wrap, newPt.m_partId1, newPt.m_index1);
+		if (m_contactAddedCallback)
+			(*m_contactAddedCallback)(m_contactAddedUserInfo, m_manifoldPtr->getContactPoint(insertIndex), obj0Wrap, newPt.m_partId0, newPt.m_index0, obj1Wrap, newPt.m_partId1, newPt.m_index1);
+		else
+			(*gContactAddedCallback)(m_manifoldPtr->getContactPoint(insertIndex), obj0Wrap, newPt.m_partId0, newPt.m_index0, obj1Wrap, newPt.m_partId1, newPt.m_index1);
 	}
 
 	if (gContactStartedCallback && isNewCollision)
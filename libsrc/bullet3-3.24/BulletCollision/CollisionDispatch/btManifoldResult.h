@@ -31,6 +31,10 @@ class btManifoldPoint;
 typedef bool (*ContactAddedCallback)(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1);
 extern ContactAddedCallback gContactAddedCallback;
 
+// ROCKETSIM CHANGE: Same as ContactAddedCallback, but set per dispatcher (see btCollisionDispatcher::setContactAddedCallback()), and given that dispatcher's user info
+// Used instead of gContactAddedCallback when set
+typedef bool (*btContactAddedCallback)(void* userInfo, btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1);
+
 //#define DEBUG_PART_INDEX 1
 
 /// These callbacks are used to customize the algorith that combine restitution, friction, damping, Stiffness
@@ -56,6 +60,10 @@ protected:
 	int m_index0;
 	int m_index1;
 
+	// ROCKETSIM CHANGE: Per-dispatcher contact added callback, see btCollisionDispatcher::setContactAddedCallback()
+	btContactAddedCallback m_contactAddedCallback = 0;
+	void* m_contactAddedUserInfo = 0;
+
 public:
 	btManifoldResult()
 		:
@@ -100,6 +108,13 @@ public:
 		m_index1 = index1;
 	}
 
+	// ROCKETSIM CHANGE: Set by the dispatcher before it processes a pair
+	void setContactAddedCallback(btContactAddedCallback callback, void* userInfo)
+	{
+		m_contactAddedCallback = callback;
+		m_contactAddedUserInfo = userInfo;
+	}
+
 	virtual void addContactPoint(const btVector3& normalOnBInWorld, const btVector3& pointInWorld, btScalar depth);
 
 	SIMD_FORCE_INLINE void refreshContactPoints()
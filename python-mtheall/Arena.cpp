@@ -2,27 +2,40 @@
 
 #include "Array.h"
 
+#include "Sim/ArenaPool/ArenaPool.h"
+#include "Sim/VecArena/VecArena.h"
+
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <bit>
 #include <cassert>
-#include <chrono>
 #include <cinttypes>
 #include <cmath>
-#include <condition_variable>
 #include <cstdlib>
-#include <deque>
 #include <exception>
-#include <future>
+#include <latch>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <new>
+#include <numeric>
 #include <set>
+#include <span>
+#include <string>
 #include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
 
-using namespace std::chrono_literals;
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
 
 namespace
 {
@@ -194,20 +207,23 @@ bool ensureBoostPadByIndex (RocketSim::Python::Arena *arena_) noexcept
 	return true;
 }
 
-void assign (RocketSim::Python::PyArrayRef &array_, unsigned row_, unsigned col_, btVector3 const &value_) noexcept
+template <typename Array>
+void assign (Array &array_, unsigned row_, unsigned col_, btVector3 const &value_) noexcept
 {
 	array_ (row_, col_ + 0) = value_.x ();
 	array_ (row_, col_ + 1) = value_.y ();
 	array_ (row_, col_ + 2) = value_.z ();
 }
 
-void assign (RocketSim::Python::PyArrayRef &array_, unsigned col_, btVector3 const &value_) noexcept
+template <typename Array>
+void assign (Array &array_, unsigned col_, btVector3 const &value_) noexcept
 {
 	assign (array_, 0, col_, value_);
 	assign (array_, 1, col_, btVector3 (-value_.x (), -value_.y (), value_.z ()));
 }
 
-void assign (RocketSim::Python::PyArrayRef &array_, unsigned col_, btQuaternion const &value_) noexcept
+template <typename Array>
+void assign (Array &array_, unsigned col_, btQuaternion const &value_) noexcept
 {
 	array_ (0, col_ + 0) = value_.w ();
 	array_ (0, col_ + 1) = value_.x ();
@@ -228,7 +244,8 @@ btVector3 calcPYR (btMatrix3x3 const &mat_) noexcept
 	return result;
 }
 
-void assign (RocketSim::Python::PyArrayRef &array_, unsigned col_, btMatrix3x3 const &mat_) noexcept
+template <typename Array>
+void assign (Array &array_, unsigned col_, btMatrix3x3 const &mat_) noexcept
 {
 	auto const forward = mat_.getColumn (0);
 	auto const right   = mat_.getColumn (1);
@@ -242,7 +259,8 @@ void assign (RocketSim::Python::PyArrayRef &array_, unsigned col_, btMatrix3x3 c
 	assign (array_, 1, col_ + 9, calcPYR (btMatrix3x3 (-1, 0, 0, 0, -1, 0, 0, 0, 1) * mat_));
 }
 
-void assign (RocketSim::Python::PyArrayRef &array_,
+template <typename Array>
+void assign (Array &array_,
     unsigned col_,
     btRigidBody &rigidBody_,
     RocketSim::CarState const *state_ = nullptr) noexcept
@@ -264,6 +282,247 @@ void assign (RocketSim::Python::PyArrayRef &array_,
 	assign (array_, col_ + 13, rigidBody_.getWorldTransform ().getBasis ());
 }
 
+// gym state sizes, see Arena.get_gym_state
+constexpr unsigned GYM_GAME_DATA_SIZE = 4;
+constexpr unsigned GYM_BALL_SIZE      = 25;
+constexpr unsigned GYM_CAR_SIZE       = 36;
+
+// Same indexing as PyArrayRef, but over a caller-provided flat buffer
+class FlatArrayRef
+{
+public:
+	FlatArrayRef (float *data_, unsigned dim0_, unsigned dim1_ = 0) noexcept
+	    : m_data (data_), m_dim0 (dim0_), m_dim1 (dim1_)
+	{
+	}
+
+	float &operator() (unsigned dim0_, unsigned dim1_ = 0) noexcept
+	{
+		if (m_dim1)
+			return m_data[dim0_ * m_dim1 + dim1_];
+
+		return m_data[dim0_];
+	}
+
+	bool isnan () const noexcept
+	{
+		return std::any_of (m_data, m_data + m_dim0 * std::max (m_dim1, 1u), [] (float const value_) {
+			return std::isnan (value_);
+		});
+	}
+
+	std::size_t size () const noexcept
+	{
+		return m_dim0 * std::max (m_dim1, 1u);
+	}
+
+private:
+	float *const m_data;
+	unsigned const m_dim0;
+	unsigned const m_dim1;
+};
+
+template <typename Array>
+void assignGameData (Array &array_, RocketSim::Python::Arena const *arena_) noexcept
+{
+	std::uint64_t ballLastCarHitTick = 0;
+	std::uint32_t ballLastCarHitId   = 0;
+	for (auto const &[id, car] : *arena_->cars)
+	{
+		if (!car->car->_internalState.ballHitInfo.isValid)
+			continue;
+
+		if (car->car->_internalState.ballHitInfo.tickCountWhenHit <= ballLastCarHitTick)
+			continue;
+
+		ballLastCarHitTick = car->car->_internalState.ballHitInfo.tickCountWhenHit;
+		ballLastCarHitId   = car->car->id;
+	}
+
+	array_ (0) = static_cast<int> (arena_->arena->gameMode);
+	array_ (1) = ballLastCarHitId;
+	array_ (2) = arena_->blueScore;
+	array_ (3) = arena_->orangeScore;
+}
+
+template <typename Array>
+void assignBoostPads (Array &array_, RocketSim::Python::Arena const *arena_) noexcept
+{
+	auto const numBoostPads = arena_->boostPadsByIndex->size ();
+
+	for (unsigned idx = 0; idx < numBoostPads; ++idx)
+	{
+		auto const pad = arena_->boostPadsByIndex->operator[] (idx)->pad;
+		assert (pad);
+
+		auto const inv = numBoostPads - idx - 1;
+
+		array_ (0, idx) = pad->_internalState.isActive;
+		array_ (1, inv) = pad->_internalState.isActive;
+	}
+}
+
+template <typename Array>
+void assignCar (Array &array_, RocketSim::Python::Arena const *arena_, RocketSim::Python::Car *car_) noexcept
+{
+	auto const &state = car_->car->_internalState;
+
+	auto const hitLastStep = state.ballHitInfo.isValid && state.ballHitInfo.tickCountWhenHit >= arena_->lastGymStateTick;
+
+	for (unsigned i = 0; i < 2; ++i)
+	{
+		array_ (i, 0)  = car_->car->id;
+		array_ (i, 1)  = static_cast<int> (car_->car->team);
+		array_ (i, 2)  = car_->goals;
+		array_ (i, 3)  = car_->saves;
+		array_ (i, 4)  = car_->shots;
+		array_ (i, 5)  = car_->demos;
+		array_ (i, 6)  = car_->boostPickups;
+		array_ (i, 7)  = state.isDemoed;
+		array_ (i, 8)  = state.isOnGround;
+		array_ (i, 9)  = hitLastStep;
+		array_ (i, 10) = state.boost;
+	}
+
+	assign (array_, 11, car_->car->_rigidBody, state.isDemoed ? &car_->demoState : nullptr);
+}
+
+char const BALL_NAN_ERROR[] = R"(!!DETECTED NaN VALUE IN BALL DATA!!
+DID YOU STATE SET MULTIPLE OBJECTS IN THE SAME LOCATION?)";
+
+char const CAR_NAN_ERROR[] = R"(!!DETECTED NaN VALUE IN CAR DATA!!
+DID YOU STATE SET MULTIPLE OBJECTS IN THE SAME LOCATION?)";
+
+// Makes sure the boost pad mapping used by the gym state is up to date, needs the GIL
+bool prepareGymState (RocketSim::Python::Arena *arena_) noexcept
+{
+	auto const numBoostPads = arena_->arena->GetBoostPads ().size ();
+	if (arena_->boostPadsByIndex->size () == numBoostPads)
+		return true;
+
+	if (!ensureBoostPadByIndex (arena_))
+		return false;
+
+	if (arena_->boostPadsByIndex->size () != numBoostPads)
+	{
+		PyErr_SetString (PyExc_RuntimeError, "Boost pads size mismatch");
+		return false;
+	}
+
+	return true;
+}
+
+std::size_t gymStateSize (RocketSim::Python::Arena const *arena_) noexcept
+{
+	return GYM_GAME_DATA_SIZE + 2 * arena_->boostPadsByIndex->size () + 2 * GYM_BALL_SIZE +
+	       2 * GYM_CAR_SIZE * arena_->cars->size ();
+}
+
+// Writes the flattened gym state into out_, which must have room for gymStateSize (arena_) floats
+// Doesn't need the GIL, returns an error message on failure
+char const *writeGymState (RocketSim::Python::Arena *arena_, float *out_) noexcept
+{
+	auto gameData = FlatArrayRef (out_, GYM_GAME_DATA_SIZE);
+	assignGameData (gameData, arena_);
+	out_ += gameData.size ();
+
+	// no boost pads would make this a 1D view, so don't use its size
+	auto const numBoostPads = arena_->boostPadsByIndex->size ();
+	auto boostPadState      = FlatArrayRef (out_, 2, numBoostPads);
+	assignBoostPads (boostPadState, arena_);
+	out_ += 2 * numBoostPads;
+
+	auto ballState = FlatArrayRef (out_, 2, GYM_BALL_SIZE);
+	assign (ballState, 0, arena_->arena->ball->_rigidBody);
+	if (ballState.isnan ())
+		return BALL_NAN_ERROR;
+	out_ += ballState.size ();
+
+	for (auto const &[id, car] : *arena_->cars)
+	{
+		auto carState = FlatArrayRef (out_, 2, GYM_CAR_SIZE);
+		assignCar (carState, arena_, car.borrow ());
+		if (carState.isnan ())
+			return CAR_NAN_ERROR;
+		out_ += carState.size ();
+	}
+
+	arena_->lastGymStateTick = arena_->arena->tickCount;
+
+	return nullptr;
+}
+
+// columns of a control row for Arena.multi_step, same order as CarControls' constructor
+constexpr unsigned CONTROLS_SIZE = 8;
+
+RocketSim::CarControls toCarControls (float const *row_) noexcept
+{
+	RocketSim::CarControls controls;
+	controls.throttle  = row_[0];
+	controls.steer     = row_[1];
+	controls.pitch     = row_[2];
+	controls.yaw       = row_[3];
+	controls.roll      = row_[4];
+	controls.boost     = row_[5] != 0.0f;
+	controls.jump      = row_[6] != 0.0f;
+	controls.handbrake = row_[7] != 0.0f;
+
+	return controls;
+}
+
+// columns of an event row for Arena.multi_step_export, same order as CarEventCounts
+constexpr unsigned EVENTS_SIZE = 4;
+
+void assignEvents (float *row_, RocketSim::CarEventCounts const &events_) noexcept
+{
+	row_[0] = events_.ballTouches;
+	row_[1] = events_.demosInflicted;
+	row_[2] = events_.timesDemoed;
+	row_[3] = events_.boostPickups;
+}
+
+// columns of a ball row for RocketSim.predict_balls: position, velocity and angular velocity, optionally followed by
+// the rotation matrix's forward, right and up vectors
+constexpr unsigned BALL_PRED_SIZE     = 9;
+constexpr unsigned BALL_PRED_ROT_SIZE = 18;
+
+RocketSim::BallState toBallState (float const *row_, unsigned const cols_) noexcept
+{
+	RocketSim::BallState state;
+	state.pos    = RocketSim::Vec (row_[0], row_[1], row_[2]);
+	state.vel    = RocketSim::Vec (row_[3], row_[4], row_[5]);
+	state.angVel = RocketSim::Vec (row_[6], row_[7], row_[8]);
+
+	if (cols_ == BALL_PRED_ROT_SIZE)
+	{
+		state.rotMat = RocketSim::RotMat (RocketSim::Vec (row_[9], row_[10], row_[11]),
+		    RocketSim::Vec (row_[12], row_[13], row_[14]),
+		    RocketSim::Vec (row_[15], row_[16], row_[17]));
+	}
+
+	return state;
+}
+
+void assignBallPred (float *row_, RocketSim::BallState const &state_, unsigned const cols_) noexcept
+{
+	for (auto const &vec : {state_.pos, state_.vel, state_.angVel})
+	{
+		*row_++ = vec.x;
+		*row_++ = vec.y;
+		*row_++ = vec.z;
+	}
+
+	if (cols_ != BALL_PRED_ROT_SIZE)
+		return;
+
+	for (auto const &vec : {state_.rotMat.forward, state_.rotMat.right, state_.rotMat.up})
+	{
+		*row_++ = vec.x;
+		*row_++ = vec.y;
+		*row_++ = vec.z;
+	}
+}
+
 void saveException (RocketSim::Python::Arena const *const arena_) noexcept
 {
 	PyErr_Fetch (&arena_->stepExceptionType, &arena_->stepExceptionValue, &arena_->stepExceptionTraceback);
@@ -297,6 +556,40 @@ void discardException (RocketSim::Python::Arena const *const arena_) noexcept
 	arena_->stepExceptionValue     = nullptr;
 	arena_->stepExceptionTraceback = nullptr;
 }
+
+bool hasCallbacks (RocketSim::Python::Arena const *const arena_) noexcept
+{
+	for (auto const callback : {arena_->ballTouchCallback,
+	         arena_->ballTouchCallbackUserData,
+	         arena_->boostPickupCallback,
+	         arena_->boostPickupCallbackUserData,
+	         arena_->carBumpCallback,
+	         arena_->carBumpCallbackUserData,
+	         arena_->carDemoCallback,
+	         arena_->carDemoCallbackUserData,
+	         arena_->goalScoreCallback,
+	         arena_->goalScoreCallbackUserData,
+	         arena_->shotEventCallback,
+	         arena_->shotEventCallbackUserData,
+	         arena_->goalEventCallback,
+	         arena_->goalEventCallbackUserData,
+	         arena_->saveEventCallback,
+	         arena_->saveEventCallbackUserData})
+	{
+		if (callback != Py_None)
+			return true;
+	}
+
+	return false;
+}
+
+// unpickled arenas are given back to this pool when they are destroyed, so that later unpickles can re-use them
+RocketSim::ArenaPool &unpicklePool () noexcept
+{
+	// never destroyed, as arenas can still be released during interpreter shutdown
+	static auto *const pool = new RocketSim::ArenaPool (16);
+	return *pool;
+}
 }
 
 namespace RocketSim::Python
@@ -304,36 +597,57 @@ namespace RocketSim::Python
 class Arena::ThreadPool
 {
 public:
+	struct Config
+	{
+		// number of worker threads, 0 for one per hardware thread
+		unsigned numThreads = 0;
+		// worker i is pinned to cpu affinity[i % affinity.size ()], empty to leave placement to the OS
+		std::vector<unsigned> affinity;
+		// always step an arena on the same worker instead of balancing arenas between workers
+		bool sticky = false;
+	};
+
 	~ThreadPool () noexcept
 	{
-		{
-			auto const lock = std::scoped_lock (m_mutex);
-			m_quit          = true;
-		}
+		m_quit = true;
 
-		m_cv.notify_all ();
+		++m_generation;
+		m_generation.notify_all ();
 
 		for (auto &thread : m_threads)
 			thread.join ();
 	}
 
-	ThreadPool () noexcept
+	explicit ThreadPool (Config const &config_, std::uint64_t const id_) noexcept : m_config (config_), m_id (id_)
 	{
-		auto const numThreads = std::max (1u, std::thread::hardware_concurrency ());
+		auto const numThreads =
+		    m_config.numThreads ? m_config.numThreads : std::max (1u, std::thread::hardware_concurrency ());
 
 		m_threads.reserve (numThreads);
 
 		for (unsigned i = 0; i < numThreads; ++i)
-			m_threads.emplace_back (&Arena::ThreadPool::run, this);
+			m_threads.emplace_back (&Arena::ThreadPool::run, this, i);
 	}
 
-	bool SubmitJob (std::set<PyRef<Arena>> const &arenas_, unsigned const ticks_) noexcept
+	// called once for every arena in a job, with the arena's index in the submitted list
+	using Task = void (*) (void *context_, std::size_t index_);
+
+	bool SubmitJob (std::span<Arena *const> const arenas_, Task const task_, void *const context_) noexcept
 	{
-		std::vector<std::shared_future<void>> futures;
+		auto const numThreads = static_cast<unsigned> (m_threads.size ());
+
+		// only one job can be in flight at a time
+		auto const lock = std::scoped_lock (m_submitMutex);
+
+		if (!prepareJob (arenas_.size ()))
+			return false;
+
+		if (!m_config.sticky)
+			return runJob (arenas_.size (), task_, context_, true);
 
 		try
 		{
-			futures.reserve (arenas_.size ());
+			m_fill.assign (numThreads, 0);
 		}
 		catch (std::exception const &err)
 		{
@@ -341,67 +655,59 @@ public:
 			return false;
 		}
 
-		{
-			auto const lock = std::scoped_lock (m_mutex);
+		auto const chunks = m_chunks.get ();
 
-			try
+		// every arena keeps the worker it was first assigned to; the caller isn't pinned so it gets nothing
+		for (unsigned i = 0; i < numThreads + 1; ++i)
+			chunks[i].next = chunks[i].end = 0;
+
+		for (auto const arena : arenas_)
+		{
+			// workers assigned by a previous pool don't mean anything to this one
+			if (arena->threadPoolId != m_id || arena->threadPoolWorker >= numThreads)
 			{
-				for (auto &arena : arenas_)
-				{
-					auto future =
-					    std::async (std::launch::deferred, &RocketSim::Arena::Step, arena->arena.get (), ticks_)
-					        .share ();
-					m_jobs.emplace_back (future);
-					futures.emplace_back (future);
-				}
+				arena->threadPoolId     = m_id;
+				arena->threadPoolWorker = m_nextStickyWorker++ % numThreads;
 			}
-			catch (std::exception const &err)
-			{
-				// remove added jobs
-				for (unsigned i = 0; i < futures.size (); ++i)
-					m_jobs.pop_back ();
 
-				PyErr_SetString (PyExc_RuntimeError, err.what ());
-				return false;
-			}
+			++chunks[arena->threadPoolWorker].end;
 		}
 
-		if (futures.size () >= m_threads.size ())
-			m_cv.notify_all ();
-		else
+		for (unsigned i = 1; i < numThreads + 1; ++i)
 		{
-			for (unsigned i = 0; i < futures.size (); ++i)
-				m_cv.notify_one ();
+			chunks[i].next = chunks[i - 1].end;
+			chunks[i].end += chunks[i - 1].end;
 		}
 
-		// wait for submitted jobs to complete
-		for (auto &future : futures)
+		for (std::size_t i = 0; i < arenas_.size (); ++i)
 		{
-			while (future.valid () && future.wait_for (100ms) != std::future_status::ready)
-			{
-			}
+			auto const worker                               = arenas_[i]->threadPoolWorker;
+			m_order[chunks[worker].next + m_fill[worker]++] = i;
 		}
 
-		// update game tracker events
-		for (auto &arena : arenas_)
-		{
-			if (arena->gameEvent)
-				arena->gameEvent->Update (arena->arena.get ());
-		}
+		return runJob (arenas_.size (), task_, context_, false);
+	}
 
-		return true;
+	// Same as above for work that isn't tied to arenas, called once for every index in [0, count_)
+	bool SubmitJob (std::size_t const count_, Task const task_, void *const context_) noexcept
+	{
+		auto const lock = std::scoped_lock (m_submitMutex);
+
+		if (!prepareJob (count_))
+			return false;
+
+		return runJob (count_, task_, context_, true);
 	}
 
 	static std::shared_ptr<ThreadPool> GetInstance () noexcept
 	{
-		static std::mutex mutex;
-		auto const lock = std::scoped_lock (mutex);
+		auto const lock = std::scoped_lock (s_instanceMutex);
 
 		try
 		{
 			auto pool = s_instance.lock ();
 			if (!pool)
-				s_instance = pool = std::make_shared<ThreadPool> ();
+				s_instance = pool = std::make_shared<ThreadPool> (s_config, ++s_lastId);
 
 			return pool;
 		}
@@ -411,38 +717,217 @@ public:
 		}
 	}
 
+	// Takes effect for the next multi_step; arenas stepped by the current pool keep it alive until then
+	static void Configure (Config config_) noexcept
+	{
+		auto const lock = std::scoped_lock (s_instanceMutex);
+
+		s_config = std::move (config_);
+		s_instance.reset ();
+	}
+
 private:
-	void run () noexcept
+	struct alignas (64) Chunk
 	{
-		while (true)
+		std::atomic<std::size_t> next = 0;
+		std::size_t end               = 0;
+	};
+
+	struct Job
+	{
+		Job (std::size_t const *order_,
+		    Chunk *chunks_,
+		    unsigned const numChunks_,
+		    Task const task_,
+		    void *const context_,
+		    bool const steal_) noexcept
+		    : order (order_),
+		      chunks (chunks_),
+		      numChunks (numChunks_),
+		      task (task_),
+		      context (context_),
+		      steal (steal_),
+		      done (numChunks_)
+		{
+		}
+
+		std::size_t const *order;
+		Chunk *chunks;
+		unsigned numChunks;
+		Task task;
+		void *context;
+		bool steal;
+
+		std::latch done;
+
+		std::atomic_flag failed;
+		std::exception_ptr error;
+	};
+
+	// needs m_submitMutex
+	bool prepareJob (std::size_t const count_) noexcept
+	{
+		try
+		{
+			m_order.resize (count_);
+
+			if (!m_chunks)
+				m_chunks = std::make_unique<Chunk[]> (m_threads.size () + 1);
+		}
+		catch (std::exception const &err)
+		{
+			PyErr_SetString (PyExc_RuntimeError, err.what ());
+			return false;
+		}
+
+		return true;
+	}
+
+	// needs m_submitMutex; if balance_, items are split evenly between workers, otherwise m_order and m_chunks
+	// must already be filled in
+	bool runJob (std::size_t const count_, Task const task_, void *const context_, bool const balance_) noexcept
+	{
+		// the calling thread takes part in the job as the last worker
+		auto const numWorkers = static_cast<unsigned> (m_threads.size ()) + 1;
+		auto const chunks     = m_chunks.get ();
+
+		if (balance_)
+		{
+			std::iota (std::begin (m_order), std::end (m_order), std::size_t{0});
+
+			// split items into one contiguous chunk per worker; idle workers steal from the others
+			for (unsigned i = 0; i < numWorkers; ++i)
+			{
+				chunks[i].next = count_ * i / numWorkers;
+				chunks[i].end  = count_ * (i + 1) / numWorkers;
+			}
+		}
+
+		Job job (m_order.data (), chunks, numWorkers, task_, context_, balance_);
+
+		m_job = &job;
+
+		++m_generation;
+		m_generation.notify_all ();
+
+		work (job, numWorkers - 1);
+
+		// every worker counts down exactly once, so nobody references the job after this
+		job.done.wait ();
+
+		m_job = nullptr;
+
+		if (job.failed.test ())
 		{
-			auto lock = std::unique_lock (m_mutex);
+			try
+			{
+				std::rethrow_exception (job.error);
+			}
+			catch (std::exception const &err)
+			{
+				PyErr_SetString (PyExc_RuntimeError, err.what ());
+			}
+			catch (...)
+			{
+				PyErr_SetString (PyExc_RuntimeError, "Unknown exception");
+			}
+
+			return false;
+		}
+
+		return true;
+	}
 
-			while (!m_quit && m_jobs.empty ())
-				m_cv.wait (lock);
+	void run (unsigned const index_) noexcept
+	{
+		// pin before taking part in any job
+		if (!m_config.affinity.empty ())
+			pinThread (m_config.affinity[index_ % m_config.affinity.size ()]);
+
+		// jobs may be submitted before this thread gets to run, so start from the initial generation
+		std::uint64_t generation = 0;
+
+		while (true)
+		{
+			m_generation.wait (generation);
+			generation = m_generation.load ();
 
-			if (m_quit && m_jobs.empty ())
+			if (m_quit)
 				return;
 
-			auto job = m_jobs.front ();
-			m_jobs.pop_front ();
+			work (*m_job.load (), index_);
+		}
+	}
+
+	static void work (Job &job_, unsigned const index_) noexcept
+	{
+		// start with our own chunk, then steal from the following ones
+		for (unsigned i = 0; i < (job_.steal ? job_.numChunks : 1); ++i)
+		{
+			auto &chunk = job_.chunks[(index_ + i) % job_.numChunks];
 
-			lock.unlock ();
+			while (true)
+			{
+				auto const index = chunk.next.fetch_add (1, std::memory_order_relaxed);
+				if (index >= chunk.end)
+					break;
 
-			job.get ();
+				try
+				{
+					job_.task (job_.context, job_.order[index]);
+				}
+				catch (...)
+				{
+					// keep the exception itself, as copying its message could throw here
+					if (!job_.failed.test_and_set ())
+						job_.error = std::current_exception ();
+				}
+			}
 		}
+
+		job_.done.count_down ();
+	}
+
+	// pins the calling thread
+	static void pinThread (unsigned const cpu_) noexcept
+	{
+#if defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO (&set);
+		CPU_SET (cpu_, &set);
+		pthread_setaffinity_np (pthread_self (), sizeof (set), &set);
+#elif defined(_WIN32)
+		SetThreadAffinityMask (GetCurrentThread (), DWORD_PTR{1} << cpu_);
+#else
+		// affinity is only a hint, and not supported here
+		(void)cpu_;
+#endif
 	}
 
 	static std::weak_ptr<ThreadPool> s_instance;
+	static std::mutex s_instanceMutex;
+	static Config s_config;
+	static std::uint64_t s_lastId;
 
+	Config const m_config;
+	std::uint64_t const m_id;
 	std::vector<std::thread> m_threads;
-	std::deque<std::shared_future<void>> m_jobs;
-	std::mutex m_mutex;
-	std::condition_variable m_cv;
-	bool m_quit = false;
+	std::mutex m_submitMutex;
+	unsigned m_nextStickyWorker = 0;
+
+	// scratch space reused by every job
+	std::unique_ptr<Chunk[]> m_chunks;
+	std::vector<std::size_t> m_order;
+	std::vector<std::size_t> m_fill;
+	std::atomic<Job *> m_job = nullptr;
+	std::atomic<std::uint64_t> m_generation = 0;
+	std::atomic<bool> m_quit                = false;
 };
 
 std::weak_ptr<Arena::ThreadPool> Arena::ThreadPool::s_instance;
+std::mutex Arena::ThreadPool::s_instanceMutex;
+Arena::ThreadPool::Config Arena::ThreadPool::s_config;
+std::uint64_t Arena::ThreadPool::s_lastId = 0;
 
 PyTypeObject *Arena::Type = nullptr;
 
@@ -534,6 +1019,18 @@ Format: tuple(a, b, c, car1, car2, ...)
 	            rot_up_x, rot_up_y, rot_up_z,
 	            pitch, yaw, roll] # applied in yaw-pitch-roll order
 	car_state_inverse: car_state rotated around Z-axis)"},
+    {.ml_name     = "get_gym_state_size",
+        .ml_meth  = (PyCFunction)&Arena::GetGymStateSize,
+        .ml_flags = METH_NOARGS,
+        .ml_doc   = R"(get_gym_state_size(self) -> int
+Number of floats written by write_gym_state)"},
+    {.ml_name     = "write_gym_state",
+        .ml_meth  = (PyCFunction)&Arena::WriteGymState,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc   = R"(write_gym_state(self, out: numpy.ndarray, offset: int = 0) -> int
+Writes the same data as get_gym_state into a preallocated C-contiguous float32 array, without allocating
+Written flat starting at `offset`: a, b[0], b[1], c[0], c[1], car1[0], car1[1], ...
+Returns the number of floats written)"},
 
     {.ml_name     = "get_mutator_config",
         .ml_meth  = (PyCFunction)&Arena::GetMutatorConfig,
@@ -548,10 +1045,25 @@ remove_car(self, car: int))"},
         .ml_meth  = (PyCFunction)&Arena::IsBallProbablyGoingIn,
         .ml_flags = METH_VARARGS | METH_KEYWORDS,
         .ml_doc   = R"(is_ball_probably_going_in(self, max_time: float = 0.2) -> bool)"},
+    {.ml_name     = "reset",
+        .ml_meth  = (PyCFunction)&Arena::Reset,
+        .ml_flags = METH_NOARGS,
+        .ml_doc   = R"(reset(self)
+Removes all cars and puts the arena back to how it was when created, without reallocating it)"},
     {.ml_name     = "reset_kickoff",
         .ml_meth  = (PyCFunction)&Arena::ResetKickoff,
         .ml_flags = METH_VARARGS | METH_KEYWORDS,
         .ml_doc   = R"(reset_kickoff(self, seed = -1))"},
+    {.ml_name     = "restore_snapshot",
+        .ml_meth  = (PyCFunction)&Arena::RestoreSnapshot,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc   = R"(restore_snapshot(self, snapshot: RocketSim.ArenaSnapshot)
+Restore a snapshot saved from this arena, or from an arena with the same setup and the same car ids)"},
+    {.ml_name     = "save_snapshot",
+        .ml_meth  = (PyCFunction)&Arena::SaveSnapshot,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc   = R"(save_snapshot(self, snapshot: RocketSim.ArenaSnapshot = None) -> RocketSim.ArenaSnapshot
+Saves the arena's dynamic state into snapshot, or into a new one if not specified)"},
     {.ml_name     = "set_ball_touch_callback",
         .ml_meth  = (PyCFunction)&Arena::SetBallTouchCallback,
         .ml_flags = METH_VARARGS | METH_KEYWORDS,
@@ -631,7 +1143,32 @@ This can be called from within a callback to stop simulation early)"},
     {.ml_name     = "multi_step",
         .ml_meth  = (PyCFunction)&Arena::MultiStep,
         .ml_flags = METH_VARARGS | METH_KEYWORDS | METH_STATIC,
-        .ml_doc   = R"(multi_step(arenas: Sequence[RocketSim.Arena] = [], ticks: int = 1))"},
+        .ml_doc   = R"(multi_step(arenas: Sequence[RocketSim.Arena] = [], ticks: int = 1, controls: numpy.ndarray | None = None)
+If given, `controls` is a float32 array of shape (total number of cars, 8) that is applied before stepping
+Rows are for each arena's cars in order of car id, following the order of `arenas`
+Columns: [throttle, steer, pitch, yaw, roll, boost, jump, handbrake], any non-zero value is true for buttons)"},
+    {.ml_name     = "multi_step_export",
+        .ml_meth  = (PyCFunction)&Arena::MultiStepExport,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS | METH_STATIC,
+        .ml_doc   = R"(multi_step_export(arenas: Sequence[RocketSim.Arena], ticks: int = 1, controls: numpy.ndarray | None = None, obs: numpy.ndarray | None = None, events: numpy.ndarray | None = None, dones: numpy.ndarray | None = None)
+Like multi_step, but each arena stops early once a goal is scored and the results are written in the same call
+`controls` is as in multi_step
+`obs` receives every arena's write_gym_state back to back, as in multi_write_gym_state
+`events` is a float32 array of shape (total number of cars, 4), rows in the same order as `controls`
+Columns: [ball touches, demos inflicted, times demoed, boost pickups] during this call
+`dones` is a float32 array of shape (len(arenas),), set to 1 where a goal was scored and 0 elsewhere)"},
+    {.ml_name     = "multi_write_gym_state",
+        .ml_meth  = (PyCFunction)&Arena::MultiWriteGymState,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS | METH_STATIC,
+        .ml_doc   = R"(multi_write_gym_state(arenas: Sequence[RocketSim.Arena], out: numpy.ndarray) -> int
+Calls write_gym_state for every arena in parallel, packing them back to back into `out` in sequence order
+Returns the total number of floats written)"},
+    {.ml_name     = "vec_step",
+        .ml_meth  = (PyCFunction)&Arena::VecStep,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS | METH_STATIC,
+        .ml_doc   = R"(vec_step(arenas: Sequence[RocketSim.Arena], ticks: int = 1)
+Steps the arenas one after another on this thread, with the GIL released for the whole batch
+Each arena simulates the same as if it was stepped on its own, and stops early if its step is stopped)"},
     {.ml_name = "__getstate__", .ml_meth = (PyCFunction)&Arena::Pickle, .ml_flags = METH_NOARGS, .ml_doc = nullptr},
     {.ml_name = "__setstate__", .ml_meth = (PyCFunction)&Arena::Unpickle, .ml_flags = METH_O, .ml_doc = nullptr},
     {.ml_name     = "__copy__",
@@ -716,6 +1253,8 @@ PyObject *Arena::New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_)
 	self->orangeScore                 = 0;
 	self->lastGoalTick                = 0;
 	self->lastGymStateTick            = 0;
+	self->threadPoolId                = 0;
+	self->threadPoolWorker            = std::numeric_limits<unsigned>::max ();
 	self->stepExceptionType           = nullptr;
 	self->stepExceptionValue          = nullptr;
 	self->stepExceptionTraceback      = nullptr;
@@ -801,6 +1340,7 @@ int Arena::Init (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept
 	{
 	case RocketSim::ArenaMemWeightMode::LIGHT:
 	case RocketSim::ArenaMemWeightMode::HEAVY:
+	case RocketSim::ArenaMemWeightMode::SHARED:
 		break;
 
 	default:
@@ -808,6 +1348,12 @@ int Arena::Init (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept
 		return -1;
 	}
 
+	if (arenaConfig.memWeightMode == RocketSim::ArenaMemWeightMode::SHARED && !arenaConfig.useCustomBroadphase)
+	{
+		PyErr_SetString (PyExc_ValueError, "Shared arena memory weight mode requires use_custom_broadphase");
+		return -1;
+	}
+
 	if (tickRate < 15.0f || tickRate > 120.0f)
 	{
 		PyErr_Format (PyExc_RuntimeError, "Invalid tick rate '%f'", tickRate);
@@ -938,6 +1484,10 @@ void Arena::Dealloc (Arena *self_) noexcept
 
 PyObject *Arena::Pickle (Arena *self_) noexcept
 {
+	// callbacks can only be pickled as python objects
+	if (!hasCallbacks (self_))
+		return PickleBinary (self_);
+
 	auto dict = PyObjectRef::steal (PyDict_New ());
 	if (!dict)
 		return nullptr;
@@ -1102,6 +1652,9 @@ PyObject *Arena::Pickle (Arena *self_) noexcept
 
 PyObject *Arena::Unpickle (Arena *self_, PyObject *dict_) noexcept
 {
+	if (PyBytes_Check (dict_))
+		return UnpickleBinary (self_, dict_);
+
 	if (!PyDict_Check (dict_))
 	{
 		PyErr_SetString (PyExc_ValueError, "Pickled object is not a dict");
@@ -1261,6 +1814,7 @@ PyObject *Arena::Unpickle (Arena *self_, PyObject *dict_) noexcept
 	{
 	case RocketSim::ArenaMemWeightMode::LIGHT:
 	case RocketSim::ArenaMemWeightMode::HEAVY:
+	case RocketSim::ArenaMemWeightMode::SHARED:
 		break;
 
 	default:
@@ -1503,30 +2057,259 @@ PyObject *Arena::Unpickle (Arena *self_, PyObject *dict_) noexcept
 	}
 }
 
-PyObject *Arena::Copy (Arena *self_) noexcept
+PyObject *Arena::PickleBinary (Arena *self_) noexcept
 {
-	auto args = PyObjectRef::steal (PyTuple_New (1));
-	if (!args)
-		return nullptr;
+	try
+	{
+		// re-used, so that pickling doesn't allocate once the buffer is big enough
+		static thread_local RocketSim::DataStreamOut out;
+		out.Clear ();
 
-	PyTuple_SetItem (args.borrow (), 0, PyBool_FromLong (true));
+		out.Write<std::uint32_t> (RS_VERSION_ID);
 
-	return Clone (self_, args.borrow (), nullptr);
-}
+		self_->arena->Serialize (out);
 
-PyObject *Arena::DeepCopy (Arena *self_, PyObject *memo_) noexcept
-{
-	auto args = PyObjectRef::steal (PyTuple_New (1));
-	if (!args)
-		return nullptr;
+		// python-side state, which the core arena doesn't know about
+		out.Write<std::uint64_t> (self_->ball->ball->_internalState.updateCounter);
 
-	PyTuple_SetItem (args.borrow (), 0, PyBool_FromLong (true));
+		out.Write<std::uint32_t> (self_->cars->size ());
+		for (auto const &[id, car] : *self_->cars)
+		{
+			out.WriteMultiple (id,
+			    car->car->_internalState.updateCounter,
+			    car->goals,
+			    car->demos,
+			    car->boostPickups,
+			    car->shots,
+			    car->saves,
+			    car->assists);
+		}
 
-	return Clone (self_, args.borrow (), nullptr);
-}
+		out.WriteMultiple (self_->blueScore, self_->orangeScore, self_->lastGoalTick, self_->lastGymStateTick);
 
-PyObject *Arena::AddCar (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept
-{
+		return PyBytes_FromStringAndSize (reinterpret_cast<char const *> (out.GetData ()), out.GetSize ());
+	}
+	catch (std::bad_alloc const &err)
+	{
+		return PyErr_NoMemory ();
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return nullptr;
+	}
+	catch (...)
+	{
+		if (!PyErr_Occurred ())
+			PyErr_SetString (PyExc_RuntimeError, "Unknown exception");
+
+		return nullptr;
+	}
+}
+
+PyObject *Arena::UnpickleBinary (Arena *self_, PyObject *bytes_) noexcept
+{
+	char *buffer;
+	Py_ssize_t size;
+	if (PyBytes_AsStringAndSize (bytes_, &buffer, &size) < 0)
+		return nullptr;
+
+	try
+	{
+		// default initialization if it hasn't been done yet
+		InitInternal (nullptr);
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return nullptr;
+	}
+
+	try
+	{
+		// read straight from the bytes object
+		RocketSim::DataStreamIn in (reinterpret_cast<byte const *> (buffer), size);
+
+		if (!in.DoVersionCheck ())
+		{
+			PyErr_SetString (PyExc_ValueError, "Pickled arena is from a different version of RocketSim");
+			return nullptr;
+		}
+
+		auto arena = std::shared_ptr<RocketSim::Arena> (RocketSim::Arena::DeserializeNew (in, &unpicklePool ()),
+		    [] (RocketSim::Arena *arena_) { unpicklePool ().Release (arena_); });
+
+		auto const ballUpdateCounter = in.Read<std::uint64_t> ();
+
+		auto carMap        = std::map<std::uint32_t, PyRef<Car>>{};
+		auto const numCars = in.Read<std::uint32_t> ();
+		for (unsigned i = 0; i < numCars && !in.IsOverflown (); ++i)
+		{
+			auto car = PyRef<Car>::steal (Car::New ());
+			if (!car)
+				return nullptr;
+
+			std::uint32_t id;
+			std::uint64_t updateCounter;
+			in.ReadMultiple (
+			    id, updateCounter, car->goals, car->demos, car->boostPickups, car->shots, car->saves, car->assists);
+
+			auto const it = arena->_carIDMap.find (id);
+			if (it == std::end (arena->_carIDMap))
+				return PyErr_Format (PyExc_ValueError, "Pickled stats for unknown car id '%" PRIu32 "'", id);
+
+			car->arena = arena;
+			car->car   = it->second;
+			car->car->_internalState.updateCounter = updateCounter;
+
+			carMap[id] = std::move (car);
+		}
+
+		unsigned blueScore;
+		unsigned orangeScore;
+		std::uint64_t lastGoalTick;
+		std::uint64_t lastGymStateTick;
+		in.ReadMultiple (blueScore, orangeScore, lastGoalTick, lastGymStateTick);
+
+		if (in.IsOverflown () || carMap.size () != arena->_cars.size ())
+		{
+			PyErr_SetString (PyExc_ValueError, "Pickled arena is truncated");
+			return nullptr;
+		}
+
+		auto padMap = std::unordered_map<RocketSim::BoostPad *, PyRef<BoostPad>>{};
+		auto padVec = std::vector<PyRef<BoostPad>>{};
+		for (auto const &pad : arena->GetBoostPads ())
+		{
+			auto ref = PyRef<BoostPad>::steal (BoostPad::New ());
+			if (!ref)
+				return nullptr;
+
+			ref->arena = arena;
+			ref->pad   = pad;
+
+			padMap.emplace (pad, ref);
+			padVec.emplace_back (std::move (ref));
+		}
+
+		auto gameEvent = std::unique_ptr<RocketSim::GameEventTracker>{};
+		switch (arena->gameMode)
+		{
+		case RocketSim::GameMode::SOCCAR:
+		case RocketSim::GameMode::HOOPS:
+		case RocketSim::GameMode::SNOWDAY:
+			gameEvent = std::make_unique<RocketSim::GameEventTracker> ();
+			gameEvent->SetShotCallback (&Arena::HandleShotEventCallback, self_);
+			gameEvent->SetGoalCallback (&Arena::HandleGoalEventCallback, self_);
+			gameEvent->SetSaveCallback (&Arena::HandleSaveEventCallback, self_);
+			break;
+
+		default:
+			break;
+		}
+
+		auto ball = PyRef<Ball>::steal (Ball::New ());
+		if (!ball)
+			return PyErr_NoMemory ();
+
+		// no exceptions thrown after this point
+		arena->ball->_internalState.updateCounter = ballUpdateCounter;
+
+		if (self_->arena)
+		{
+			self_->arena->SetBallTouchCallback (nullptr, nullptr);
+			self_->arena->SetBoostPickupCallback (nullptr, nullptr);
+			self_->arena->SetCarBumpCallback (nullptr, nullptr);
+			self_->arena->SetGoalScoreCallback (nullptr, nullptr);
+		}
+
+		self_->arena = std::move (arena);
+
+		delete self_->gameEvent;
+		self_->gameEvent = gameEvent.release ();
+
+		PyRef<Ball>::assign (self_->ball, ball.borrowObject ());
+		self_->ball->arena = self_->arena;
+		self_->ball->ball  = self_->arena->ball;
+
+		*self_->cars             = std::move (carMap);
+		*self_->boostPads        = std::move (padMap);
+		*self_->boostPadsByIndex = std::move (padVec);
+
+		self_->blueScore        = blueScore;
+		self_->orangeScore      = orangeScore;
+		self_->lastGoalTick     = lastGoalTick;
+		self_->lastGymStateTick = lastGymStateTick;
+
+		PyObjectRef::assign (self_->ballTouchCallback, Py_None);
+		PyObjectRef::assign (self_->ballTouchCallbackUserData, Py_None);
+		PyObjectRef::assign (self_->boostPickupCallback, Py_None);
+		PyObjectRef::assign (self_->boostPickupCallbackUserData, Py_None);
+		PyObjectRef::assign (self_->carBumpCallback, Py_None);
+		PyObjectRef::assign (self_->carBumpCallbackUserData, Py_None);
+		PyObjectRef::assign (self_->carDemoCallback, Py_None);
+		PyObjectRef::assign (self_->carDemoCallbackUserData, Py_None);
+		PyObjectRef::assign (self_->goalScoreCallback, Py_None);
+		PyObjectRef::assign (self_->goalScoreCallbackUserData, Py_None);
+		PyObjectRef::assign (self_->shotEventCallback, Py_None);
+		PyObjectRef::assign (self_->shotEventCallbackUserData, Py_None);
+		PyObjectRef::assign (self_->goalEventCallback, Py_None);
+		PyObjectRef::assign (self_->goalEventCallbackUserData, Py_None);
+		PyObjectRef::assign (self_->saveEventCallback, Py_None);
+		PyObjectRef::assign (self_->saveEventCallbackUserData, Py_None);
+
+		self_->arena->SetCarBumpCallback (&Arena::HandleCarBumpCallback, self_);
+
+		if (self_->arena->gameMode != RocketSim::GameMode::THE_VOID)
+		{
+			self_->arena->SetBoostPickupCallback (&Arena::HandleBoostPickupCallback, self_);
+			self_->arena->SetGoalScoreCallback (&Arena::HandleGoalScoreCallback, self_);
+		}
+
+		Py_RETURN_NONE;
+	}
+	catch (std::bad_alloc const &err)
+	{
+		return PyErr_NoMemory ();
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_ValueError, err.what ());
+		return nullptr;
+	}
+	catch (...)
+	{
+		if (!PyErr_Occurred ())
+			PyErr_SetString (PyExc_RuntimeError, "Unknown exception");
+
+		return nullptr;
+	}
+}
+
+PyObject *Arena::Copy (Arena *self_) noexcept
+{
+	auto args = PyObjectRef::steal (PyTuple_New (1));
+	if (!args)
+		return nullptr;
+
+	PyTuple_SetItem (args.borrow (), 0, PyBool_FromLong (true));
+
+	return Clone (self_, args.borrow (), nullptr);
+}
+
+PyObject *Arena::DeepCopy (Arena *self_, PyObject *memo_) noexcept
+{
+	auto args = PyObjectRef::steal (PyTuple_New (1));
+	if (!args)
+		return nullptr;
+
+	PyTuple_SetItem (args.borrow (), 0, PyBool_FromLong (true));
+
+	return Clone (self_, args.borrow (), nullptr);
+}
+
+PyObject *Arena::AddCar (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
 	static char teamKwd[]   = "team";
 	static char configKwd[] = "config";
 
@@ -1994,17 +2777,13 @@ PyObject *Arena::GetBallPrediction (Arena *self_, PyObject *args_, PyObject *kwd
 
 	try
 	{
-		if (self_->ballPrediction->predData.capacity () < numTicks)
-			self_->ballPrediction->predData.reserve (numTicks);
-
 		self_->ballPrediction->numPredTicks = numTicks;
 
 		self_->ballPrediction->UpdatePredFromArena (self_->arena.get ());
 
-		auto pred = std::begin (self_->ballPrediction->predData);
-		for (unsigned i = 0; i < numStates; ++i, std::advance (pred, tickInterval))
+		for (unsigned i = 0; i < numStates; ++i)
 		{
-			auto state = BallState::NewFromBallState (*pred);
+			auto state = BallState::NewFromBallState (self_->ballPrediction->GetPredState (i * tickInterval));
 			if (!state)
 				return nullptr;
 
@@ -2053,29 +2832,12 @@ PyObject *Arena::GetGymState (Arena *self_) noexcept
 	if (!tuple)
 		return nullptr;
 
-	std::uint64_t ballLastCarHitTick = 0;
-	std::uint32_t ballLastCarHitId   = 0;
-	for (auto const &[id, car] : *self_->cars)
-	{
-		if (!car->car->_internalState.ballHitInfo.isValid)
-			continue;
-
-		if (car->car->_internalState.ballHitInfo.tickCountWhenHit <= ballLastCarHitTick)
-			continue;
-
-		ballLastCarHitTick = car->car->_internalState.ballHitInfo.tickCountWhenHit;
-		ballLastCarHitId   = car->car->id;
-	}
-
 	{
-		auto gameData = PyArrayRef (4);
+		auto gameData = PyArrayRef (GYM_GAME_DATA_SIZE);
 		if (!gameData)
 			return nullptr;
 
-		gameData (0) = static_cast<int> (self_->arena->gameMode);
-		gameData (1) = ballLastCarHitId;
-		gameData (2) = self_->blueScore;
-		gameData (3) = self_->orangeScore;
+		assignGameData (gameData, self_);
 
 		PyTuple_SetItem (tuple.borrow (), 0, gameData.giftObject ());
 	}
@@ -2097,16 +2859,7 @@ PyObject *Arena::GetGymState (Arena *self_) noexcept
 		if (!boostPadState)
 			return nullptr;
 
-		for (unsigned idx = 0; idx < numBoostPads; ++idx)
-		{
-			auto const pad = self_->boostPadsByIndex->operator[] (idx)->pad;
-			assert (pad);
-
-			auto const inv = numBoostPads - idx - 1;
-
-			boostPadState (0, idx) = pad->_internalState.isActive;
-			boostPadState (1, inv) = pad->_internalState.isActive;
-		}
+		assignBoostPads (boostPadState, self_);
 
 		PyTuple_SetItem (tuple.borrow (), 1, boostPadState.giftObject ());
 	}
@@ -2114,7 +2867,7 @@ PyObject *Arena::GetGymState (Arena *self_) noexcept
 		assert (self_->arena->GetBoostPads ().empty ());
 
 	{
-		auto ballState = PyArrayRef (2, 25);
+		auto ballState = PyArrayRef (2, GYM_BALL_SIZE);
 		if (!ballState)
 			return nullptr;
 
@@ -2123,8 +2876,7 @@ PyObject *Arena::GetGymState (Arena *self_) noexcept
 		assign (ballState, 0, ball->_rigidBody);
 		if (ballState.isnan ())
 		{
-			PyErr_SetString (PyExc_RuntimeError, R"(!!DETECTED NaN VALUE IN BALL DATA!!
-DID YOU STATE SET MULTIPLE OBJECTS IN THE SAME LOCATION?)");
+			PyErr_SetString (PyExc_RuntimeError, BALL_NAN_ERROR);
 			return nullptr;
 		}
 
@@ -2134,35 +2886,14 @@ DID YOU STATE SET MULTIPLE OBJECTS IN THE SAME LOCATION?)");
 	unsigned carIndex = 0;
 	for (auto const &[id, car] : *self_->cars)
 	{
-		auto carState = PyArrayRef (2, 36);
+		auto carState = PyArrayRef (2, GYM_CAR_SIZE);
 		if (!carState)
 			return nullptr;
 
-		auto const &state = car->car->_internalState;
-
-		auto const hitLastStep =
-		    state.ballHitInfo.isValid && state.ballHitInfo.tickCountWhenHit >= self_->lastGymStateTick;
-
-		for (unsigned i = 0; i < 2; ++i)
-		{
-			carState (i, 0)  = car->car->id;
-			carState (i, 1)  = static_cast<int> (car->car->team);
-			carState (i, 2)  = car->goals;
-			carState (i, 3)  = car->saves;
-			carState (i, 4)  = car->shots;
-			carState (i, 5)  = car->demos;
-			carState (i, 6)  = car->boostPickups;
-			carState (i, 7)  = state.isDemoed;
-			carState (i, 8)  = state.isOnGround;
-			carState (i, 9)  = hitLastStep;
-			carState (i, 10) = state.boost;
-		}
-
-		assign (carState, 11, car->car->_rigidBody, state.isDemoed ? &car->demoState : nullptr);
+		assignCar (carState, self_, car.borrow ());
 		if (carState.isnan ())
 		{
-			PyErr_SetString (PyExc_RuntimeError, R"(!!DETECTED NaN VALUE IN CAR DATA!!
-DID YOU STATE SET MULTIPLE OBJECTS IN THE SAME LOCATION?)");
+			PyErr_SetString (PyExc_RuntimeError, CAR_NAN_ERROR);
 			return nullptr;
 		}
 
@@ -2175,6 +2906,52 @@ DID YOU STATE SET MULTIPLE OBJECTS IN THE SAME LOCATION?)");
 	return tuple.giftObject ();
 }
 
+PyObject *Arena::GetGymStateSize (Arena *self_) noexcept
+{
+	if (!prepareGymState (self_))
+		return nullptr;
+
+	return PyLong_FromSize_t (gymStateSize (self_));
+}
+
+PyObject *Arena::WriteGymState (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char outKwd[]    = "out";
+	static char offsetKwd[] = "offset";
+
+	static char *dict[] = {outKwd, offsetKwd, nullptr};
+
+	PyObject *out     = nullptr; // borrowed reference
+	Py_ssize_t offset = 0;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "O|n", dict, &out, &offset))
+		return nullptr;
+
+	std::size_t outSize;
+	auto const data = PyArrayFloatData (out, outSize);
+	if (!data)
+		return nullptr;
+
+	if (!prepareGymState (self_))
+		return nullptr;
+
+	auto const size = gymStateSize (self_);
+	if (offset < 0 || static_cast<std::size_t> (offset) > outSize || outSize - offset < size)
+		return PyErr_Format (PyExc_ValueError, "Output array too small (need %zu floats at offset %zd)", size, offset);
+
+	char const *error;
+	Py_BEGIN_ALLOW_THREADS;
+	error = writeGymState (self_, data + offset);
+	Py_END_ALLOW_THREADS;
+
+	if (error)
+	{
+		PyErr_SetString (PyExc_RuntimeError, error);
+		return nullptr;
+	}
+
+	return PyLong_FromSize_t (size);
+}
+
 PyObject *Arena::GetMutatorConfig (Arena *self_) noexcept
 {
 	auto config = MutatorConfig::NewFromMutatorConfig (self_->arena->GetMutatorConfig ());
@@ -2243,6 +3020,29 @@ PyObject *Arena::IsBallProbablyGoingIn (Arena *self_, PyObject *args_, PyObject
 	return PyBool_FromLong (self_->arena->IsBallProbablyGoingIn (maxTime));
 }
 
+PyObject *Arena::Reset (Arena *self_) noexcept
+{
+	// detach cars from arena
+	for (auto &[id, car] : *self_->cars)
+	{
+		car->car = nullptr;
+		car->arena.reset ();
+	}
+	self_->cars->clear ();
+
+	self_->arena->Reset ();
+
+	if (self_->gameEvent)
+		self_->gameEvent->ResetPersistentInfo ();
+
+	self_->blueScore        = 0;
+	self_->orangeScore      = 0;
+	self_->lastGoalTick     = 0;
+	self_->lastGymStateTick = 0;
+
+	Py_RETURN_NONE;
+}
+
 PyObject *Arena::ResetKickoff (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept
 {
 	static char seedKwd[] = "seed";
@@ -2258,35 +3058,156 @@ PyObject *Arena::ResetKickoff (Arena *self_, PyObject *args_, PyObject *kwds_) n
 	Py_RETURN_NONE;
 }
 
-PyObject *Arena::SetBallTouchCallback (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept
+PyObject *Arena::RestoreSnapshot (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept
 {
-	static char callbackKwd[] = "callback";
-	static char dataKwd[]     = "data";
+	static char snapshotKwd[] = "snapshot";
 
-	static char *dict[] = {callbackKwd, dataKwd, nullptr};
+	static char *dict[] = {snapshotKwd, nullptr};
 
-	PyObject *callback; // borrowed references
-	PyObject *userData = Py_None;
-	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "O|O", dict, &callback, &userData))
+	ArenaSnapshot *snapshot;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "O!", dict, ArenaSnapshot::Type, &snapshot))
 		return nullptr;
 
-	if (callback == Py_None)
-		self_->arena->SetBallTouchCallback (nullptr, nullptr);
-	else if (PyCallable_Check (callback))
-		self_->arena->SetBallTouchCallback (&Arena::HandleBallTouchCallback, self_);
-	else
+	auto const &carStats = *snapshot->carStats;
+	if (carStats.size () != self_->cars->size ())
 	{
-		PyErr_SetString (PyExc_RuntimeError, "First parameter must be a callable object or None");
+		PyErr_SetString (PyExc_ValueError, "Car list mismatch");
 		return nullptr;
 	}
 
-	auto prev = PyObjectRef::steal (PyTuple_Pack (2, callback, userData));
-	if (!prev)
-		return nullptr;
-
-	PyObjectRef::assign (self_->ballTouchCallback, PyTuple_GetItem (prev.borrow (), 0));
-	PyObjectRef::assign (self_->ballTouchCallbackUserData, PyTuple_GetItem (prev.borrow (), 1));
-
+	auto it = std::begin (carStats);
+	for (auto const &[id, car] : *self_->cars)
+	{
+		if ((it++)->id != id)
+		{
+			PyErr_SetString (PyExc_ValueError, "Car id mismatch");
+			return nullptr;
+		}
+	}
+
+	try
+	{
+		self_->arena->RestoreSnapshot (*snapshot->snapshot);
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_ValueError, err.what ());
+		return nullptr;
+	}
+
+	it = std::begin (carStats);
+	for (auto &[id, car] : *self_->cars)
+	{
+		auto const &stats = *it++;
+
+		car->demoState    = stats.demoState;
+		car->goals        = stats.goals;
+		car->demos        = stats.demos;
+		car->boostPickups = stats.boostPickups;
+		car->shots        = stats.shots;
+		car->saves        = stats.saves;
+		car->assists      = stats.assists;
+	}
+
+	self_->blueScore        = snapshot->blueScore;
+	self_->orangeScore      = snapshot->orangeScore;
+	self_->lastGoalTick     = snapshot->lastGoalTick;
+	self_->lastGymStateTick = snapshot->lastGymStateTick;
+
+	Py_RETURN_NONE;
+}
+
+PyObject *Arena::SaveSnapshot (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char snapshotKwd[] = "snapshot";
+
+	static char *dict[] = {snapshotKwd, nullptr};
+
+	PyObject *snapshotObj = nullptr; // borrowed reference
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "|O", dict, &snapshotObj))
+		return nullptr;
+
+	PyRef<ArenaSnapshot> snapshot;
+	if (!snapshotObj || snapshotObj == Py_None)
+	{
+		snapshot = PyRef<ArenaSnapshot>::stealObject (ArenaSnapshot::New (ArenaSnapshot::Type, nullptr, nullptr));
+		if (!snapshot)
+			return nullptr;
+	}
+	else if (PyObject_TypeCheck (snapshotObj, ArenaSnapshot::Type))
+	{
+		snapshot = PyRef<ArenaSnapshot>::incObjectRef (snapshotObj);
+	}
+	else
+	{
+		PyErr_SetString (PyExc_TypeError, "Expected a RocketSim.ArenaSnapshot");
+		return nullptr;
+	}
+
+	try
+	{
+		self_->arena->SaveSnapshot (*snapshot->snapshot);
+
+		auto &carStats = *snapshot->carStats;
+		carStats.resize (self_->cars->size ());
+
+		auto it = std::begin (carStats);
+		for (auto const &[id, car] : *self_->cars)
+		{
+			auto &stats = *it++;
+
+			stats.id           = id;
+			stats.demoState    = car->demoState;
+			stats.goals        = car->goals;
+			stats.demos        = car->demos;
+			stats.boostPickups = car->boostPickups;
+			stats.shots        = car->shots;
+			stats.saves        = car->saves;
+			stats.assists      = car->assists;
+		}
+	}
+	catch (...)
+	{
+		return PyErr_NoMemory ();
+	}
+
+	snapshot->blueScore        = self_->blueScore;
+	snapshot->orangeScore      = self_->orangeScore;
+	snapshot->lastGoalTick     = self_->lastGoalTick;
+	snapshot->lastGymStateTick = self_->lastGymStateTick;
+
+	return snapshot.giftObject ();
+}
+
+PyObject *Arena::SetBallTouchCallback (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char callbackKwd[] = "callback";
+	static char dataKwd[]     = "data";
+
+	static char *dict[] = {callbackKwd, dataKwd, nullptr};
+
+	PyObject *callback; // borrowed references
+	PyObject *userData = Py_None;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "O|O", dict, &callback, &userData))
+		return nullptr;
+
+	if (callback == Py_None)
+		self_->arena->SetBallTouchCallback (nullptr, nullptr);
+	else if (PyCallable_Check (callback))
+		self_->arena->SetBallTouchCallback (&Arena::HandleBallTouchCallback, self_);
+	else
+	{
+		PyErr_SetString (PyExc_RuntimeError, "First parameter must be a callable object or None");
+		return nullptr;
+	}
+
+	auto prev = PyObjectRef::steal (PyTuple_Pack (2, callback, userData));
+	if (!prev)
+		return nullptr;
+
+	PyObjectRef::assign (self_->ballTouchCallback, PyTuple_GetItem (prev.borrow (), 0));
+	PyObjectRef::assign (self_->ballTouchCallbackUserData, PyTuple_GetItem (prev.borrow (), 1));
+
 	return prev.giftObject ();
 }
 
@@ -2600,29 +3521,293 @@ PyObject *Arena::Stop (Arena *self_) noexcept
 	Py_RETURN_NONE;
 }
 
+namespace
+{
+// Gathers a sequence of arenas in sequence order, rejecting duplicates
+// If given, the arenas keep the thread pool their job is for alive
+bool collectArenas (PyObject *arenas_,
+    std::shared_ptr<Arena::ThreadPool> const &pool_,
+    std::set<PyRef<Arena>> &refs_,
+    std::vector<Arena *> &order_) noexcept
+{
+	if (!PySequence_Check (arenas_))
+	{
+		PyErr_SetString (PyExc_TypeError, "arenas type must be a sequence");
+		return false;
+	}
+
+	auto const count = PySequence_Size (arenas_);
+	if (count < 0)
+		return false;
+
+	try
+	{
+		order_.reserve (count);
+
+		for (Py_ssize_t i = 0; i < count; ++i)
+		{
+			auto obj = PyObjectRef::steal (PySequence_GetItem (arenas_, i));
+			if (!obj)
+				return false;
+
+			if (!Py_IS_TYPE (obj.borrow (), Arena::Type))
+			{
+				PyErr_SetString (PyExc_RuntimeError, "Unexpected type");
+				return false;
+			}
+
+			auto arena = PyRef<Arena>::incObjectRef (obj.borrow ());
+			if (!refs_.insert (arena).second)
+			{
+				PyErr_SetString (PyExc_RuntimeError, "Duplicate arena detected");
+				return false;
+			}
+
+			if (pool_)
+				arena->threadPool = pool_;
+			order_.emplace_back (arena.borrow ());
+		}
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return false;
+	}
+
+	return true;
+}
+
+// Computes the first car row of each arena's cars, in sequence order
+bool carOffsets (std::vector<Arena *> const &order_, std::vector<std::size_t> &offsets_, std::size_t &numCars_) noexcept
+{
+	try
+	{
+		offsets_.resize (order_.size ());
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return false;
+	}
+
+	numCars_ = 0;
+	for (std::size_t i = 0; i < order_.size (); ++i)
+	{
+		offsets_[i] = numCars_;
+		numCars_ += order_[i]->cars->size ();
+	}
+
+	return true;
+}
+
+// Re-raises the first exception saved by a callback during a step, discarding the rest
+bool restoreStepExceptions (std::set<PyRef<Arena>> const &arenas_) noexcept
+{
+	auto raised = false;
+	for (auto &arena : arenas_)
+	{
+		if (arena->stepExceptionType)
+		{
+			restoreException (arena.borrow ());
+			raised = true;
+			break;
+		}
+	}
+
+	if (!raised)
+		return false;
+
+	for (auto &arena : arenas_)
+		discardException (arena.borrow ());
+
+	return true;
+}
+}
+
 PyObject *Arena::MultiStep (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char arenasKwd[]   = "arenas";
+	static char ticksKwd[]    = "ticks";
+	static char controlsKwd[] = "controls";
+
+	static char *dict[] = {arenasKwd, ticksKwd, controlsKwd, nullptr};
+
+	PyObject *arenas    = nullptr; // borrowed references
+	int ticksToSimulate = 1;
+	PyObject *controls  = Py_None;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "O|iO", dict, &arenas, &ticksToSimulate, &controls))
+		return nullptr;
+
+	float const *controlsData = nullptr;
+	std::size_t controlsSize  = 0;
+	if (controls != Py_None)
+	{
+		controlsData = PyArrayConstFloatData (controls, controlsSize);
+		if (!controlsData)
+			return nullptr;
+	}
+
+	auto pool = Arena::ThreadPool::GetInstance ();
+	if (!pool)
+	{
+		PyErr_SetString (PyExc_RuntimeError, "Failed to create thread pool");
+		return nullptr;
+	}
+
+	std::set<PyRef<Arena>> jobs;
+	std::vector<Arena *> order;
+	if (!collectArenas (arenas, pool, jobs, order))
+		return nullptr;
+
+	if (order.empty ())
+		Py_RETURN_NONE;
+
+	// first control row of each arena's cars
+	std::vector<std::size_t> controlsOffsets;
+	if (controlsData)
+	{
+		std::size_t numCars;
+		if (!carOffsets (order, controlsOffsets, numCars))
+			return nullptr;
+
+		if (!PyArrayHasShape (controls, {static_cast<npy_intp> (numCars), CONTROLS_SIZE}))
+			return PyErr_Format (PyExc_ValueError,
+			    "controls must have shape (%zu, %u) for the cars of these arenas",
+			    numCars,
+			    CONTROLS_SIZE);
+	}
+
+	struct StepContext
+	{
+		Arena *const *arenas;
+		int ticks;
+		float const *controls;
+		std::size_t const *controlsOffsets;
+	} context{order.data (), ticksToSimulate, controlsData, controlsOffsets.data ()};
+
+	bool ok;
+	Py_BEGIN_ALLOW_THREADS;
+	ok = pool->SubmitJob (order,
+	    [] (void *context_, std::size_t index_) {
+		    auto const &context = *static_cast<StepContext *> (context_);
+		    auto const arena    = context.arenas[index_];
+
+		    if (context.controls)
+		    {
+			    auto row = context.controls + context.controlsOffsets[index_] * CONTROLS_SIZE;
+			    for (auto const &[id, car] : *arena->cars)
+			    {
+				    car->car->controls = toCarControls (row);
+				    row += CONTROLS_SIZE;
+			    }
+		    }
+
+		    arena->arena->Step (context.ticks);
+
+		    if (arena->gameEvent)
+			    arena->gameEvent->Update (arena->arena.get ());
+	    },
+	    &context);
+	Py_END_ALLOW_THREADS;
+
+	if (!ok || restoreStepExceptions (jobs))
+		return nullptr;
+
+	Py_RETURN_NONE;
+}
+
+PyObject *Arena::VecStep (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept
 {
 	static char arenasKwd[] = "arenas";
 	static char ticksKwd[]  = "ticks";
 
 	static char *dict[] = {arenasKwd, ticksKwd, nullptr};
 
-	PyObject *arenas    = nullptr;
+	PyObject *arenas    = nullptr; // borrowed references
 	int ticksToSimulate = 1;
 	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "O|i", dict, &arenas, &ticksToSimulate))
 		return nullptr;
 
-	if (!PySequence_Check (arenas))
+	std::set<PyRef<Arena>> refs;
+	std::vector<Arena *> order;
+	if (!collectArenas (arenas, nullptr, refs, order))
+		return nullptr;
+
+	if (order.empty ())
+		Py_RETURN_NONE;
+
+	std::unique_ptr<RocketSim::VecArena> vecArena;
+	try
 	{
-		PyErr_SetString (PyExc_TypeError, "arenas type must be a sequence");
+		std::vector<RocketSim::Arena *> simArenas;
+		simArenas.reserve (order.size ());
+		for (auto const &arena : order)
+			simArenas.emplace_back (arena->arena.get ());
+
+		vecArena.reset (RocketSim::VecArena::Create (simArenas));
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
 		return nullptr;
 	}
 
-	auto const count = PySequence_Size (arenas);
-	if (count == 0)
-		Py_RETURN_NONE;
+	Py_BEGIN_ALLOW_THREADS;
+	vecArena->Step (ticksToSimulate);
+	Py_END_ALLOW_THREADS;
 
-	std::set<PyRef<Arena>> jobs;
+	for (auto const &arena : order)
+	{
+		if (arena->gameEvent)
+			arena->gameEvent->Update (arena->arena.get ());
+	}
+
+	if (restoreStepExceptions (refs))
+		return nullptr;
+
+	Py_RETURN_NONE;
+}
+
+PyObject *Arena::MultiStepExport (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char arenasKwd[]   = "arenas";
+	static char ticksKwd[]    = "ticks";
+	static char controlsKwd[] = "controls";
+	static char obsKwd[]      = "obs";
+	static char eventsKwd[]   = "events";
+	static char donesKwd[]    = "dones";
+
+	static char *dict[] = {arenasKwd, ticksKwd, controlsKwd, obsKwd, eventsKwd, donesKwd, nullptr};
+
+	PyObject *arenas    = nullptr; // borrowed references
+	int ticksToSimulate = 1;
+	PyObject *controls  = Py_None;
+	PyObject *obs       = Py_None;
+	PyObject *events    = Py_None;
+	PyObject *dones     = Py_None;
+	if (!PyArg_ParseTupleAndKeywords (
+	        args_, kwds_, "O|iOOOO", dict, &arenas, &ticksToSimulate, &controls, &obs, &events, &dones))
+		return nullptr;
+
+	float const *controlsData = nullptr;
+	std::size_t controlsSize  = 0;
+	if (controls != Py_None && !(controlsData = PyArrayConstFloatData (controls, controlsSize)))
+		return nullptr;
+
+	float *obsData      = nullptr;
+	std::size_t obsSize = 0;
+	if (obs != Py_None && !(obsData = PyArrayFloatData (obs, obsSize)))
+		return nullptr;
+
+	float *eventsData      = nullptr;
+	std::size_t eventsSize = 0;
+	if (events != Py_None && !(eventsData = PyArrayFloatData (events, eventsSize)))
+		return nullptr;
+
+	float *donesData      = nullptr;
+	std::size_t donesSize = 0;
+	if (dones != Py_None && !(donesData = PyArrayFloatData (dones, donesSize)))
+		return nullptr;
 
 	auto pool = Arena::ThreadPool::GetInstance ();
 	if (!pool)
@@ -2631,29 +3816,177 @@ PyObject *Arena::MultiStep (PyObject *dummy_, PyObject *args_, PyObject *kwds_)
 		return nullptr;
 	}
 
-	try
+	std::set<PyRef<Arena>> jobs;
+	std::vector<Arena *> order;
+	if (!collectArenas (arenas, pool, jobs, order))
+		return nullptr;
+
+	if (order.empty ())
+		Py_RETURN_NONE;
+
+	std::vector<std::size_t> carRows;
+	std::size_t numCars;
+	if (!carOffsets (order, carRows, numCars))
+		return nullptr;
+
+	if (controlsData && !PyArrayHasShape (controls, {static_cast<npy_intp> (numCars), CONTROLS_SIZE}))
+		return PyErr_Format (PyExc_ValueError,
+		    "controls must have shape (%zu, %u) for the cars of these arenas",
+		    numCars,
+		    CONTROLS_SIZE);
+
+	if (eventsData && !PyArrayHasShape (events, {static_cast<npy_intp> (numCars), EVENTS_SIZE}))
+		return PyErr_Format (PyExc_ValueError,
+		    "events must have shape (%zu, %u) for the cars of these arenas",
+		    numCars,
+		    EVENTS_SIZE);
+
+	if (donesData && !PyArrayHasShape (dones, {static_cast<npy_intp> (order.size ())}))
+		return PyErr_Format (PyExc_ValueError, "dones must have shape (%zu,) for these arenas", order.size ());
+
+	// arenas' gym states are written back to back, in sequence order
+	std::vector<std::size_t> obsOffsets;
+	if (obsData)
 	{
-		for (unsigned i = 0; i < count; ++i)
+		try
 		{
-			auto obj = PySequence_GetItem (arenas, i);
-			if (!obj)
-				return nullptr;
-
-			if (!Py_IS_TYPE (obj, Arena::Type))
-			{
-				PyErr_SetString (PyExc_RuntimeError, "Unexpected type");
-				return nullptr;
-			}
+			obsOffsets.resize (order.size ());
+		}
+		catch (std::exception const &err)
+		{
+			PyErr_SetString (PyExc_RuntimeError, err.what ());
+			return nullptr;
+		}
 
-			auto arena = PyRef<Arena>::incObjectRef (obj);
-			if (!jobs.insert (arena).second)
-			{
-				PyErr_SetString (PyExc_RuntimeError, "Duplicate arena detected");
+		std::size_t size = 0;
+		for (std::size_t i = 0; i < order.size (); ++i)
+		{
+			if (!prepareGymState (order[i]))
 				return nullptr;
-			}
 
-			arena->threadPool = pool;
+			obsOffsets[i] = size;
+			size += gymStateSize (order[i]);
 		}
+
+		if (obsSize < size)
+			return PyErr_Format (PyExc_ValueError, "obs array too small (need %zu floats)", size);
+	}
+
+	struct StepExportContext
+	{
+		Arena *const *arenas;
+		int ticks;
+		std::size_t const *carRows;
+		float const *controls;
+		std::size_t const *obsOffsets;
+		float *obs;
+		float *events;
+		float *dones;
+		std::atomic<char const *> error;
+	} context{order.data (),
+	    ticksToSimulate,
+	    carRows.data (),
+	    controlsData,
+	    obsOffsets.data (),
+	    obsData,
+	    eventsData,
+	    donesData,
+	    nullptr};
+
+	bool ok;
+	Py_BEGIN_ALLOW_THREADS;
+	ok = pool->SubmitJob (order,
+	    [] (void *context_, std::size_t index_) {
+		    auto &context    = *static_cast<StepExportContext *> (context_);
+		    auto const arena = context.arenas[index_];
+		    auto const row   = context.carRows[index_];
+
+		    // per-thread scratch, reused across calls
+		    thread_local std::vector<RocketSim::CarControls> controls;
+		    thread_local std::vector<RocketSim::CarEventCounts> events;
+
+		    if (context.controls)
+		    {
+			    controls.resize (arena->cars->size ());
+			    for (std::size_t i = 0; i < controls.size (); ++i)
+				    controls[i] = toCarControls (context.controls + (row + i) * CONTROLS_SIZE);
+		    }
+
+		    events.resize (arena->cars->size ());
+
+		    auto const result = arena->arena->StepAndExport (context.ticks,
+		        context.controls ? controls.data () : nullptr,
+		        nullptr,
+		        events.data (),
+		        nullptr);
+
+		    if (arena->gameEvent)
+			    arena->gameEvent->Update (arena->arena.get ());
+
+		    if (context.events)
+		    {
+			    for (std::size_t i = 0; i < events.size (); ++i)
+				    assignEvents (context.events + (row + i) * EVENTS_SIZE, events[i]);
+		    }
+
+		    if (context.dones)
+			    context.dones[index_] = result.goalScored ? 1.0f : 0.0f;
+
+		    if (context.obs)
+		    {
+			    char const *expected = nullptr;
+			    if (auto const error = writeGymState (arena, context.obs + context.obsOffsets[index_]))
+				    context.error.compare_exchange_strong (expected, error);
+		    }
+	    },
+	    &context);
+	Py_END_ALLOW_THREADS;
+
+	if (!ok || restoreStepExceptions (jobs))
+		return nullptr;
+
+	if (auto const error = context.error.load ())
+	{
+		PyErr_SetString (PyExc_RuntimeError, error);
+		return nullptr;
+	}
+
+	Py_RETURN_NONE;
+}
+
+PyObject *Arena::MultiWriteGymState (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char arenasKwd[] = "arenas";
+	static char outKwd[]    = "out";
+
+	static char *dict[] = {arenasKwd, outKwd, nullptr};
+
+	PyObject *arenas = nullptr; // borrowed references
+	PyObject *out    = nullptr;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "OO", dict, &arenas, &out))
+		return nullptr;
+
+	std::size_t outSize;
+	auto const data = PyArrayFloatData (out, outSize);
+	if (!data)
+		return nullptr;
+
+	auto pool = Arena::ThreadPool::GetInstance ();
+	if (!pool)
+	{
+		PyErr_SetString (PyExc_RuntimeError, "Failed to create thread pool");
+		return nullptr;
+	}
+
+	std::set<PyRef<Arena>> jobs;
+	std::vector<Arena *> order;
+	std::vector<std::size_t> offsets;
+	if (!collectArenas (arenas, pool, jobs, order))
+		return nullptr;
+
+	try
+	{
+		offsets.resize (order.size ());
 	}
 	catch (std::exception const &err)
 	{
@@ -2661,32 +3994,263 @@ PyObject *Arena::MultiStep (PyObject *dummy_, PyObject *args_, PyObject *kwds_)
 		return nullptr;
 	}
 
+	// arenas are written back to back, in sequence order
+	std::size_t size = 0;
+	for (std::size_t i = 0; i < order.size (); ++i)
+	{
+		if (!prepareGymState (order[i]))
+			return nullptr;
+
+		offsets[i] = size;
+		size += gymStateSize (order[i]);
+	}
+
+	if (outSize < size)
+		return PyErr_Format (PyExc_ValueError, "Output array too small (need %zu floats)", size);
+
+	struct WriteContext
+	{
+		Arena *const *arenas;
+		std::size_t const *offsets;
+		float *out;
+		std::atomic<char const *> error;
+	} context{order.data (), offsets.data (), data, nullptr};
+
 	bool ok;
 	Py_BEGIN_ALLOW_THREADS;
-	ok = pool->SubmitJob (jobs, ticksToSimulate);
+	ok = pool->SubmitJob (order,
+	    [] (void *context_, std::size_t index_) {
+		    auto &context    = *static_cast<WriteContext *> (context_);
+		    auto const error = writeGymState (context.arenas[index_], context.out + context.offsets[index_]);
+
+		    char const *expected = nullptr;
+		    if (error)
+			    context.error.compare_exchange_strong (expected, error);
+	    },
+	    &context);
 	Py_END_ALLOW_THREADS;
 
 	if (!ok)
 		return nullptr;
 
-	auto raised = false;
-	for (auto &arena : jobs)
+	if (auto const error = context.error.load ())
 	{
-		if (arena->stepExceptionType)
-		{
-			restoreException (arena.borrow ());
-			raised = true;
-			break;
-		}
+		PyErr_SetString (PyExc_RuntimeError, error);
+		return nullptr;
 	}
 
-	if (!raised)
+	return PyLong_FromSize_t (size);
+}
+
+PyObject *Arena::PredictBalls (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char statesKwd[]       = "states";
+	static char numTicksKwd[]     = "num_ticks";
+	static char tickIntervalKwd[] = "tick_interval";
+	static char outKwd[]          = "out";
+	static char gameModeKwd[]     = "game_mode";
+	static char tickRateKwd[]     = "tick_rate";
+
+	static char *dict[] = {statesKwd, numTicksKwd, tickIntervalKwd, outKwd, gameModeKwd, tickRateKwd, nullptr};
+
+	PyObject *states          = nullptr; // borrowed references
+	unsigned int numTicks     = 0;
+	unsigned int tickInterval = 1;
+	PyObject *out             = nullptr;
+	int gameMode              = static_cast<int> (RocketSim::GameMode::SOCCAR);
+	float tickRate            = 120.0f;
+	if (!PyArg_ParseTupleAndKeywords (
+	        args_, kwds_, "OIIO|if", dict, &states, &numTicks, &tickInterval, &out, &gameMode, &tickRate))
+		return nullptr;
+
+	std::size_t statesSize;
+	auto const statesData = PyArrayConstFloatData (states, statesSize);
+	if (!statesData)
+		return nullptr;
+
+	std::size_t outSize;
+	auto const outData = PyArrayFloatData (out, outSize);
+	if (!outData)
+		return nullptr;
+
+	auto const statesArray = reinterpret_cast<PyArrayObject *> (states);
+	if (PyArray_NDIM (statesArray) != 2 ||
+	    (PyArray_DIM (statesArray, 1) != BALL_PRED_SIZE && PyArray_DIM (statesArray, 1) != BALL_PRED_ROT_SIZE))
+		return PyErr_Format (
+		    PyExc_ValueError, "states must have shape (N, %u) or (N, %u)", BALL_PRED_SIZE, BALL_PRED_ROT_SIZE);
+
+	auto const numStates = static_cast<std::size_t> (PyArray_DIM (statesArray, 0));
+	auto const cols      = static_cast<unsigned> (PyArray_DIM (statesArray, 1));
+
+	auto const outArray = reinterpret_cast<PyArrayObject *> (out);
+	if (PyArray_NDIM (outArray) != 3 || static_cast<std::size_t> (PyArray_DIM (outArray, 0)) != numStates ||
+	    PyArray_DIM (outArray, 1) != numTicks || PyArray_DIM (outArray, 2) != cols)
+		return PyErr_Format (PyExc_ValueError, "out must have shape (%zu, %u, %u)", numStates, numTicks, cols);
+
+	if (tickInterval == 0)
+	{
+		PyErr_SetString (PyExc_ValueError, "tick_interval must be positive");
+		return nullptr;
+	}
+
+	switch (static_cast<RocketSim::GameMode> (gameMode))
+	{
+	case RocketSim::GameMode::SOCCAR:
+	case RocketSim::GameMode::HOOPS:
+	case RocketSim::GameMode::SNOWDAY:
+	case RocketSim::GameMode::HEATSEEKER:
+	case RocketSim::GameMode::THE_VOID:
+		break;
+
+	default:
+		return PyErr_Format (PyExc_ValueError, "Invalid game mode '%d'", gameMode);
+	}
+
+	if (tickRate < 15.0f || tickRate > 120.0f)
+		return PyErr_Format (PyExc_RuntimeError, "Invalid tick rate '%f'", tickRate);
+
+	try
+	{
+		// default initialization if it hasn't been done yet
+		InitInternal (nullptr);
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return nullptr;
+	}
+
+	if (numStates == 0 || numTicks == 0)
 		Py_RETURN_NONE;
 
-	for (auto &arena : jobs)
-		discardException (arena.borrow ());
+	auto pool = Arena::ThreadPool::GetInstance ();
+	if (!pool)
+	{
+		PyErr_SetString (PyExc_RuntimeError, "Failed to create thread pool");
+		return nullptr;
+	}
 
-	return nullptr;
+	struct PredictContext
+	{
+		float const *states;
+		float *out;
+		unsigned cols;
+		unsigned numTicks;
+		unsigned tickInterval;
+		RocketSim::GameMode gameMode;
+		float tickRate;
+	} context{statesData,
+	    outData,
+	    cols,
+	    numTicks,
+	    tickInterval,
+	    static_cast<RocketSim::GameMode> (gameMode),
+	    tickRate};
+
+	bool ok;
+	Py_BEGIN_ALLOW_THREADS;
+	ok = pool->SubmitJob (numStates,
+	    [] (void *context_, std::size_t index_) {
+		    auto const &context = *static_cast<PredictContext *> (context_);
+
+		    // per-thread simulator, reused across calls with the same game mode
+		    thread_local std::unique_ptr<RocketSim::BallPredSim> sim;
+		    if (!sim || sim->gameMode != context.gameMode)
+			    sim.reset (RocketSim::BallPredSim::Create (context.gameMode));
+
+		    sim->tickTime = 1.0f / context.tickRate;
+
+		    auto row = context.out + index_ * context.numTicks * context.cols;
+
+		    sim->SetBallState (toBallState (context.states + index_ * context.cols, context.cols));
+		    assignBallPred (row, sim->GetBallState (), context.cols);
+
+		    for (unsigned i = 1; i < context.numTicks; ++i)
+		    {
+			    row += context.cols;
+
+			    sim->Step (context.tickInterval);
+			    assignBallPred (row, sim->GetBallState (), context.cols);
+		    }
+	    },
+	    &context);
+	Py_END_ALLOW_THREADS;
+
+	if (!ok)
+		return nullptr;
+
+	Py_RETURN_NONE;
+}
+
+PyObject *Arena::SetThreadPool (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char numThreadsKwd[] = "num_threads";
+	static char affinityKwd[]   = "affinity";
+	static char stickyKwd[]     = "sticky";
+
+	static char *dict[] = {numThreadsKwd, affinityKwd, stickyKwd, nullptr};
+
+	unsigned numThreads = 0;
+	PyObject *affinity  = Py_None;
+	int sticky          = false;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "|IOp", dict, &numThreads, &affinity, &sticky))
+		return nullptr;
+
+	ThreadPool::Config config;
+	config.numThreads = numThreads;
+	config.sticky     = sticky;
+
+	if (affinity != Py_None)
+	{
+		if (!PySequence_Check (affinity))
+		{
+			PyErr_SetString (PyExc_TypeError, "affinity type must be a sequence");
+			return nullptr;
+		}
+
+		auto const count = PySequence_Size (affinity);
+		if (count < 0)
+			return nullptr;
+
+		try
+		{
+			config.affinity.reserve (count);
+		}
+		catch (std::exception const &err)
+		{
+			PyErr_SetString (PyExc_RuntimeError, err.what ());
+			return nullptr;
+		}
+
+		for (Py_ssize_t i = 0; i < count; ++i)
+		{
+			auto const item = PyObjectRef::steal (PySequence_GetItem (affinity, i));
+			if (!item)
+				return nullptr;
+
+			auto const cpu = PyLong_AsUnsignedLong (item.borrow ());
+			if (PyErr_Occurred ())
+				return nullptr;
+
+#if defined(__linux__)
+			if (cpu >= CPU_SETSIZE)
+#elif defined(_WIN32)
+			if (cpu >= sizeof (DWORD_PTR) * 8)
+#else
+			if (cpu > std::numeric_limits<unsigned>::max ())
+#endif
+			{
+				PyErr_Format (PyExc_ValueError, "Invalid cpu '%lu'", cpu);
+				return nullptr;
+			}
+
+			config.affinity.emplace_back (static_cast<unsigned> (cpu));
+		}
+	}
+
+	ThreadPool::Configure (std::move (config));
+
+	Py_RETURN_NONE;
 }
 
 void Arena::HandleBallTouchCallback (RocketSim::Arena *arena_, RocketSim::Car *car_, void *userData_) noexcept
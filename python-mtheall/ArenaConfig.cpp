@@ -292,6 +292,7 @@ int ArenaConfig::Init (ArenaConfig *self_, PyObject *args_, PyObject *kwds_) noe
 	{
 	case RocketSim::ArenaMemWeightMode::LIGHT:
 	case RocketSim::ArenaMemWeightMode::HEAVY:
+	case RocketSim::ArenaMemWeightMode::SHARED:
 		break;
 
 	default:
@@ -475,6 +476,7 @@ int ArenaConfig::Setmemory_weight_mode (ArenaConfig *self_, PyObject *value_, vo
 	{
 	case RocketSim::ArenaMemWeightMode::LIGHT:
 	case RocketSim::ArenaMemWeightMode::HEAVY:
+	case RocketSim::ArenaMemWeightMode::SHARED:
 		self_->config.memWeightMode = static_cast<RocketSim::ArenaMemWeightMode> (mode);
 		return 0;
 
@@ -0,0 +1,162 @@
+#include "Module.h"
+
+namespace RocketSim::Python
+{
+PyTypeObject *ArenaRecorder::Type = nullptr;
+
+PyMethodDef ArenaRecorder::Methods[] = {
+    {.ml_name     = "close",
+        .ml_meth  = (PyCFunction)&ArenaRecorder::Close,
+        .ml_flags = METH_NOARGS,
+        .ml_doc   = R"(close(self)
+Write any remaining ticks and stop recording)"},
+    {.ml_name     = "__enter__",
+        .ml_meth  = (PyCFunction)&ArenaRecorder::Enter,
+        .ml_flags = METH_NOARGS,
+        .ml_doc   = R"(__enter__(self) -> RocketSim.ArenaRecorder)"},
+    {.ml_name     = "__exit__",
+        .ml_meth  = (PyCFunction)&ArenaRecorder::Exit,
+        .ml_flags = METH_VARARGS,
+        .ml_doc   = R"(__exit__(self, exc_type, exc_value, traceback)
+Close the recorder)"},
+    {.ml_name = nullptr, .ml_meth = nullptr, .ml_flags = 0, .ml_doc = nullptr},
+};
+
+PyGetSetDef ArenaRecorder::GetSet[] = {
+    GETONLY_ENTRY (ArenaRecorder, is_open, "Whether still recording"),
+    GETONLY_ENTRY (ArenaRecorder, num_ticks, "Ticks recorded so far"),
+    {.name = nullptr, .get = nullptr, .set = nullptr, .doc = nullptr, .closure = nullptr},
+};
+
+PyType_Slot ArenaRecorder::Slots[] = {
+    {Py_tp_new, (void *)&ArenaRecorder::New},
+    {Py_tp_init, (void *)&ArenaRecorder::Init},
+    {Py_tp_dealloc, (void *)&ArenaRecorder::Dealloc},
+    {Py_tp_methods, &ArenaRecorder::Methods},
+    {Py_tp_getset, &ArenaRecorder::GetSet},
+    {Py_tp_doc, (void *)R"(Arena recorder
+__init__(self, arena: RocketSim.Arena, path: str, chunk_ticks: int = 1024, compress: bool = True)
+Records the arena's state at the end of every tick it simulates to a file, read it back with RocketSim.ArenaRecording
+Cars added to the arena after recording started are not recorded)"},
+    {0, nullptr},
+};
+
+PyType_Spec ArenaRecorder::Spec = {
+    .name      = "RocketSim.ArenaRecorder",
+    .basicsize = sizeof (ArenaRecorder),
+    .itemsize  = 0,
+    .flags     = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HEAPTYPE,
+    .slots     = ArenaRecorder::Slots,
+};
+
+PyObject *ArenaRecorder::New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	auto const tp_alloc = (allocfunc)PyType_GetSlot (subtype_, Py_tp_alloc);
+
+	auto self = PyRef<ArenaRecorder>::stealObject (tp_alloc (subtype_, 0));
+	if (!self)
+		return nullptr;
+
+	self->recorder = nullptr;
+	self->arena    = nullptr;
+
+	return self.giftObject ();
+}
+
+int ArenaRecorder::Init (ArenaRecorder *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char arenaKwd[]      = "arena";
+	static char pathKwd[]       = "path";
+	static char chunkTicksKwd[] = "chunk_ticks";
+	static char compressKwd[]   = "compress";
+
+	static char *dict[] = {arenaKwd, pathKwd, chunkTicksKwd, compressKwd, nullptr};
+
+	PyObject *arena     = nullptr;
+	char const *path    = nullptr;
+	unsigned chunkTicks = RocketSim::ArenaRecorderConfig{}.chunkTicks;
+	int compress        = RocketSim::ArenaRecorderConfig{}.compress;
+
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "O!s|Ip", dict, Arena::Type, &arena, &path, &chunkTicks, &compress))
+		return -1;
+
+	delete self_->recorder;
+	self_->recorder = nullptr;
+
+	RocketSim::ArenaRecorderConfig config;
+	config.chunkTicks = chunkTicks;
+	config.compress   = compress;
+
+	try
+	{
+		self_->recorder = new RocketSim::ArenaRecorder (reinterpret_cast<Arena *> (arena)->arena.get (), path, config);
+	}
+	catch (std::bad_alloc const &err)
+	{
+		PyErr_NoMemory ();
+		return -1;
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return -1;
+	}
+
+	PyRef<PyObject>::assign (self_->arena, arena);
+
+	return 0;
+}
+
+void ArenaRecorder::Dealloc (ArenaRecorder *self_) noexcept
+{
+	// closes the recorder before the arena can go away
+	delete self_->recorder;
+	Py_XDECREF (self_->arena);
+
+	auto const tp_free = (freefunc)PyType_GetSlot (Type, Py_tp_free);
+	tp_free (self_);
+}
+
+PyObject *ArenaRecorder::Close (ArenaRecorder *self_) noexcept
+{
+	if (self_->recorder)
+	{
+		try
+		{
+			self_->recorder->Close ();
+		}
+		catch (std::exception const &err)
+		{
+			PyErr_SetString (PyExc_RuntimeError, err.what ());
+			return nullptr;
+		}
+	}
+
+	Py_CLEAR (self_->arena);
+
+	Py_RETURN_NONE;
+}
+
+PyObject *ArenaRecorder::Enter (ArenaRecorder *self_) noexcept
+{
+	return PyObjectRef::incRef (reinterpret_cast<PyObject *> (self_)).gift ();
+}
+
+PyObject *ArenaRecorder::Exit (ArenaRecorder *self_, PyObject *args_) noexcept
+{
+	return Close (self_);
+}
+
+PyObject *ArenaRecorder::Getis_open (ArenaRecorder *self_, void *) noexcept
+{
+	return PyBool_FromLong (self_->recorder && self_->recorder->IsOpen ());
+}
+
+PyObject *ArenaRecorder::Getnum_ticks (ArenaRecorder *self_, void *) noexcept
+{
+	if (!self_->recorder)
+		return PyLong_FromLong (0);
+
+	return PyLong_FromUnsignedLongLong (self_->recorder->GetNumTicksRecorded ());
+}
+}
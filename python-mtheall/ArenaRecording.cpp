@@ -0,0 +1,327 @@
+#include "Module.h"
+
+#include "Array.h"
+
+namespace
+{
+// Shape of a column over numTicks_ ticks
+std::vector<npy_intp> columnDims (RocketSim::ArenaRecordingColumn const &column_, std::uint64_t const numTicks_)
+{
+	std::vector<npy_intp> dims;
+	dims.emplace_back (numTicks_);
+	for (auto const &dim : column_.shape)
+		dims.emplace_back (dim);
+
+	return dims;
+}
+}
+
+namespace RocketSim::Python
+{
+PyTypeObject *ArenaRecording::Type = nullptr;
+
+PyMethodDef ArenaRecording::Methods[] = {
+    {.ml_name     = "get_chunk",
+        .ml_meth  = (PyCFunction)&ArenaRecording::GetChunk,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc   = R"(get_chunk(self, index: int) -> dict[str, numpy.ndarray]
+Returns every column of a chunk, shaped (ticks, ...)
+Uncompressed recordings give read-only views of the file, without copying)"},
+    {.ml_name     = "get_column",
+        .ml_meth  = (PyCFunction)&ArenaRecording::GetColumn,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc   = R"(get_column(self, name: str) -> numpy.ndarray
+Returns a column of every chunk, shaped (num_ticks, ...)
+Only a view of the file if the recording is uncompressed and has a single chunk, otherwise a copy)"},
+    {.ml_name = nullptr, .ml_meth = nullptr, .ml_flags = 0, .ml_doc = nullptr},
+};
+
+PyGetSetDef ArenaRecording::GetSet[] = {
+    GETONLY_ENTRY (ArenaRecording, game_mode, "Game mode"),
+    GETONLY_ENTRY (ArenaRecording, tick_rate, "Tick rate"),
+    GETONLY_ENTRY (ArenaRecording, compressed, "Whether the columns are compressed"),
+    GETONLY_ENTRY (ArenaRecording, car_ids, "IDs of the recorded cars, in the order of the car columns"),
+    GETONLY_ENTRY (ArenaRecording, car_teams, "Teams of the recorded cars"),
+    GETONLY_ENTRY (ArenaRecording, num_boost_pads, "Number of boost pads"),
+    GETONLY_ENTRY (ArenaRecording, num_ticks, "Number of recorded ticks"),
+    GETONLY_ENTRY (ArenaRecording, num_chunks, "Number of chunks"),
+    GETONLY_ENTRY (ArenaRecording, column_names, "Names of the columns"),
+    {.name = nullptr, .get = nullptr, .set = nullptr, .doc = nullptr, .closure = nullptr},
+};
+
+PyType_Slot ArenaRecording::Slots[] = {
+    {Py_tp_new, (void *)&ArenaRecording::New},
+    {Py_tp_init, (void *)&ArenaRecording::Init},
+    {Py_tp_dealloc, (void *)&ArenaRecording::Dealloc},
+    {Py_tp_methods, &ArenaRecording::Methods},
+    {Py_tp_getset, &ArenaRecording::GetSet},
+    {Py_tp_doc, (void *)R"(Arena recording
+__init__(self, path: str)
+Memory-maps a file written by RocketSim.ArenaRecorder)"},
+    {0, nullptr},
+};
+
+PyType_Spec ArenaRecording::Spec = {
+    .name      = "RocketSim.ArenaRecording",
+    .basicsize = sizeof (ArenaRecording),
+    .itemsize  = 0,
+    .flags     = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HEAPTYPE,
+    .slots     = ArenaRecording::Slots,
+};
+
+PyObject *ArenaRecording::New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	auto const tp_alloc = (allocfunc)PyType_GetSlot (subtype_, Py_tp_alloc);
+
+	auto self = PyRef<ArenaRecording>::stealObject (tp_alloc (subtype_, 0));
+	if (!self)
+		return nullptr;
+
+	self->recording = nullptr;
+
+	return self.giftObject ();
+}
+
+int ArenaRecording::Init (ArenaRecording *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char pathKwd[] = "path";
+
+	static char *dict[] = {pathKwd, nullptr};
+
+	char const *path = nullptr;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "s", dict, &path))
+		return -1;
+
+	try
+	{
+		auto recording = new RocketSim::ArenaRecording (path);
+
+		delete self_->recording;
+		self_->recording = recording;
+	}
+	catch (std::bad_alloc const &err)
+	{
+		PyErr_NoMemory ();
+		return -1;
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return -1;
+	}
+
+	return 0;
+}
+
+void ArenaRecording::Dealloc (ArenaRecording *self_) noexcept
+{
+	delete self_->recording;
+
+	auto const tp_free = (freefunc)PyType_GetSlot (Type, Py_tp_free);
+	tp_free (self_);
+}
+
+PyObject *ArenaRecording::GetChunk (ArenaRecording *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char indexKwd[] = "index";
+
+	static char *dict[] = {indexKwd, nullptr};
+
+	Py_ssize_t index = 0;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "n", dict, &index))
+		return nullptr;
+
+	auto const recording = self_->recording;
+	if (!recording)
+	{
+		PyErr_SetString (PyExc_RuntimeError, "Recording is not open");
+		return nullptr;
+	}
+
+	if (index < 0)
+		index += recording->chunks.size ();
+	if (index < 0 || static_cast<std::size_t> (index) >= recording->chunks.size ())
+	{
+		PyErr_SetString (PyExc_IndexError, "Chunk index out of range");
+		return nullptr;
+	}
+
+	auto dict_ = PyObjectRef::steal (PyDict_New ());
+	if (!dict_)
+		return nullptr;
+
+	auto const &chunk = recording->chunks[index];
+	for (std::size_t i = 0; i < recording->columns.size (); ++i)
+	{
+		auto const &column = recording->columns[i];
+		auto dims          = columnDims (column, chunk.numTicks);
+
+		auto const data = recording->mappedFile->GetData () + chunk.columnOffsets[i];
+
+		PyObjectRef array;
+		if (recording->compressed)
+		{
+			array = PyObjectRef::steal (PyArrayOfKind (column.kind, column.elemSize, dims.size (), dims.data ()));
+			if (!array)
+				return nullptr;
+
+			auto const out = static_cast<byte *> (PyArray_DATA (reinterpret_cast<PyArrayObject *> (array.borrow ())));
+			if (!RocketSim::ArenaRecordingCodec::Decode (
+			        data, chunk.columnSizes[i], chunk.numTicks, column.GetTickSize (), column.elemSize, out))
+			{
+				PyErr_Format (PyExc_RuntimeError, "Invalid data for column '%s'", column.name.c_str ());
+				return nullptr;
+			}
+		}
+		else
+		{
+			// view of the mapped file, which keeps the recording alive
+			array = PyObjectRef::steal (PyArrayOfKind (
+			    column.kind, column.elemSize, dims.size (), dims.data (), data, reinterpret_cast<PyObject *> (self_)));
+			if (!array)
+				return nullptr;
+		}
+
+		if (PyDict_SetItemString (dict_.borrow (), column.name.c_str (), array.borrow ()) < 0)
+			return nullptr;
+	}
+
+	return dict_.gift ();
+}
+
+PyObject *ArenaRecording::GetColumn (ArenaRecording *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char nameKwd[] = "name";
+
+	static char *dict[] = {nameKwd, nullptr};
+
+	char const *name = nullptr;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "s", dict, &name))
+		return nullptr;
+
+	auto const recording = self_->recording;
+	if (!recording)
+	{
+		PyErr_SetString (PyExc_RuntimeError, "Recording is not open");
+		return nullptr;
+	}
+
+	auto const index = recording->FindColumn (name);
+	if (index < 0)
+	{
+		PyErr_Format (PyExc_KeyError, "No column named '%s'", name);
+		return nullptr;
+	}
+
+	auto const &column = recording->columns[index];
+	auto dims          = columnDims (column, recording->numTicks);
+
+	if (!recording->compressed && recording->chunks.size () == 1)
+	{
+		auto const data = recording->mappedFile->GetData () + recording->chunks[0].columnOffsets[index];
+		return PyArrayOfKind (
+		    column.kind, column.elemSize, dims.size (), dims.data (), data, reinterpret_cast<PyObject *> (self_));
+	}
+
+	auto array = PyObjectRef::steal (PyArrayOfKind (column.kind, column.elemSize, dims.size (), dims.data ()));
+	if (!array)
+		return nullptr;
+
+	try
+	{
+		recording->ReadColumn (
+		    index, static_cast<byte *> (PyArray_DATA (reinterpret_cast<PyArrayObject *> (array.borrow ()))));
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return nullptr;
+	}
+
+	return array.gift ();
+}
+
+PyObject *ArenaRecording::Getgame_mode (ArenaRecording *self_, void *) noexcept
+{
+	if (!self_->recording)
+		Py_RETURN_NONE;
+
+	return PyLong_FromLong (static_cast<long> (self_->recording->gameMode));
+}
+
+PyObject *ArenaRecording::Gettick_rate (ArenaRecording *self_, void *) noexcept
+{
+	if (!self_->recording)
+		Py_RETURN_NONE;
+
+	return PyFloat_FromDouble (1.0 / self_->recording->tickTime);
+}
+
+PyObject *ArenaRecording::Getcompressed (ArenaRecording *self_, void *) noexcept
+{
+	return PyBool_FromLong (self_->recording && self_->recording->compressed);
+}
+
+PyObject *ArenaRecording::Getcar_ids (ArenaRecording *self_, void *) noexcept
+{
+	auto list = PyObjectRef::steal (PyList_New (0));
+	if (!list || !self_->recording)
+		return list.gift ();
+
+	for (auto const &id : self_->recording->carIDs)
+	{
+		auto value = PyObjectRef::steal (PyLong_FromUnsignedLong (id));
+		if (!value || PyList_Append (list.borrow (), value.borrow ()) < 0)
+			return nullptr;
+	}
+
+	return list.gift ();
+}
+
+PyObject *ArenaRecording::Getcar_teams (ArenaRecording *self_, void *) noexcept
+{
+	auto list = PyObjectRef::steal (PyList_New (0));
+	if (!list || !self_->recording)
+		return list.gift ();
+
+	for (auto const &team : self_->recording->carTeams)
+	{
+		auto value = PyObjectRef::steal (PyLong_FromLong (team));
+		if (!value || PyList_Append (list.borrow (), value.borrow ()) < 0)
+			return nullptr;
+	}
+
+	return list.gift ();
+}
+
+PyObject *ArenaRecording::Getnum_boost_pads (ArenaRecording *self_, void *) noexcept
+{
+	return PyLong_FromUnsignedLong (self_->recording ? self_->recording->numBoostPads : 0);
+}
+
+PyObject *ArenaRecording::Getnum_ticks (ArenaRecording *self_, void *) noexcept
+{
+	return PyLong_FromUnsignedLongLong (self_->recording ? self_->recording->numTicks : 0);
+}
+
+PyObject *ArenaRecording::Getnum_chunks (ArenaRecording *self_, void *) noexcept
+{
+	return PyLong_FromSize_t (self_->recording ? self_->recording->chunks.size () : 0);
+}
+
+PyObject *ArenaRecording::Getcolumn_names (ArenaRecording *self_, void *) noexcept
+{
+	auto list = PyObjectRef::steal (PyList_New (0));
+	if (!list || !self_->recording)
+		return list.gift ();
+
+	for (auto const &column : self_->recording->columns)
+	{
+		auto value = PyObjectRef::steal (PyUnicode_FromString (column.name.c_str ()));
+		if (!value || PyList_Append (list.borrow (), value.borrow ()) < 0)
+			return nullptr;
+	}
+
+	return list.gift ();
+}
+}
@@ -0,0 +1,66 @@
+#include "Module.h"
+
+namespace RocketSim::Python
+{
+PyTypeObject *ArenaSnapshot::Type = nullptr;
+
+PyType_Slot ArenaSnapshot::Slots[] = {
+    {Py_tp_new, (void *)&ArenaSnapshot::New},
+    {Py_tp_init, nullptr},
+    {Py_tp_dealloc, (void *)&ArenaSnapshot::Dealloc},
+    {Py_tp_doc, (void *)R"(Arena snapshot
+__init__(self)
+Filled by RocketSim.Arena.save_snapshot(), and restored with RocketSim.Arena.restore_snapshot())"},
+    {0, nullptr},
+};
+
+PyType_Spec ArenaSnapshot::Spec = {
+    .name      = "RocketSim.ArenaSnapshot",
+    .basicsize = sizeof (ArenaSnapshot),
+    .itemsize  = 0,
+    .flags     = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HEAPTYPE,
+    .slots     = ArenaSnapshot::Slots,
+};
+
+PyObject *ArenaSnapshot::New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	auto const snapshot = new (std::nothrow) RocketSim::ArenaSnapshot{};
+	if (!snapshot)
+		return PyErr_NoMemory ();
+
+	auto const carStats = new (std::nothrow) std::vector<CarStats>{};
+	if (!carStats)
+	{
+		delete snapshot;
+		return PyErr_NoMemory ();
+	}
+
+	auto const tp_alloc = (allocfunc)PyType_GetSlot (subtype_, Py_tp_alloc);
+
+	auto self = PyRef<ArenaSnapshot>::stealObject (tp_alloc (subtype_, 0));
+	if (!self)
+	{
+		delete carStats;
+		delete snapshot;
+		return nullptr;
+	}
+
+	self->snapshot         = snapshot;
+	self->carStats         = carStats;
+	self->blueScore        = 0;
+	self->orangeScore      = 0;
+	self->lastGoalTick     = 0;
+	self->lastGymStateTick = 0;
+
+	return self.giftObject ();
+}
+
+void ArenaSnapshot::Dealloc (ArenaSnapshot *self_) noexcept
+{
+	delete self_->carStats;
+	delete self_->snapshot;
+
+	auto const tp_free = (freefunc)PyType_GetSlot (Type, Py_tp_free);
+	tp_free (self_);
+}
+}
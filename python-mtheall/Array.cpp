@@ -2,8 +2,10 @@
 
 #include "Array.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <vector>
 
 namespace
 {
@@ -34,6 +36,45 @@ RocketSim::Python::PyRef<PyArrayObject> makeArray (unsigned dim0_, unsigned dim1
 
 	return array;
 }
+
+// Returns obj_ as a C-contiguous float32 array, which must be writeable unless readOnly_. Sets an exception and returns
+// nullptr otherwise
+PyArrayObject *checkFloatArray (PyObject *obj_, bool const readOnly_) noexcept
+{
+	static bool const imported = importNumpy ();
+	if (!imported)
+	{
+		PyErr_SetString (PyExc_ImportError, "Failed to import numpy");
+		return nullptr;
+	}
+
+	if (!PyArray_Check (obj_))
+	{
+		PyErr_SetString (PyExc_TypeError, "Expected numpy.ndarray");
+		return nullptr;
+	}
+
+	auto const array = reinterpret_cast<PyArrayObject *> (obj_);
+	if (PyArray_TYPE (array) != NPY_FLOAT)
+	{
+		PyErr_SetString (PyExc_TypeError, "Expected numpy.float32 array");
+		return nullptr;
+	}
+
+	if (!PyArray_IS_C_CONTIGUOUS (array))
+	{
+		PyErr_SetString (PyExc_ValueError, "Expected C-contiguous array");
+		return nullptr;
+	}
+
+	if (!readOnly_ && !PyArray_ISWRITEABLE (array))
+	{
+		PyErr_SetString (PyExc_ValueError, "Expected writeable array");
+		return nullptr;
+	}
+
+	return array;
+}
 }
 
 namespace RocketSim::Python
@@ -89,4 +130,97 @@ bool PyArrayRef::isnan () const noexcept
 
 	return false;
 }
+
+float *PyArrayFloatData (PyObject *obj_, std::size_t &size_) noexcept
+{
+	auto const array = checkFloatArray (obj_, false);
+	if (!array)
+		return nullptr;
+
+	size_ = PyArray_SIZE (array);
+	return static_cast<float *> (PyArray_DATA (array));
+}
+
+float const *PyArrayConstFloatData (PyObject *obj_, std::size_t &size_) noexcept
+{
+	auto const array = checkFloatArray (obj_, true);
+	if (!array)
+		return nullptr;
+
+	size_ = PyArray_SIZE (array);
+	return static_cast<float const *> (PyArray_DATA (array));
+}
+
+bool PyArrayHasShape (PyObject *obj_, std::initializer_list<npy_intp> const dims_) noexcept
+{
+	auto const array = reinterpret_cast<PyArrayObject *> (obj_);
+	if (PyArray_NDIM (array) != static_cast<int> (dims_.size ()))
+		return false;
+
+	return std::equal (std::begin (dims_), std::end (dims_), PyArray_DIMS (array));
+}
+
+PyObject *PyArrayOfKind (char const kind_,
+    unsigned const elemSize_,
+    int const numDims_,
+    npy_intp *const dims_,
+    void const *const data_,
+    PyObject *const base_) noexcept
+{
+	static bool const imported = importNumpy ();
+	if (!imported)
+	{
+		PyErr_SetString (PyExc_ImportError, "Failed to import numpy");
+		return nullptr;
+	}
+
+	int type = NPY_NOTYPE;
+	if (kind_ == 'f' && elemSize_ == 4)
+		type = NPY_FLOAT32;
+	else if (kind_ == 'f' && elemSize_ == 8)
+		type = NPY_FLOAT64;
+	else if (kind_ == 'u' && elemSize_ == 1)
+		type = NPY_UINT8;
+	else if (kind_ == 'u' && elemSize_ == 2)
+		type = NPY_UINT16;
+	else if (kind_ == 'u' && elemSize_ == 4)
+		type = NPY_UINT32;
+	else if (kind_ == 'u' && elemSize_ == 8)
+		type = NPY_UINT64;
+
+	if (type == NPY_NOTYPE)
+	{
+		PyErr_Format (PyExc_ValueError, "Unsupported array type '%c%u'", kind_, elemSize_);
+		return nullptr;
+	}
+
+	// C order, as PyArray_New() picks Fortran order for some flags
+	std::vector<npy_intp> strides (numDims_);
+	npy_intp stride = elemSize_;
+	for (int i = numDims_ - 1; i >= 0; --i)
+	{
+		strides[i] = stride;
+		stride *= dims_[i];
+	}
+
+	if (!data_)
+		return PyArray_New (&PyArray_Type, numDims_, dims_, type, strides.data (), nullptr, 0, 0, nullptr);
+
+	auto array = PyRef<PyArrayObject>::stealObject (PyArray_New (&PyArray_Type,
+	    numDims_,
+	    dims_,
+	    type,
+	    strides.data (),
+	    const_cast<void *> (data_),
+	    0,
+	    NPY_ARRAY_C_CONTIGUOUS,
+	    nullptr));
+	if (!array)
+		return nullptr;
+
+	if (PyArray_SetBaseObject (array.borrow (), PyObjectRef::incRef (base_).gift ()) < 0)
+		return nullptr;
+
+	return array.giftObject ();
+}
 }
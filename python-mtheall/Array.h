@@ -5,6 +5,7 @@
 #include <numpy/arrayobject.h>
 
 #include <cstddef>
+#include <initializer_list>
 
 namespace RocketSim::Python
 {
@@ -27,4 +28,24 @@ private:
 	unsigned const m_dim0;
 	unsigned const m_dim1;
 };
+
+// Returns the data of a writeable C-contiguous float32 array and its total element count. Sets an exception and
+// returns nullptr otherwise
+float *PyArrayFloatData (PyObject *obj_, std::size_t &size_) noexcept;
+
+// Same as above for arrays that are only read from, which don't need to be writeable
+float const *PyArrayConstFloatData (PyObject *obj_, std::size_t &size_) noexcept;
+
+// Returns whether the array returned by one of the above has exactly this shape
+bool PyArrayHasShape (PyObject *obj_, std::initializer_list<npy_intp> dims_) noexcept;
+
+// Returns an array of unsigned ('u') or float ('f') elements, as numpy's dtype kinds. If data_ is given, the array is a
+// read-only view of it which keeps base_ alive, otherwise it is uninitialized. Sets an exception and returns nullptr
+// otherwise
+PyObject *PyArrayOfKind (char kind_,
+    unsigned elemSize_,
+    int numDims_,
+    npy_intp *dims_,
+    void const *data_ = nullptr,
+    PyObject *base_   = nullptr) noexcept;
 }
@@ -41,16 +41,16 @@ PyType_Spec BallPredictor::Spec = {
     .slots     = BallPredictor::Slots,
 };
 
-bool BallPredictor::InitFromArena (BallPredictor *self_, RocketSim::Arena *arena_) noexcept
+bool BallPredictor::InitFromSim (BallPredictor *self_, RocketSim::BallPredSim *sim_) noexcept
 {
-	if (arena_ != self_->tracker.ballPredArena)
-		delete self_->tracker.ballPredArena;
+	if (sim_ != self_->tracker.ballPredSim)
+		delete self_->tracker.ballPredSim;
 
-	self_->tracker.ballPredArena = arena_;
-	self_->tracker.predData.clear ();
+	self_->tracker.ballPredSim = sim_;
+	self_->tracker.ClearPred ();
 	self_->tracker.lastUpdateTickCount = 0;
 
-	arena_->tickCount = 0;
+	sim_->tickCount = 0;
 
 	return true;
 }
@@ -78,6 +78,7 @@ bool BallPredictor::InitFromParams (BallPredictor *self_,
 	{
 	case RocketSim::ArenaMemWeightMode::LIGHT:
 	case RocketSim::ArenaMemWeightMode::HEAVY:
+	case RocketSim::ArenaMemWeightMode::SHARED:
 		break;
 
 	default:
@@ -85,19 +86,19 @@ bool BallPredictor::InitFromParams (BallPredictor *self_,
 		return false;
 	}
 
-	if (self_->tracker.ballPredArena)
+	if (self_->tracker.ballPredSim)
 	{
-		// try to reuse existing arena
-		auto const arena = self_->tracker.ballPredArena;
-		if (arena->gameMode == gameMode_ && arena->GetArenaConfig ().memWeightMode == memoryWeightMode_ &&
-		    InitFromArena (self_, arena))
+		// try to reuse existing sim
+		auto const sim = self_->tracker.ballPredSim;
+		if (sim->gameMode == gameMode_ && sim->GetArenaConfig ().memWeightMode == memoryWeightMode_ &&
+		    InitFromSim (self_, sim))
 		{
-			self_->tracker.ballPredArena = arena;
-			self_->tracker.predData.clear ();
+			self_->tracker.ballPredSim = sim;
+			self_->tracker.ClearPred ();
 			self_->tracker.lastUpdateTickCount = 0;
 
-			arena->tickCount = 0;
-			arena->tickTime  = 1.0f / tickRate_;
+			sim->tickCount = 0;
+			sim->tickTime  = 1.0f / tickRate_;
 
 			return true;
 		}
@@ -119,11 +120,11 @@ bool BallPredictor::InitFromParams (BallPredictor *self_,
 		RocketSim::ArenaConfig arenaConfig;
 		arenaConfig.memWeightMode = memoryWeightMode_;
 
-		auto arena = RocketSim::Arena::Create (gameMode_, arenaConfig, tickRate_);
-		if (!arena)
+		auto sim = RocketSim::BallPredSim::Create (gameMode_, arenaConfig, tickRate_);
+		if (!sim)
 			throw -1;
 
-		if (!InitFromArena (self_, arena))
+		if (!InitFromSim (self_, sim))
 			throw -1;
 
 		return true;
@@ -153,11 +154,8 @@ PyObject *BallPredictor::New (PyTypeObject *subtype_, PyObject *args_, PyObject
 	if (!self)
 		return nullptr;
 
-	// bypass constructor so we can create arena on Init
-	self->tracker.ballPredArena = nullptr;
-	new (&self->tracker.predData) std::vector<BallState>{};
-	self->tracker.numPredTicks        = 0;
-	self->tracker.lastUpdateTickCount = 0;
+	// no sim yet, it is created on Init
+	new (&self->tracker) RocketSim::BallPredTracker (static_cast<RocketSim::BallPredSim *> (nullptr), 0);
 
 	return self.giftObject ();
 }
@@ -200,20 +198,20 @@ PyObject *BallPredictor::Pickle (BallPredictor *self_) noexcept
 	if (!dict)
 		return nullptr;
 
-	auto const arena = self_->tracker.ballPredArena;
+	auto const sim = self_->tracker.ballPredSim;
 
-	if (arena && arena->gameMode != RocketSim::GameMode::SOCCAR &&
-	    !DictSetValue (dict.borrow (), "game_mode", PyLong_FromLong (static_cast<long> (arena->gameMode))))
+	if (sim && sim->gameMode != RocketSim::GameMode::SOCCAR &&
+	    !DictSetValue (dict.borrow (), "game_mode", PyLong_FromLong (static_cast<long> (sim->gameMode))))
 		return nullptr;
 
-	if (arena && arena->GetArenaConfig ().memWeightMode != RocketSim::ArenaMemWeightMode::HEAVY &&
+	if (sim && sim->GetArenaConfig ().memWeightMode != RocketSim::ArenaMemWeightMode::HEAVY &&
 	    !DictSetValue (dict.borrow (),
 	        "memory_weight_mode",
-	        PyLong_FromLong (static_cast<long> (arena->GetArenaConfig ().memWeightMode))))
+	        PyLong_FromLong (static_cast<long> (sim->GetArenaConfig ().memWeightMode))))
 		return nullptr;
 
-	if (arena->tickTime != 1.0f / 120.0f &&
-	    !DictSetValue (dict.borrow (), "tick_time", PyFloat_FromDouble (arena->tickTime)))
+	if (sim->tickTime != 1.0f / 120.0f &&
+	    !DictSetValue (dict.borrow (), "tick_time", PyFloat_FromDouble (sim->tickTime)))
 		return nullptr;
 
 	return dict.gift ();
@@ -250,7 +248,7 @@ PyObject *BallPredictor::Unpickle (BallPredictor *self_, PyObject *dict_) noexce
 	        1.0f / tickTime))
 		return nullptr;
 
-	self_->tracker.ballPredArena->tickTime = tickTime;
+	self_->tracker.ballPredSim->tickTime = tickTime;
 
 	Py_RETURN_NONE;
 }
@@ -266,12 +264,12 @@ PyObject *BallPredictor::DeepCopy (BallPredictor *self_, PyObject *memo_) noexce
 	if (!self)
 		return nullptr;
 
-	auto const arena = self_->tracker.ballPredArena;
+	auto const sim = self_->tracker.ballPredSim;
 
 	if (!InitFromParams (self.borrow (),
-	        arena ? arena->gameMode : RocketSim::GameMode::SOCCAR,
-	        arena ? arena->GetArenaConfig ().memWeightMode : RocketSim::ArenaMemWeightMode::HEAVY,
-	        1.0f / (arena ? arena->tickTime : 120.0f)))
+	        sim ? sim->gameMode : RocketSim::GameMode::SOCCAR,
+	        sim ? sim->GetArenaConfig ().memWeightMode : RocketSim::ArenaMemWeightMode::HEAVY,
+	        1.0f / (sim ? sim->tickTime : 120.0f)))
 		return nullptr;
 
 	return self.giftObject ();
@@ -301,10 +299,14 @@ PyObject *BallPredictor::GetBallPrediction (BallPredictor *self_, PyObject *args
 	        &tickInterval))
 		return nullptr;
 
+	auto states = PyObjectRef::steal (PyList_New (numStates));
+	if (!states)
+		return nullptr;
+
 	try
 	{
-		if (numStates * tickInterval > self_->tracker.predData.capacity ())
-			self_->tracker.predData.reserve (numStates * tickInterval);
+		self_->tracker.numPredTicks = numStates * tickInterval;
+		self_->tracker.UpdatePredManual (BallState::ToBallState (PyCast<BallState> (ballState)), ticksSinceLastUpdate);
 	}
 	catch (std::bad_alloc const &err)
 	{
@@ -322,16 +324,9 @@ PyObject *BallPredictor::GetBallPrediction (BallPredictor *self_, PyObject *args
 		return nullptr;
 	}
 
-	auto states = PyObjectRef::steal (PyList_New (numStates));
-	if (!states)
-		return nullptr;
-
-	self_->tracker.numPredTicks = numStates * tickInterval;
-	self_->tracker.UpdatePredManual (PyCast<BallState> (ballState)->state, ticksSinceLastUpdate);
-
 	for (unsigned i = 0; i < numStates; ++i)
 	{
-		auto state = BallState::NewFromBallState (self_->tracker.predData[i * tickInterval]);
+		auto state = BallState::NewFromBallState (self_->tracker.GetPredState (i * tickInterval));
 		if (!state)
 			return nullptr;
 
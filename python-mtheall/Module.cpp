@@ -126,7 +126,7 @@ RocketSim::Python::PyObjectRef BuildList (std::span<T, N> input_) noexcept
 
 namespace RocketSim::Python
 {
-void InitInternal (char const *path_)
+void InitInternal (char const *path_, char const *meshCache_)
 {
 	if (inited)
 		return;
@@ -134,7 +134,10 @@ void InitInternal (char const *path_)
 	if (!path_)
 		path_ = std::getenv ("RS_COLLISION_MESHES");
 
-	RocketSim::Init (path_ ? path_ : COLLISION_MESH_BASE_PATH, true);
+	if (!meshCache_)
+		meshCache_ = std::getenv ("RS_MESH_CACHE");
+
+	RocketSim::Init (path_ ? path_ : COLLISION_MESH_BASE_PATH, true, meshCache_ ? meshCache_ : "");
 
 	inited = true;
 }
@@ -173,17 +176,19 @@ PyObject *Init (PyObject *self_, PyObject *args_, PyObject *kwds_) noexcept
 		return nullptr;
 	}
 
-	static char pathKwd[] = "path";
+	static char pathKwd[]      = "path";
+	static char meshCacheKwd[] = "mesh_cache";
 
-	static char *dict[] = {pathKwd, nullptr};
+	static char *dict[] = {pathKwd, meshCacheKwd, nullptr};
 
-	char const *path = nullptr;
-	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "|s", dict, &path))
+	char const *path      = nullptr;
+	char const *meshCache = nullptr;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "|ss", dict, &path, &meshCache))
 		return nullptr;
 
 	try
 	{
-		RocketSim::Python::InitInternal (path);
+		RocketSim::Python::InitInternal (path, meshCache);
 	}
 	catch (std::exception const &err)
 	{
@@ -207,7 +212,23 @@ struct PyMethodDef Methods[] = {
     {.ml_name     = "init",
         .ml_meth  = (PyCFunction)&Init,
         .ml_flags = METH_VARARGS | METH_KEYWORDS,
-        .ml_doc   = R"(init(path: str = os.getenv("RS_COLLISION_MESHES", "collision_meshes"))"},
+        .ml_doc   = R"(init(path: str = os.getenv("RS_COLLISION_MESHES", "collision_meshes"), mesh_cache: str = os.getenv("RS_MESH_CACHE", ""))
+If mesh_cache is set, the arena meshes are loaded from that file, which is (re)written if it doesn't match the meshes)"},
+    {.ml_name     = "predict_balls",
+        .ml_meth  = (PyCFunction)&RocketSim::Python::Arena::PredictBalls,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc   = R"(predict_balls(states: numpy.ndarray, num_ticks: int, tick_interval: int, out: numpy.ndarray, game_mode: int = RocketSim.GameMode.SOCCAR, tick_rate: float = 120.0) -> None
+Predicts the ball from each row of `states` in parallel on the RocketSim.Arena.multi_step worker threads
+`states` is a float32 array of shape (N, 9) with position, velocity and angular velocity, or (N, 18) with the rotation matrix's forward, right and up vectors after them
+`out` is a float32 array of shape (N, num_ticks, k) with the same columns, where out[i, t] is the ball `t * tick_interval` ticks after states[i])"},
+    {.ml_name     = "set_thread_pool",
+        .ml_meth  = (PyCFunction)&RocketSim::Python::Arena::SetThreadPool,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc   = R"(set_thread_pool(num_threads: int = 0, affinity: Sequence[int] | None = None, sticky: bool = False)
+Configures the worker threads used by RocketSim.Arena.multi_step
+`num_threads` of 0 uses one thread per hardware thread
+Worker `i` is pinned to cpu `affinity[i % len(affinity)]`
+If `sticky`, each arena is always stepped by the same worker)"},
     {.ml_name = nullptr, .ml_meth = nullptr, .ml_flags = 0, .ml_doc = nullptr},
 };
 
@@ -255,6 +276,9 @@ extern "C" Py_EXPORTED_SYMBOL PyObject *PyInit_RocketSim () noexcept
 	MAKE_TYPE (Angle);
 	MAKE_TYPE (Arena);
 	MAKE_TYPE (ArenaConfig);
+	MAKE_TYPE (ArenaRecorder);
+	MAKE_TYPE (ArenaRecording);
+	MAKE_TYPE (ArenaSnapshot);
 	MAKE_TYPE (Ball);
 	MAKE_TYPE (BallHitInfo);
 	MAKE_TYPE (BallPredictor);
@@ -270,6 +294,8 @@ extern "C" Py_EXPORTED_SYMBOL PyObject *PyInit_RocketSim () noexcept
 	MAKE_TYPE (GameMode);
 	MAKE_TYPE (MemoryWeightMode);
 	MAKE_TYPE (MutatorConfig);
+	MAKE_TYPE (ReplayPlayer);
+	MAKE_TYPE (ReplayRecorder);
 	MAKE_TYPE (RotMat);
 	MAKE_TYPE (Team);
 	MAKE_TYPE (Vec);
@@ -332,6 +358,9 @@ extern "C" Py_EXPORTED_SYMBOL PyObject *PyInit_RocketSim () noexcept
 		SET_TYPE_ATTR (RocketSim::Python::MemoryWeightMode::Type,
 		    "LIGHT",
 		    PyObjectRef::steal (PyLong_FromLong (static_cast<long> (RocketSim::ArenaMemWeightMode::LIGHT))));
+		SET_TYPE_ATTR (RocketSim::Python::MemoryWeightMode::Type,
+		    "SHARED",
+		    PyObjectRef::steal (PyLong_FromLong (static_cast<long> (RocketSim::ArenaMemWeightMode::SHARED))));
 
 		// CarConfig
 		SET_TYPE_ATTR (RocketSim::Python::CarConfig::Type,
@@ -8,9 +8,11 @@
 #include "Math/Math.h"
 #include "Sim/Arena/Arena.h"
 #include "Sim/Arena/ArenaConfig/ArenaConfig.h"
+#include "Sim/ArenaRecorder/ArenaRecorder.h"
 #include "Sim/BallPredTracker/BallPredTracker.h"
 #include "Sim/Car/Car.h"
 #include "Sim/GameEventTracker/GameEventTracker.h"
+#include "Sim/Replay/ReplayPlayer.h"
 
 #include <map>
 #include <memory>
@@ -93,7 +95,7 @@ static_assert (sizeof (bool) == sizeof (char));
 
 namespace RocketSim::Python
 {
-void InitInternal (char const *path_);
+void InitInternal (char const *path_, char const *meshCache_ = nullptr);
 
 bool DictSetValue (PyObject *dict_, char const *key_, PyObject *value_) noexcept;
 
@@ -682,6 +684,152 @@ struct Car
 	static PyObject *SetState (Car *self_, PyObject *args_, PyObject *kwds_) noexcept;
 };
 
+struct ArenaSnapshot
+{
+	// python-side car state, sorted by car id
+	struct CarStats
+	{
+		std::uint32_t id;
+		RocketSim::CarState demoState;
+		unsigned goals;
+		unsigned demos;
+		unsigned boostPickups;
+		unsigned shots;
+		unsigned saves;
+		unsigned assists;
+	};
+
+	PyObject_HEAD;
+
+	RocketSim::ArenaSnapshot *snapshot;
+	std::vector<CarStats> *carStats;
+
+	unsigned blueScore;
+	unsigned orangeScore;
+
+	std::uint64_t lastGoalTick;
+	std::uint64_t lastGymStateTick;
+
+	static PyTypeObject *Type;
+	static PyType_Slot Slots[];
+	static PyType_Spec Spec;
+
+	static PyObject *New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_) noexcept;
+	static void Dealloc (ArenaSnapshot *self_) noexcept;
+};
+
+struct ArenaRecorder
+{
+	PyObject_HEAD;
+
+	RocketSim::ArenaRecorder *recorder;
+
+	// kept alive while recording
+	PyObject *arena;
+
+	static PyTypeObject *Type;
+	static PyMethodDef Methods[];
+	static PyGetSetDef GetSet[];
+	static PyType_Slot Slots[];
+	static PyType_Spec Spec;
+
+	static PyObject *New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_) noexcept;
+	static int Init (ArenaRecorder *self_, PyObject *args_, PyObject *kwds_) noexcept;
+	static void Dealloc (ArenaRecorder *self_) noexcept;
+
+	static PyObject *Close (ArenaRecorder *self_) noexcept;
+	static PyObject *Enter (ArenaRecorder *self_) noexcept;
+	static PyObject *Exit (ArenaRecorder *self_, PyObject *args_) noexcept;
+
+	GETONLY_DECLARE (ArenaRecorder, is_open);
+	GETONLY_DECLARE (ArenaRecorder, num_ticks);
+};
+
+struct ArenaRecording
+{
+	PyObject_HEAD;
+
+	RocketSim::ArenaRecording *recording;
+
+	static PyTypeObject *Type;
+	static PyMethodDef Methods[];
+	static PyGetSetDef GetSet[];
+	static PyType_Slot Slots[];
+	static PyType_Spec Spec;
+
+	static PyObject *New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_) noexcept;
+	static int Init (ArenaRecording *self_, PyObject *args_, PyObject *kwds_) noexcept;
+	static void Dealloc (ArenaRecording *self_) noexcept;
+
+	static PyObject *GetChunk (ArenaRecording *self_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *GetColumn (ArenaRecording *self_, PyObject *args_, PyObject *kwds_) noexcept;
+
+	GETONLY_DECLARE (ArenaRecording, game_mode);
+	GETONLY_DECLARE (ArenaRecording, tick_rate);
+	GETONLY_DECLARE (ArenaRecording, compressed);
+	GETONLY_DECLARE (ArenaRecording, car_ids);
+	GETONLY_DECLARE (ArenaRecording, car_teams);
+	GETONLY_DECLARE (ArenaRecording, num_boost_pads);
+	GETONLY_DECLARE (ArenaRecording, num_ticks);
+	GETONLY_DECLARE (ArenaRecording, num_chunks);
+	GETONLY_DECLARE (ArenaRecording, column_names);
+};
+
+struct ReplayRecorder
+{
+	PyObject_HEAD;
+
+	RocketSim::ReplayRecorder *recorder;
+
+	// kept alive while recording
+	PyObject *arena;
+
+	static PyTypeObject *Type;
+	static PyMethodDef Methods[];
+	static PyGetSetDef GetSet[];
+	static PyType_Slot Slots[];
+	static PyType_Spec Spec;
+
+	static PyObject *New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_) noexcept;
+	static int Init (ReplayRecorder *self_, PyObject *args_, PyObject *kwds_) noexcept;
+	static void Dealloc (ReplayRecorder *self_) noexcept;
+
+	static PyObject *Close (ReplayRecorder *self_) noexcept;
+	static PyObject *Enter (ReplayRecorder *self_) noexcept;
+	static PyObject *Exit (ReplayRecorder *self_, PyObject *args_) noexcept;
+	static PyObject *RequestKeyframe (ReplayRecorder *self_) noexcept;
+
+	GETONLY_DECLARE (ReplayRecorder, is_open);
+	GETONLY_DECLARE (ReplayRecorder, num_ticks);
+};
+
+struct ReplayPlayer
+{
+	PyObject_HEAD;
+
+	RocketSim::ReplayPlayer *player;
+
+	static PyTypeObject *Type;
+	static PyMethodDef Methods[];
+	static PyGetSetDef GetSet[];
+	static PyType_Slot Slots[];
+	static PyType_Spec Spec;
+
+	static PyObject *New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_) noexcept;
+	static int Init (ReplayPlayer *self_, PyObject *args_, PyObject *kwds_) noexcept;
+	static void Dealloc (ReplayPlayer *self_) noexcept;
+
+	static PyObject *GetBallState (ReplayPlayer *self_) noexcept;
+	static PyObject *GetCarState (ReplayPlayer *self_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *Seek (ReplayPlayer *self_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *Step (ReplayPlayer *self_, PyObject *args_, PyObject *kwds_) noexcept;
+
+	GETONLY_DECLARE (ReplayPlayer, car_ids);
+	GETONLY_DECLARE (ReplayPlayer, keyframe_ticks);
+	GETONLY_DECLARE (ReplayPlayer, num_ticks);
+	GETONLY_DECLARE (ReplayPlayer, tick);
+};
+
 struct BallPredictor
 {
 	PyObject_HEAD;
@@ -693,7 +841,7 @@ struct BallPredictor
 	static PyType_Slot Slots[];
 	static PyType_Spec Spec;
 
-	static bool InitFromArena (BallPredictor *self_, RocketSim::Arena *arena_) noexcept;
+	static bool InitFromSim (BallPredictor *self_, RocketSim::BallPredSim *sim_) noexcept;
 	static bool InitFromParams (BallPredictor *self_,
 	    RocketSim::GameMode gameMode_,
 	    RocketSim::ArenaMemWeightMode memoryWeightMode_,
@@ -813,6 +961,10 @@ struct Arena
 	std::uint64_t lastGoalTick;
 	std::uint64_t lastGymStateTick;
 
+	// worker this arena always steps on when the thread pool is sticky, and the pool that assigned it
+	mutable std::uint64_t threadPoolId;
+	mutable unsigned threadPoolWorker;
+
 	mutable PyObject *stepExceptionType;
 	mutable PyObject *stepExceptionValue;
 	mutable PyObject *stepExceptionTraceback;
@@ -829,6 +981,8 @@ struct Arena
 	static void Dealloc (Arena *self_) noexcept;
 	static PyObject *Pickle (Arena *self_) noexcept;
 	static PyObject *Unpickle (Arena *self_, PyObject *dict_) noexcept;
+	static PyObject *PickleBinary (Arena *self_) noexcept;
+	static PyObject *UnpickleBinary (Arena *self_, PyObject *bytes_) noexcept;
 	static PyObject *Copy (Arena *self_) noexcept;
 	static PyObject *DeepCopy (Arena *self_, PyObject *memo_) noexcept;
 
@@ -841,10 +995,14 @@ struct Arena
 	static PyObject *GetCars (Arena *self_) noexcept;
 	static PyObject *GetConfig (Arena *self_) noexcept;
 	static PyObject *GetGymState (Arena *self_) noexcept;
+	static PyObject *GetGymStateSize (Arena *self_) noexcept;
 	static PyObject *GetMutatorConfig (Arena *self_) noexcept;
 	static PyObject *IsBallProbablyGoingIn (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
 	static PyObject *RemoveCar (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *Reset (Arena *self_) noexcept;
 	static PyObject *ResetKickoff (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *RestoreSnapshot (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *SaveSnapshot (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
 	static PyObject *SetBallTouchCallback (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
 	static PyObject *SetBoostPickupCallback (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
 	static PyObject *SetCarBallCollision (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
@@ -858,8 +1016,14 @@ struct Arena
 	static PyObject *SetMutatorConfig (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
 	static PyObject *Step (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
 	static PyObject *Stop (Arena *self_) noexcept;
+	static PyObject *WriteGymState (Arena *self_, PyObject *args_, PyObject *kwds_) noexcept;
 
 	static PyObject *MultiStep (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *MultiStepExport (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *MultiWriteGymState (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *PredictBalls (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *SetThreadPool (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept;
+	static PyObject *VecStep (PyObject *dummy_, PyObject *args_, PyObject *kwds_) noexcept;
 
 	static void HandleBallTouchCallback (RocketSim::Arena *arena_, RocketSim::Car *car_, void *userData_) noexcept;
 	static void HandleBoostPickupCallback (RocketSim::Arena *arena_,
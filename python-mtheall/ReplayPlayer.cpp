@@ -0,0 +1,308 @@
+#include "Module.h"
+
+#include <algorithm>
+
+namespace RocketSim::Python
+{
+PyTypeObject *ReplayPlayer::Type = nullptr;
+
+PyMethodDef ReplayPlayer::Methods[] = {
+    {.ml_name     = "get_ball_state",
+        .ml_meth  = (PyCFunction)&ReplayPlayer::GetBallState,
+        .ml_flags = METH_NOARGS,
+        .ml_doc   = R"(get_ball_state(self) -> RocketSim.BallState
+State of the ball at the current tick)"},
+    {.ml_name     = "get_car_state",
+        .ml_meth  = (PyCFunction)&ReplayPlayer::GetCarState,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc   = R"(get_car_state(self, id: int) -> RocketSim.CarState
+State of a car at the current tick)"},
+    {.ml_name     = "seek",
+        .ml_meth  = (PyCFunction)&ReplayPlayer::Seek,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc   = R"(seek(self, tick: int)
+Go to the state before simulating this tick, loading the nearest keyframe before it and simulating forward from there
+Every tick up to and including num_ticks (the state after the last tick) can be seeked to)"},
+    {.ml_name     = "step",
+        .ml_meth  = (PyCFunction)&ReplayPlayer::Step,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc   = R"(step(self, ticks: int = 1)
+Simulate forward from the current tick with the recorded controls)"},
+    {.ml_name = nullptr, .ml_meth = nullptr, .ml_flags = 0, .ml_doc = nullptr},
+};
+
+PyGetSetDef ReplayPlayer::GetSet[] = {
+    GETONLY_ENTRY (ReplayPlayer, car_ids, "IDs of the cars at the current tick, in ascending order"),
+    GETONLY_ENTRY (ReplayPlayer, keyframe_ticks, "Ticks the replay has keyframes at"),
+    GETONLY_ENTRY (ReplayPlayer, num_ticks, "Ticks in the replay"),
+    GETONLY_ENTRY (ReplayPlayer, tick, "Current tick, counted from the start of the recording"),
+    {.name = nullptr, .get = nullptr, .set = nullptr, .doc = nullptr, .closure = nullptr},
+};
+
+PyType_Slot ReplayPlayer::Slots[] = {
+    {Py_tp_new, (void *)&ReplayPlayer::New},
+    {Py_tp_init, (void *)&ReplayPlayer::Init},
+    {Py_tp_dealloc, (void *)&ReplayPlayer::Dealloc},
+    {Py_tp_methods, &ReplayPlayer::Methods},
+    {Py_tp_getset, &ReplayPlayer::GetSet},
+    {Py_tp_doc, (void *)R"(Replay player
+__init__(self, path: str)
+Plays back a file written by RocketSim.ReplayRecorder, re-simulating its ticks exactly as they were recorded
+Call seek() before reading any states)"},
+    {0, nullptr},
+};
+
+PyType_Spec ReplayPlayer::Spec = {
+    .name      = "RocketSim.ReplayPlayer",
+    .basicsize = sizeof (ReplayPlayer),
+    .itemsize  = 0,
+    .flags     = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HEAPTYPE,
+    .slots     = ReplayPlayer::Slots,
+};
+
+namespace
+{
+// Returns the player's arena, or sets an exception if nothing was seeked yet
+RocketSim::Arena *seekedArena (ReplayPlayer *self_) noexcept
+{
+	if (!self_->player || !self_->player->GetArena ())
+	{
+		PyErr_SetString (PyExc_RuntimeError, "Nothing to read, seek() first");
+		return nullptr;
+	}
+
+	return self_->player->GetArena ();
+}
+}
+
+PyObject *ReplayPlayer::New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	auto const tp_alloc = (allocfunc)PyType_GetSlot (subtype_, Py_tp_alloc);
+
+	auto self = PyRef<ReplayPlayer>::stealObject (tp_alloc (subtype_, 0));
+	if (!self)
+		return nullptr;
+
+	self->player = nullptr;
+
+	return self.giftObject ();
+}
+
+int ReplayPlayer::Init (ReplayPlayer *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char pathKwd[] = "path";
+
+	static char *dict[] = {pathKwd, nullptr};
+
+	char const *path = nullptr;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "s", dict, &path))
+		return -1;
+
+	delete self_->player;
+	self_->player = nullptr;
+
+	try
+	{
+		// default initialization if it hasn't been done yet
+		InitInternal (nullptr);
+
+		self_->player = new RocketSim::ReplayPlayer (path);
+	}
+	catch (std::bad_alloc const &err)
+	{
+		PyErr_NoMemory ();
+		return -1;
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return -1;
+	}
+
+	return 0;
+}
+
+void ReplayPlayer::Dealloc (ReplayPlayer *self_) noexcept
+{
+	delete self_->player;
+
+	auto const tp_free = (freefunc)PyType_GetSlot (Type, Py_tp_free);
+	tp_free (self_);
+}
+
+PyObject *ReplayPlayer::GetBallState (ReplayPlayer *self_) noexcept
+{
+	auto const arena = seekedArena (self_);
+	if (!arena)
+		return nullptr;
+
+	auto state = BallState::NewFromBallState (arena->ball->GetState ());
+	if (!state)
+		return nullptr;
+
+	return state.giftObject ();
+}
+
+PyObject *ReplayPlayer::GetCarState (ReplayPlayer *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char idKwd[] = "id";
+
+	static char *dict[] = {idKwd, nullptr};
+
+	unsigned id;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "I", dict, &id))
+		return nullptr;
+
+	auto const arena = seekedArena (self_);
+	if (!arena)
+		return nullptr;
+
+	// not GetCar (), which would insert the missing id
+	auto const it = arena->_carIDMap.find (id);
+	if (it == std::end (arena->_carIDMap))
+		return PyErr_Format (PyExc_KeyError, "No car with id '%u'", id);
+
+	auto state = CarState::NewFromCarState (it->second->GetState ());
+	if (!state)
+		return nullptr;
+
+	return state.giftObject ();
+}
+
+PyObject *ReplayPlayer::Seek (ReplayPlayer *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char tickKwd[] = "tick";
+
+	static char *dict[] = {tickKwd, nullptr};
+
+	unsigned long long tick;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "K", dict, &tick))
+		return nullptr;
+
+	if (!self_->player)
+	{
+		PyErr_SetString (PyExc_RuntimeError, "Replay player is not initialized");
+		return nullptr;
+	}
+
+	if (tick > self_->player->numTicks)
+		return PyErr_Format (PyExc_ValueError,
+		    "Tick %llu is past the end of the replay (%llu ticks)",
+		    tick,
+		    static_cast<unsigned long long> (self_->player->numTicks));
+
+	try
+	{
+		Py_BEGIN_ALLOW_THREADS;
+		self_->player->Seek (tick);
+		Py_END_ALLOW_THREADS;
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return nullptr;
+	}
+
+	Py_RETURN_NONE;
+}
+
+PyObject *ReplayPlayer::Step (ReplayPlayer *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char ticksKwd[] = "ticks";
+
+	static char *dict[] = {ticksKwd, nullptr};
+
+	int ticksToSimulate = 1;
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "|i", dict, &ticksToSimulate))
+		return nullptr;
+
+	if (!seekedArena (self_))
+		return nullptr;
+
+	if (ticksToSimulate < 0 || self_->player->GetTick () + ticksToSimulate > self_->player->numTicks)
+		return PyErr_Format (PyExc_ValueError,
+		    "Cannot simulate %d ticks from tick %llu (%llu ticks)",
+		    ticksToSimulate,
+		    static_cast<unsigned long long> (self_->player->GetTick ()),
+		    static_cast<unsigned long long> (self_->player->numTicks));
+
+	try
+	{
+		Py_BEGIN_ALLOW_THREADS;
+		self_->player->Step (ticksToSimulate);
+		Py_END_ALLOW_THREADS;
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return nullptr;
+	}
+
+	Py_RETURN_NONE;
+}
+
+PyObject *ReplayPlayer::Getcar_ids (ReplayPlayer *self_, void *) noexcept
+{
+	auto const arena = seekedArena (self_);
+	if (!arena)
+		return nullptr;
+
+	std::vector<std::uint32_t> ids;
+	try
+	{
+		for (auto const &[id, car] : arena->_carIDMap)
+			ids.emplace_back (id);
+	}
+	catch (std::exception const &err)
+	{
+		return PyErr_NoMemory ();
+	}
+
+	std::sort (std::begin (ids), std::end (ids));
+
+	auto list = PyObjectRef::steal (PyList_New (0));
+	if (!list)
+		return nullptr;
+
+	for (auto const &id : ids)
+	{
+		auto value = PyObjectRef::steal (PyLong_FromUnsignedLong (id));
+		if (!value || PyList_Append (list.borrow (), value.borrow ()) < 0)
+			return nullptr;
+	}
+
+	return list.gift ();
+}
+
+PyObject *ReplayPlayer::Getkeyframe_ticks (ReplayPlayer *self_, void *) noexcept
+{
+	auto list = PyObjectRef::steal (PyList_New (0));
+	if (!list || !self_->player)
+		return list.gift ();
+
+	for (auto const &keyframe : self_->player->keyframes)
+	{
+		auto value = PyObjectRef::steal (PyLong_FromUnsignedLongLong (keyframe.tick));
+		if (!value || PyList_Append (list.borrow (), value.borrow ()) < 0)
+			return nullptr;
+	}
+
+	return list.gift ();
+}
+
+PyObject *ReplayPlayer::Getnum_ticks (ReplayPlayer *self_, void *) noexcept
+{
+	if (!self_->player)
+		return PyLong_FromLong (0);
+
+	return PyLong_FromUnsignedLongLong (self_->player->numTicks);
+}
+
+PyObject *ReplayPlayer::Gettick (ReplayPlayer *self_, void *) noexcept
+{
+	if (!self_->player)
+		return PyLong_FromLong (0);
+
+	return PyLong_FromUnsignedLongLong (self_->player->GetTick ());
+}
+}
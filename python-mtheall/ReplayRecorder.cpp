@@ -0,0 +1,178 @@
+#include "Module.h"
+
+namespace RocketSim::Python
+{
+PyTypeObject *ReplayRecorder::Type = nullptr;
+
+PyMethodDef ReplayRecorder::Methods[] = {
+    {.ml_name     = "close",
+        .ml_meth  = (PyCFunction)&ReplayRecorder::Close,
+        .ml_flags = METH_NOARGS,
+        .ml_doc   = R"(close(self)
+Write any remaining ticks and the keyframe index, and stop recording)"},
+    {.ml_name     = "request_keyframe",
+        .ml_meth  = (PyCFunction)&ReplayRecorder::RequestKeyframe,
+        .ml_flags = METH_NOARGS,
+        .ml_doc   = R"(request_keyframe(self)
+Store the arena in full before the next tick, needed after changing anything other than the cars, ball, and boost pads)"},
+    {.ml_name     = "__enter__",
+        .ml_meth  = (PyCFunction)&ReplayRecorder::Enter,
+        .ml_flags = METH_NOARGS,
+        .ml_doc   = R"(__enter__(self) -> RocketSim.ReplayRecorder)"},
+    {.ml_name     = "__exit__",
+        .ml_meth  = (PyCFunction)&ReplayRecorder::Exit,
+        .ml_flags = METH_VARARGS,
+        .ml_doc   = R"(__exit__(self, exc_type, exc_value, traceback)
+Close the recorder)"},
+    {.ml_name = nullptr, .ml_meth = nullptr, .ml_flags = 0, .ml_doc = nullptr},
+};
+
+PyGetSetDef ReplayRecorder::GetSet[] = {
+    GETONLY_ENTRY (ReplayRecorder, is_open, "Whether still recording"),
+    GETONLY_ENTRY (ReplayRecorder, num_ticks, "Ticks recorded so far"),
+    {.name = nullptr, .get = nullptr, .set = nullptr, .doc = nullptr, .closure = nullptr},
+};
+
+PyType_Slot ReplayRecorder::Slots[] = {
+    {Py_tp_new, (void *)&ReplayRecorder::New},
+    {Py_tp_init, (void *)&ReplayRecorder::Init},
+    {Py_tp_dealloc, (void *)&ReplayRecorder::Dealloc},
+    {Py_tp_methods, &ReplayRecorder::Methods},
+    {Py_tp_getset, &ReplayRecorder::GetSet},
+    {Py_tp_doc, (void *)R"(Replay recorder
+__init__(self, arena: RocketSim.Arena, path: str, keyframe_interval: int = 1200)
+Records every tick the arena simulates to a replay file, play it back with RocketSim.ReplayPlayer
+Every `keyframe_interval` ticks the arena is stored in full, so seeking never simulates more than that many ticks)"},
+    {0, nullptr},
+};
+
+PyType_Spec ReplayRecorder::Spec = {
+    .name      = "RocketSim.ReplayRecorder",
+    .basicsize = sizeof (ReplayRecorder),
+    .itemsize  = 0,
+    .flags     = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HEAPTYPE,
+    .slots     = ReplayRecorder::Slots,
+};
+
+PyObject *ReplayRecorder::New (PyTypeObject *subtype_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	auto const tp_alloc = (allocfunc)PyType_GetSlot (subtype_, Py_tp_alloc);
+
+	auto self = PyRef<ReplayRecorder>::stealObject (tp_alloc (subtype_, 0));
+	if (!self)
+		return nullptr;
+
+	self->recorder = nullptr;
+	self->arena    = nullptr;
+
+	return self.giftObject ();
+}
+
+int ReplayRecorder::Init (ReplayRecorder *self_, PyObject *args_, PyObject *kwds_) noexcept
+{
+	static char arenaKwd[]            = "arena";
+	static char pathKwd[]             = "path";
+	static char keyframeIntervalKwd[] = "keyframe_interval";
+
+	static char *dict[] = {arenaKwd, pathKwd, keyframeIntervalKwd, nullptr};
+
+	PyObject *arena           = nullptr;
+	char const *path          = nullptr;
+	unsigned keyframeInterval = RocketSim::ReplayRecorderConfig{}.keyframeInterval;
+
+	if (!PyArg_ParseTupleAndKeywords (args_, kwds_, "O!s|I", dict, Arena::Type, &arena, &path, &keyframeInterval))
+		return -1;
+
+	if (keyframeInterval == 0)
+	{
+		PyErr_SetString (PyExc_ValueError, "keyframe_interval must be positive");
+		return -1;
+	}
+
+	delete self_->recorder;
+	self_->recorder = nullptr;
+
+	RocketSim::ReplayRecorderConfig config;
+	config.keyframeInterval = keyframeInterval;
+
+	try
+	{
+		self_->recorder = new RocketSim::ReplayRecorder (reinterpret_cast<Arena *> (arena)->arena.get (), path, config);
+	}
+	catch (std::bad_alloc const &err)
+	{
+		PyErr_NoMemory ();
+		return -1;
+	}
+	catch (std::exception const &err)
+	{
+		PyErr_SetString (PyExc_RuntimeError, err.what ());
+		return -1;
+	}
+
+	PyRef<PyObject>::assign (self_->arena, arena);
+
+	return 0;
+}
+
+void ReplayRecorder::Dealloc (ReplayRecorder *self_) noexcept
+{
+	// closes the recorder before the arena can go away
+	delete self_->recorder;
+	Py_XDECREF (self_->arena);
+
+	auto const tp_free = (freefunc)PyType_GetSlot (Type, Py_tp_free);
+	tp_free (self_);
+}
+
+PyObject *ReplayRecorder::Close (ReplayRecorder *self_) noexcept
+{
+	if (self_->recorder)
+	{
+		try
+		{
+			self_->recorder->Close ();
+		}
+		catch (std::exception const &err)
+		{
+			PyErr_SetString (PyExc_RuntimeError, err.what ());
+			return nullptr;
+		}
+	}
+
+	Py_CLEAR (self_->arena);
+
+	Py_RETURN_NONE;
+}
+
+PyObject *ReplayRecorder::Enter (ReplayRecorder *self_) noexcept
+{
+	return PyObjectRef::incRef (reinterpret_cast<PyObject *> (self_)).gift ();
+}
+
+PyObject *ReplayRecorder::Exit (ReplayRecorder *self_, PyObject *args_) noexcept
+{
+	return Close (self_);
+}
+
+PyObject *ReplayRecorder::RequestKeyframe (ReplayRecorder *self_) noexcept
+{
+	if (self_->recorder)
+		self_->recorder->RequestKeyframe ();
+
+	Py_RETURN_NONE;
+}
+
+PyObject *ReplayRecorder::Getis_open (ReplayRecorder *self_, void *) noexcept
+{
+	return PyBool_FromLong (self_->recorder && self_->recorder->IsOpen ());
+}
+
+PyObject *ReplayRecorder::Getnum_ticks (ReplayRecorder *self_, void *) noexcept
+{
+	if (!self_->recorder)
+		return PyLong_FromLong (0);
+
+	return PyLong_FromUnsignedLongLong (self_->recorder->GetNumTicksRecorded ());
+}
+}
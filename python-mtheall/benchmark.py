@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+
+import RocketSim as rs
+
+import argparse
+import time
+
+GAME_MODES = {
+  "soccar":     rs.GameMode.SOCCAR,
+  "hoops":      rs.GameMode.HOOPS,
+  "heatseeker": rs.GameMode.HEATSEEKER,
+  "snowday":    rs.GameMode.SNOWDAY,
+  "the_void":   rs.GameMode.THE_VOID,
+}
+
+# best of a few runs, so other load on the machine matters less
+def best_time(fn, runs: int) -> float:
+  best = float("inf")
+  for i in range(runs):
+    start = time.perf_counter()
+    fn()
+    best = min(best, time.perf_counter() - start)
+
+  return best
+
+def moving_ball_state() -> rs.BallState:
+  return rs.BallState(pos=rs.Vec(-600.0, 800.0, 400.0), vel=rs.Vec(-1500.0, 2000.0, 800.0), ang_vel=rs.Vec(1.0, 2.0, 3.0))
+
+def bench_ball_prediction(game_mode: rs.GameMode, args) -> dict:
+  arena = rs.Arena(game_mode)
+  pred  = rs.BallPredictor(game_mode=game_mode)
+
+  def arena_pred():
+    arena.ball.set_state(moving_ball_state())
+    arena.step(args.ticks)
+
+  def predictor_pred():
+    pred.get_ball_prediction(moving_ball_state(), 0, args.ticks)
+
+  return {
+    "ball-only Arena": best_time(arena_pred, args.runs),
+    "BallPredictor":   best_time(predictor_pred, args.runs),
+  }
+
+def make_arena(game_mode: rs.GameMode, num_cars: int) -> rs.Arena:
+  arena = rs.Arena(game_mode)
+  for i in range(num_cars):
+    car = arena.add_car(rs.Team.BLUE if i % 2 == 0 else rs.Team.ORANGE)
+    car.set_controls(rs.CarControls(throttle=1.0, steer=0.3 if i % 2 == 0 else -0.3, boost=True))
+  arena.reset_kickoff(seed=0)
+  return arena
+
+# a 2v2 arena, so the per-gamemode step specializations are timed with cars, boost pads, and the ball
+def bench_step(game_mode: rs.GameMode, args) -> dict:
+  arena = make_arena(game_mode, 4)
+
+  def step():
+    arena.reset_kickoff(seed=0)
+    arena.step(args.ticks)
+
+  return {
+    "2v2 Arena": best_time(step, args.runs),
+  }
+
+# times are per tick of each arena
+def bench_vec_step(game_mode: rs.GameMode, args) -> dict:
+  arenas = [make_arena(game_mode, 4) for i in range(args.arenas)]
+
+  def reset():
+    for arena in arenas:
+      arena.reset_kickoff(seed=0)
+
+  def step():
+    reset()
+    for arena in arenas:
+      arena.step(args.ticks)
+
+  def vec_step():
+    reset()
+    rs.Arena.vec_step(arenas, args.ticks)
+
+  return {
+    "Arena.step":     best_time(step, args.runs) / args.arenas,
+    "Arena.vec_step": best_time(vec_step, args.runs) / args.arenas,
+  }
+
+BENCHMARKS = {
+  "ball_prediction": bench_ball_prediction,
+  "step":            bench_step,
+  "vec_step":        bench_vec_step,
+}
+
+if __name__ == "__main__":
+  parser = argparse.ArgumentParser(description="Times RocketSim in microseconds per tick")
+  parser.add_argument("benchmarks", nargs="*", help=f"benchmarks to run, any of {', '.join(BENCHMARKS)} (default all)")
+  parser.add_argument("--game-modes", nargs="+", choices=list(GAME_MODES), default=list(GAME_MODES))
+  parser.add_argument("--ticks", type=int, default=720)
+  parser.add_argument("--runs", type=int, default=5)
+  parser.add_argument("--arenas", type=int, default=8, help="arenas stepped together by vec_step")
+  parser.add_argument("--meshes", default="collision_meshes")
+  args = parser.parse_args()
+
+  for name in args.benchmarks:
+    if name not in BENCHMARKS:
+      parser.error(f"unknown benchmark '{name}'")
+
+  rs.init(args.meshes)
+
+  for name in args.benchmarks or BENCHMARKS:
+    for mode in args.game_modes:
+      for label, seconds in BENCHMARKS[name](GAME_MODES[mode], args).items():
+        print(f"{name:<16} {mode:<10} {label:<20} {seconds / args.ticks * 1e6:8.3f}us/tick")
@@ -6,8 +6,12 @@ import copy
 import glm
 import math
 import numpy as np
+import os
 import pickle
 import random
+import subprocess
+import sys
+import tempfile
 import unittest
 
 np.set_printoptions(formatter={"float": lambda x: f"{x: .6f}"}, linewidth=100)
@@ -1047,6 +1051,29 @@ class TestBallPredictor(FuzzyTestCase):
           TestBallState.compare(self, states[j], s[j - i], False)
           j += 1
 
+  def test_arena_parity(self):
+    for mode in (rs.GameMode.SOCCAR, rs.GameMode.HOOPS, rs.GameMode.HEATSEEKER, rs.GameMode.SNOWDAY, rs.GameMode.THE_VOID):
+      for tick_rate in (120.0, 60.0):
+        arena = rs.Arena(mode, tick_rate=tick_rate)
+
+        ball_state = arena.ball.get_state()
+        ball_state.pos = rs.Vec(500.0, -800.0, 300.0)
+        ball_state.vel = rs.Vec(1500.0, 2500.0, -400.0)
+        ball_state.ang_vel = rs.Vec(1.0, 2.0, 3.0)
+        arena.ball.set_state(ball_state)
+
+        pred = rs.BallPredictor(game_mode=mode, tick_rate=tick_rate)
+        states = pred.get_ball_prediction(arena.ball.get_state(), 0, 480, 1)
+        self.assertEqual(len(states), 480)
+
+        # the ball alone must follow the exact same path in an arena
+        for i in range(1, len(states)):
+          arena.step()
+          state = arena.ball.get_state()
+          self.assertEqual(states[i].pos,     state.pos)
+          self.assertEqual(states[i].vel,     state.vel)
+          self.assertEqual(states[i].ang_vel, state.ang_vel)
+
 class TestMutatorConfig(FuzzyTestCase):
   def compare(self, config_a, config_b):
     self.assertEqual(config_a.gravity,                    config_b.gravity)
@@ -1439,6 +1466,62 @@ class TestArena(FuzzyTestCase):
     for arena in arenas[1:]:
       self.compare(arena, arenas[0])
 
+  def test_multi_step_controls(self):
+    arenas = [rs.Arena(rs.GameMode.SOCCAR) for i in range(4)]
+
+    for i, arena in enumerate(arenas):
+      for j in range(i + 1):
+        arena.add_car(rs.Team.BLUE if j % 2 == 0 else rs.Team.ORANGE)
+
+    num_cars = sum(len(arena.get_cars()) for arena in arenas)
+    controls = np.random.uniform(-1.0, 1.0, (num_cars, 8)).astype(np.float32)
+    controls[:, 5:] = controls[:, 5:] > 0.0
+
+    rs.Arena.multi_step(arenas, 1, controls=controls)
+
+    row = 0
+    for arena in arenas:
+      for car in sorted(arena.get_cars(), key=lambda car: car.id):
+        c = car.get_controls()
+        self.assertTrue(np.allclose(controls[row],
+          [c.throttle, c.steer, c.pitch, c.yaw, c.roll, c.boost, c.jump, c.handbrake]))
+        row += 1
+
+    with self.assertRaises(ValueError):
+      rs.Arena.multi_step(arenas, 1, controls=controls[1:])
+
+    with self.assertRaises(ValueError):
+      rs.Arena.multi_step(arenas, 1, controls=controls.flatten())
+
+    with self.assertRaises(ValueError):
+      rs.Arena.multi_step(arenas, 1, controls=np.ascontiguousarray(controls.reshape(8, -1)))
+
+  def test_multi_step_sticky_pool(self):
+    rs.set_thread_pool(num_threads=2, affinity=[0], sticky=True)
+
+    try:
+      arenas = [rs.Arena(rs.GameMode.SOCCAR) for i in range(5)]
+
+      for arena in arenas:
+        arena.add_car(rs.Team.BLUE)
+        arena.reset_kickoff(seed=999)
+
+      for i in range(16):
+        rs.Arena.multi_step(arenas, 8)
+
+      # arenas keep stepping after their workers are gone
+      rs.set_thread_pool(num_threads=1, sticky=True)
+      for i in range(16):
+        rs.Arena.multi_step(arenas, 8)
+
+      for arena in arenas[1:]:
+        self.compare(arena, arenas[0])
+    finally:
+      rs.set_thread_pool()
+
+    with self.assertRaises(ValueError):
+      rs.set_thread_pool(affinity=[1 << 20])
+
   def test_multi_step_exception(self):
     class BallTouchError(Exception):
       def __init__(self):
@@ -1482,6 +1565,59 @@ class TestArena(FuzzyTestCase):
       rs.Arena.multi_step(arenas, 8)
     self.assertEqual(before, [arena.tick_count for arena in arenas[:-1]])
 
+  def test_vec_step(self):
+    # each arena steps the same as on its own, whatever else is in the batch
+    # (at most one car per team, as kickoff positions are shuffled between cars of the same team)
+    setups = [
+      (rs.GameMode.SOCCAR,   2),
+      (rs.GameMode.HOOPS,    1),
+      (rs.GameMode.SOCCAR,   0),
+      (rs.GameMode.THE_VOID, 1),
+      (rs.GameMode.SNOWDAY,  2),
+    ]
+
+    def ball_touch_callback(arena: rs.Arena, car: rs.Car, data):
+      arena.stop()
+
+    def make_arenas():
+      arenas = []
+      for mode, num_cars in setups:
+        arena = rs.Arena(mode)
+        for i in range(num_cars):
+          arena.add_car(rs.Team.BLUE if i % 2 == 0 else rs.Team.ORANGE)
+        arena.reset_kickoff(seed=0)
+        arenas.append(arena)
+
+      # stops its step on every touch
+      arenas[0].set_ball_touch_callback(ball_touch_callback)
+      return arenas
+
+    single = make_arenas()
+    vec    = make_arenas()
+
+    for i in range(200):
+      for arenas in (single, vec):
+        for arena in arenas:
+          for car in arena.get_cars():
+            target_chase(arena.ball.get_state().pos, car)
+
+        # cars added and removed between steps are stepped too
+        if i == 100:
+          car = arenas[2].add_car(rs.Team.ORANGE)
+          car.set_state(rs.CarState(pos=rs.Vec(0, 1000, 17)))
+          arenas[0].remove_car(min(car.id for car in arenas[0].get_cars()))
+
+      for arena in single:
+        arena.step(3)
+      rs.Arena.vec_step(vec, 3)
+
+    self.assertLess(vec[0].tick_count, vec[1].tick_count)
+    for arena_a, arena_b in zip(single, vec):
+      self.compare(arena_a, arena_b)
+
+    with self.assertRaisesRegex(RuntimeError, "Duplicate arena detected"):
+      rs.Arena.vec_step([vec[0], vec[0]])
+
   def test_set_car_ball_collision(self):
     arena = rs.Arena(rs.GameMode.SOCCAR)
     ball = arena.ball
@@ -1618,6 +1754,110 @@ class TestArena(FuzzyTestCase):
       arena.clone_into(clone)
       self.compare(arena, clone)
 
+  def test_snapshot(self):
+    def play(arena, controls):
+      states = []
+      for control in controls:
+        for car, car_controls in zip(sorted(arena.get_cars(), key=lambda car: car.id), control):
+          car.set_controls(car_controls)
+        arena.step(3)
+        states.append([car.get_state().pos for car in arena.get_cars()] + [arena.ball.get_state().pos])
+      return states
+
+    for mode in (rs.GameMode.SOCCAR, rs.GameMode.HEATSEEKER, rs.GameMode.THE_VOID):
+      arena = rs.Arena(mode)
+      for i in range(2):
+        random_car(arena, rs.Team.BLUE)
+        random_car(arena, rs.Team.ORANGE)
+      arena.reset_kickoff(seed=i)
+
+      def random_controls():
+        return [[rs.CarControls(throttle=random_float(), steer=random_float(), pitch=random_float(),
+          boost=random_bool(), jump=random.random() < 0.1, handbrake=random_bool()) for car in range(4)] for i in range(100)]
+
+      play(arena, random_controls())
+
+      # a car pushed into the floor makes the next tick use the solver time step left over from the last step
+      car = min(arena.get_cars(), key=lambda car: car.id)
+      car_state = car.get_state()
+      car_state.pos = rs.Vec(1500, 2000, 10)
+      car_state.rot_mat = rs.RotMat()
+      car_state.vel = rs.Vec(0, 0, 0)
+      car_state.ang_vel = rs.Vec(0, 0, 0)
+      car.set_state(car_state)
+
+      snapshot = arena.save_snapshot()
+      self.assertEqual(snapshot, arena.save_snapshot(snapshot))
+
+      tick_count = arena.tick_count
+      controls = random_controls()
+      states = play(arena, controls)
+
+      arena.restore_snapshot(snapshot)
+      self.assertEqual(arena.tick_count, tick_count)
+      self.assertTrue(play(arena, controls) == states)
+
+      # restoring into a new arena with the same cars, which has never stepped
+      fresh = rs.Arena(mode)
+      for car in sorted(arena.get_cars(), key=lambda car: car.id):
+        self.assertEqual(fresh.add_car(car.team, car.get_config()).id, car.id)
+      fresh.restore_snapshot(snapshot)
+      self.assertEqual(fresh.tick_count, tick_count)
+      self.assertTrue(play(fresh, controls) == states)
+
+      # restoring into another arena with the same setup
+      clone = arena.clone()
+      clone.restore_snapshot(snapshot)
+      arena.restore_snapshot(snapshot)
+      self.compare(arena, clone)
+
+      random_car(clone)
+      with self.assertRaises(ValueError):
+        clone.restore_snapshot(snapshot)
+
+  def test_reset(self):
+    for mode in (rs.GameMode.SOCCAR, rs.GameMode.HOOPS, rs.GameMode.THE_VOID):
+      arena = rs.Arena(mode)
+      for i in range(2):
+        random_car(arena, rs.Team.BLUE)
+        random_car(arena, rs.Team.ORANGE)
+
+      arena.reset_kickoff(seed=0)
+      for i in range(100):
+        for car in arena.get_cars():
+          car.set_controls(rs.CarControls(throttle=1, steer=random_float(), boost=random_bool()))
+        arena.step(7)
+
+      cars = arena.get_cars()
+      arena.reset()
+      self.assertEqual(arena.tick_count, 0)
+      self.assertEqual(arena.get_cars(), [])
+      with self.assertRaises(RuntimeError):
+        cars[0].get_state()
+
+      # a reset arena simulates the same as a new one
+      new_arena = rs.Arena(mode)
+      TestBall.compare(self, arena.ball, new_arena.ball)
+      for pad_a, pad_b in zip(arena.get_boost_pads(), new_arena.get_boost_pads()):
+        TestBoostPadState.compare(self, pad_a.get_state(), pad_b.get_state())
+
+      controls = [rs.CarControls(throttle=random_float(), steer=random_float(), boost=random_bool(),
+        jump=random.random() < 0.1) for i in range(100)]
+      states = []
+      for a in (arena, new_arena):
+        car = a.add_car(rs.Team.BLUE)
+        self.assertEqual(car.id, 1)
+        a.reset_kickoff(seed=0)
+
+        states.append([])
+        for car_controls in controls:
+          car.set_controls(car_controls)
+          a.step(3)
+          states[-1].append((car.get_state().pos, a.ball.get_state().pos))
+
+      self.assertTrue(states[0] == states[1])
+      self.compare(arena, new_arena)
+
   def test_pickle(self):
     for mode in (rs.GameMode.SOCCAR, rs.GameMode.HOOPS, rs.GameMode.HEATSEEKER, rs.GameMode.SNOWDAY, rs.GameMode.THE_VOID):
       arena = rs.Arena(mode)
@@ -1633,6 +1873,39 @@ class TestArena(FuzzyTestCase):
 
       self.compare(arena, pickled(arena))
 
+  def test_pickle_pool(self):
+    # unpickled arenas go back to a pool when destroyed, and later unpickles re-use them
+    for mode in (rs.GameMode.SOCCAR, rs.GameMode.HOOPS, rs.GameMode.HEATSEEKER, rs.GameMode.SNOWDAY, rs.GameMode.THE_VOID):
+      arena = rs.Arena(mode)
+      for i in range(2):
+        random_car(arena, rs.Team.BLUE)
+        random_car(arena, rs.Team.ORANGE)
+
+      for i in range(10):
+        for car in arena.get_cars():
+          target_chase(arena.ball.get_state().pos, car)
+        arena.step(7)
+
+      data = pickle.dumps(arena)
+
+      states = []
+      for i in range(2):
+        unpickled = pickle.loads(data)
+        self.compare(arena, unpickled)
+
+        states.append([])
+        for j in range(50):
+          for car in unpickled.get_cars():
+            target_chase(unpickled.ball.get_state().pos, car)
+          unpickled.step(3)
+          cars = sorted(unpickled.get_cars(), key=lambda car: car.id)
+          states[-1].append([car.get_state().pos for car in cars] + [unpickled.ball.get_state().pos])
+
+        # released to the pool here
+        del unpickled
+
+      self.assertTrue(states[0] == states[1])
+
   def test_copy(self):
     for mode in (rs.GameMode.SOCCAR, rs.GameMode.HOOPS, rs.GameMode.HEATSEEKER, rs.GameMode.SNOWDAY, rs.GameMode.THE_VOID):
       arena = rs.Arena(mode)
@@ -2145,5 +2418,420 @@ class TestArena(FuzzyTestCase):
         # we definitely should have hit the ball at least once with our actor
         self.assertNotEqual(state[0][1], 0)
 
+  def test_write_gym_state(self):
+    def flatten(state):
+      # get_gym_state gives an empty boost pad array a shape of (2,)
+      return np.concatenate([np.ravel(array) for array in state if array.shape != (2,)])
+
+    arenas = []
+    for mode in (rs.GameMode.SOCCAR, rs.GameMode.HOOPS, rs.GameMode.THE_VOID):
+      arena = rs.Arena(mode)
+      for i in range(len(arenas) + 1):
+        arena.add_car(rs.Team.BLUE)
+        arena.add_car(rs.Team.ORANGE)
+      arena.reset_kickoff(seed=len(arenas))
+      arenas.append(arena)
+
+    rs.Arena.multi_step(arenas, 30)
+
+    sizes = [arena.get_gym_state_size() for arena in arenas]
+    out   = np.zeros(sum(sizes) + 1, dtype=np.float32)
+
+    self.assertEqual(rs.Arena.multi_write_gym_state(arenas, out), sum(sizes))
+
+    offset = 0
+    for arena, size in zip(arenas, sizes):
+      self.assertTrue(np.array_equal(out[offset:offset + size], flatten(arena.get_gym_state())))
+      self.assertEqual(arena.write_gym_state(out, offset), size)
+      offset += size
+
+    with self.assertRaises(ValueError):
+      arenas[0].write_gym_state(out, len(out) - sizes[0] + 1)
+
+    with self.assertRaises(TypeError):
+      arenas[0].write_gym_state(np.zeros(sizes[0], dtype=np.float64))
+
+  def test_multi_step_export(self):
+    arenas = [rs.Arena(rs.GameMode.SOCCAR) for i in range(3)]
+    for i, arena in enumerate(arenas):
+      for j in range(i + 1):
+        arena.add_car(rs.Team.BLUE if j % 2 == 0 else rs.Team.ORANGE)
+      arena.reset_kickoff(seed=i)
+
+    # the first car flies into the ball, so it's sure to touch it
+    arenas[0].ball.set_state(rs.BallState(pos=rs.Vec(0, 0, 1000)))
+    car_state = arenas[0].get_cars()[0].get_state()
+    car_state.pos = rs.Vec(0, -300, 1000)
+    car_state.vel = rs.Vec(0, 1500, 0)
+    arenas[0].get_cars()[0].set_state(car_state)
+
+    num_cars = sum(len(arena.get_cars()) for arena in arenas)
+    controls = np.zeros((num_cars, 8), dtype=np.float32)
+    controls[:, 0] = 1.0
+    controls[:, 5] = 1.0
+
+    sizes  = [arena.get_gym_state_size() for arena in arenas]
+    obs    = np.zeros(sum(sizes), dtype=np.float32)
+    events = np.zeros((num_cars, 4), dtype=np.float32)
+    dones  = np.ones(len(arenas), dtype=np.float32)
+
+    touches = np.zeros(num_cars)
+    for i in range(120):
+      rs.Arena.multi_step_export(arenas, 1, controls, obs, events, dones)
+      touches += events[:, 0]
+
+    self.assertTrue(np.all(dones == 0.0))
+    self.assertGreater(touches[0], 0)
+
+    offset = 0
+    for arena, size in zip(arenas, sizes):
+      check = np.zeros(size, dtype=np.float32)
+      arena.write_gym_state(check)
+      self.assertTrue(np.array_equal(obs[offset:offset + size], check))
+      offset += size
+
+    # event counts are running totals, which copies of the arena keep
+    with tempfile.TemporaryDirectory() as tmp:
+      recorded = []
+      for i, arena in enumerate((arenas[0], pickled(arenas[0]), arenas[0].clone())):
+        path = os.path.join(tmp, f"recording{i}.bin")
+        with rs.ArenaRecorder(arena, path):
+          arena.step(1)
+
+        recording = rs.ArenaRecording(path)
+        recorded.append(recording.get_column("car_events").copy())
+        del recording
+
+      self.assertGreaterEqual(recorded[0][0, 0, 0], touches[0])
+      for events_copy in recorded[1:]:
+        self.assertTrue(np.array_equal(events_copy, recorded[0]))
+
+    # ball sitting in the goal ends the step after one tick
+    ball_state = arenas[0].ball.get_state()
+    ball_state.pos = rs.Vec(0, 5200, 100)
+    arenas[0].ball.set_state(ball_state)
+
+    tick_count = arenas[0].tick_count
+    rs.Arena.multi_step_export(arenas, 8, dones=dones)
+    self.assertEqual(arenas[0].tick_count, tick_count + 1)
+    self.assertTrue(np.array_equal(dones, [1.0, 0.0, 0.0]))
+
+    with self.assertRaises(ValueError):
+      rs.Arena.multi_step_export(arenas, 1, events=events[1:])
+
+  def test_predict_balls(self):
+    arena = rs.Arena(rs.GameMode.SOCCAR)
+
+    states = np.zeros((4, 18), dtype=np.float32)
+    for i in range(len(states)):
+      states[i, 0:3] = (i * 500 - 750, i * 300, 200 + i * 100)
+      states[i, 3:6] = (1000 - i * 600, i * 800 - 1200, 500)
+      states[i, 6:9] = (i, -i, 1)
+      states[i, 9:18] = (1, 0, 0, 0, 1, 0, 0, 0, 1)
+
+    out = np.zeros((len(states), 30, 18), dtype=np.float32)
+    rs.predict_balls(states, 30, 4, out)
+
+    for i in range(len(states)):
+      ball_state = rs.BallState()
+      ball_state.pos     = rs.Vec(*states[i, 0:3])
+      ball_state.vel     = rs.Vec(*states[i, 3:6])
+      ball_state.ang_vel = rs.Vec(*states[i, 6:9])
+      arena.ball.set_state(ball_state)
+
+      for j in range(1, out.shape[1]):
+        arena.step(4)
+        ball_state = arena.ball.get_state()
+        self.assertEqual(ball_state.pos.as_tuple(), tuple(out[i, j, 0:3]))
+        self.assertEqual(ball_state.vel.as_tuple(), tuple(out[i, j, 3:6]))
+
+    # rotation columns are optional
+    out9 = np.zeros((len(states), 30, 9), dtype=np.float32)
+    rs.predict_balls(np.ascontiguousarray(states[:, 0:9]), 30, 4, out9)
+    self.assertTrue(np.array_equal(out9, out[:, :, 0:9]))
+
+    with self.assertRaises(ValueError):
+      rs.predict_balls(states, 30, 4, out9)
+
+    with self.assertRaises(ValueError):
+      rs.predict_balls(states, 30, 0, out)
+
+  def test_shared_memory_weight_mode(self):
+    with self.assertRaises(ValueError):
+      config = rs.ArenaConfig(memory_weight_mode=rs.MemoryWeightMode.SHARED, use_custom_broadphase=False)
+      rs.Arena(rs.GameMode.SOCCAR, config=config)
+
+    arenas = [rs.Arena(rs.GameMode.SOCCAR, memory_weight_mode=mode)
+      for mode in (rs.MemoryWeightMode.HEAVY, rs.MemoryWeightMode.SHARED, rs.MemoryWeightMode.SHARED)]
+
+    for arena in arenas:
+      for i in range(4):
+        car = arena.add_car(rs.Team.BLUE if i % 2 == 0 else rs.Team.ORANGE)
+        car_state = rs.CarState()
+        car_state.pos = rs.Vec(i * 1000 - 1500, 3000 if i % 2 else -3000, 17)
+        car.set_state(car_state)
+
+      ball_state = arena.ball.get_state()
+      ball_state.vel = rs.Vec(900, 1300, 1200)
+      arena.ball.set_state(ball_state)
+
+    for i in range(1200):
+      if i % 30 == 0:
+        controls = [rs.CarControls(throttle=random.uniform(-1, 1), steer=random.uniform(-1, 1),
+          boost=random_bool(), jump=random.random() < 0.1) for j in range(4)]
+        for arena in arenas:
+          for car, control in zip(sorted(arena.get_cars(), key=lambda car: car.id), controls):
+            car.set_controls(control)
+
+      for arena in arenas:
+        arena.step(1)
+
+      for arena in arenas[1:]:
+        self.assertEqual(arena.ball.get_state().pos, arenas[0].ball.get_state().pos)
+        for a, b in zip(sorted(arena.get_cars(), key=lambda car: car.id), sorted(arenas[0].get_cars(), key=lambda car: car.id)):
+          self.assertEqual(a.get_state().pos, b.get_state().pos)
+          self.assertEqual(a.get_state().vel, b.get_state().vel)
+
+    # the shared collision is freed along with the last arena using it, and built again for the next one
+    del arenas
+    arena = rs.Arena(rs.GameMode.SOCCAR, memory_weight_mode=rs.MemoryWeightMode.SHARED)
+    arena.ball.set_state(rs.BallState(vel=rs.Vec(900, 1300, 1200)))
+    arena.step(240)
+    self.assertLess(arena.ball.get_state().pos.z, 2100)
+
+  def test_recorder(self):
+    for compress in (True, False):
+      arena = rs.Arena(rs.GameMode.SOCCAR)
+      cars = [arena.add_car(rs.Team.BLUE if i % 2 == 0 else rs.Team.ORANGE) for i in range(4)]
+      arena.reset_kickoff(random.randint(0, 4))
+
+      expected = []
+      with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "recording.bin")
+        with rs.ArenaRecorder(arena, path, chunk_ticks=100, compress=compress) as recorder:
+          for i in range(450):
+            if i % 30 == 0:
+              for car in cars:
+                car.set_controls(rs.CarControls(throttle=random.uniform(-1, 1), steer=random.uniform(-1, 1),
+                  boost=random_bool(), jump=random.random() < 0.1))
+            arena.step(1)
+
+            car_state = cars[1].get_state()
+            expected.append((arena.tick_count, arena.ball.get_state().pos.as_numpy(), car_state.pos.as_numpy(),
+              car_state.boost, cars[1].get_controls().jump))
+
+          self.assertTrue(recorder.is_open)
+          self.assertEqual(recorder.num_ticks, 450)
+
+        self.assertFalse(recorder.is_open)
+
+        recording = rs.ArenaRecording(path)
+        self.assertEqual(recording.compressed, compress)
+        self.assertEqual(recording.num_ticks, 450)
+        self.assertEqual(recording.num_chunks, 5)
+        self.assertEqual(recording.car_ids, sorted(car.id for car in cars))
+        self.assertEqual(recording.num_boost_pads, len(arena.get_boost_pads()))
+
+        ticks = recording.get_column("tick")
+        ball_pos = recording.get_column("ball_pos")
+        car_pos = recording.get_column("car_pos")
+        car_boost = recording.get_column("car_boost")
+        car_buttons = recording.get_column("car_buttons")
+        self.assertEqual(car_pos.shape, (450, 4, 3))
+
+        index = recording.car_ids.index(cars[1].id)
+        for i, (tick, ball, car, boost, jump) in enumerate(expected):
+          self.assertEqual(ticks[i], tick)
+          self.assertTrue(np.array_equal(ball_pos[i], ball))
+          self.assertTrue(np.array_equal(car_pos[i, index], car))
+          self.assertEqual(car_boost[i, index], np.float32(boost))
+          self.assertEqual(car_buttons[i, index, 0], jump)
+
+        chunk = recording.get_chunk(-1)
+        self.assertEqual(chunk["ball_pos"].shape, (50, 3))
+        self.assertTrue(np.array_equal(chunk["ball_pos"], ball_pos[400:]))
+        self.assertEqual(chunk["ball_pos"].flags.writeable, compress)
+
+        del chunk, ticks, ball_pos, car_pos, car_boost, car_buttons, recording
+
+  def test_recorder_vec_step(self):
+    # arenas stepped together with vec_step record every tick, same as stepping them on their own
+    arenas = [rs.Arena(rs.GameMode.SOCCAR), rs.Arena(rs.GameMode.HOOPS)]
+    for arena in arenas:
+      arena.add_car(rs.Team.BLUE)
+      arena.add_car(rs.Team.ORANGE)
+      arena.reset_kickoff(seed=0)
+
+    expected = [[] for arena in arenas]
+    with tempfile.TemporaryDirectory() as tmp:
+      paths = [os.path.join(tmp, f"recording{i}.bin") for i in range(len(arenas))]
+      recorders = [rs.ArenaRecorder(arena, path, chunk_ticks=64) for arena, path in zip(arenas, paths)]
+
+      for i in range(50):
+        for arena in arenas:
+          for car in arena.get_cars():
+            target_chase(arena.ball.get_state().pos, car)
+        rs.Arena.vec_step(arenas, 3)
+
+        for arena, ticks in zip(arenas, expected):
+          ticks.append((arena.tick_count, arena.ball.get_state().pos.as_numpy()))
+
+      for recorder in recorders:
+        self.assertEqual(recorder.num_ticks, 150)
+        recorder.close()
+
+      for path, ticks in zip(paths, expected):
+        recording = rs.ArenaRecording(path)
+        self.assertEqual(recording.num_ticks, 150)
+
+        tick = recording.get_column("tick")
+        ball_pos = recording.get_column("ball_pos")
+        for i, (tick_count, pos) in enumerate(ticks):
+          self.assertEqual(tick[i * 3 + 2], tick_count)
+          self.assertTrue(np.array_equal(ball_pos[i * 3 + 2], pos))
+
+        del tick, ball_pos, recording
+
+  def test_replay(self):
+    def state(arena):
+      # pickled, so states are compared bit-for-bit
+      return (pickle.dumps(arena.ball.get_state()),
+        {car.id: pickle.dumps(car.get_state()) for car in arena.get_cars()})
+
+    def player_state(player):
+      return (pickle.dumps(player.get_ball_state()),
+        {car_id: pickle.dumps(player.get_car_state(car_id)) for car_id in player.car_ids})
+
+    arena = rs.Arena(rs.GameMode.SOCCAR)
+    cars = [arena.add_car(rs.Team.BLUE), arena.add_car(rs.Team.ORANGE)]
+    arena.reset_kickoff(seed=0)
+
+    expected = []
+    with tempfile.TemporaryDirectory() as tmp:
+      path = os.path.join(tmp, "replay.bin")
+      with rs.ReplayRecorder(arena, path, keyframe_interval=64) as recorder:
+        for i in range(300):
+          # changes between steps are stored as keyframes
+          if i == 150:
+            arena.ball.set_state(rs.BallState(pos=rs.Vec(0, 0, 500), vel=rs.Vec(300, -700, 900)))
+          if i == 200:
+            cars.append(arena.add_car(rs.Team.BLUE))
+
+          if i % 20 == 0:
+            for car in cars:
+              car.set_controls(rs.CarControls(throttle=random_float(), steer=random_float(), pitch=random_float(),
+                boost=random_bool(), jump=random.random() < 0.1, handbrake=random_bool()))
+
+          expected.append(state(arena))
+          arena.step(1)
+
+        expected.append(state(arena))
+        self.assertTrue(recorder.is_open)
+        self.assertEqual(recorder.num_ticks, 300)
+
+      self.assertFalse(recorder.is_open)
+
+      player = rs.ReplayPlayer(path)
+      self.assertEqual(player.num_ticks, 300)
+      self.assertEqual(player.keyframe_ticks[0], 0)
+      self.assertIn(150, player.keyframe_ticks)
+      self.assertIn(200, player.keyframe_ticks)
+
+      with self.assertRaises(RuntimeError):
+        player.get_ball_state()
+
+      # seeking forward, backward, and to the end, then re-simulating from there
+      for tick in (0, 37, 64, 149, 150, 199, 250, 100, 1, 290, 300):
+        player.seek(tick)
+        self.assertEqual(player.tick, tick)
+        self.assertEqual(player.car_ids, sorted(expected[tick][1]))
+        self.assertTrue(player_state(player) == expected[tick])
+
+        ticks = min(10, 300 - tick)
+        for i in range(ticks):
+          player.step()
+          self.assertTrue(player_state(player) == expected[tick + i + 1])
+
+      player.seek(290)
+      player.step(10)
+      self.assertTrue(player_state(player) == expected[300])
+
+      with self.assertRaises(ValueError):
+        player.step()
+      with self.assertRaises(ValueError):
+        player.seek(301)
+      with self.assertRaises(KeyError):
+        player.get_car_state(max(player.car_ids) + 1)
+
+      del player
+
+# RocketSim is only initialized once per process, so every init with a mesh cache runs in its own process
+MESH_CACHE_SCRIPT = """
+import RocketSim as rs
+import pickle
+import random
+import sys
+
+if len(sys.argv) > 1:
+  rs.init(mesh_cache=sys.argv[1])
+
+rng = random.Random(0)
+states = []
+for mode in (rs.GameMode.SOCCAR, rs.GameMode.HOOPS):
+  arena = rs.Arena(mode)
+  cars = [arena.add_car(rs.Team.BLUE), arena.add_car(rs.Team.ORANGE)]
+  arena.reset_kickoff(seed=0)
+
+  # into a corner, so the ball and cars hit the arena meshes
+  arena.ball.set_state(rs.BallState(pos=rs.Vec(2000, 3000, 500), vel=rs.Vec(3000, 3000, 500)))
+  for car in cars:
+    car_state = car.get_state()
+    car_state.vel = rs.Vec(1000, 1000, 0)
+    car.set_state(car_state)
+
+  for i in range(600):
+    if i % 30 == 0:
+      for car in cars:
+        car.set_controls(rs.CarControls(throttle=1.0, steer=rng.uniform(-1, 1), boost=rng.random() < 0.5,
+          jump=rng.random() < 0.1))
+    arena.step(1)
+    states.append(pickle.dumps([arena.ball.get_state()] + [car.get_state() for car in cars]))
+
+sys.stdout.buffer.write(pickle.dumps(states))
+"""
+
+class TestMeshCache(FuzzyTestCase):
+  def run_script(self, *args):
+    env = dict(os.environ, PYTHONPATH=os.pathsep.join(sys.path))
+    return pickle.loads(subprocess.run([sys.executable, "-c", MESH_CACHE_SCRIPT, *args], env=env,
+      stdout=subprocess.PIPE, check=True).stdout)
+
+  def test_mesh_cache(self):
+    expected = self.run_script()
+
+    with tempfile.TemporaryDirectory() as tmp:
+      path = os.path.join(tmp, "meshes.cache")
+
+      # written by the first init, then loaded by the next
+      self.assertTrue(self.run_script(path) == expected)
+      self.assertTrue(os.path.isfile(path))
+
+      with open(path, "rb") as f:
+        cache = f.read()
+
+      # writing the cache replaces the file, loading it leaves the file alone
+      inode = os.stat(path).st_ino
+      self.assertTrue(self.run_script(path) == expected)
+      self.assertEqual(os.stat(path).st_ino, inode)
+
+      # a damaged cache is not loaded, and gets written again
+      with open(path, "wb") as f:
+        f.write(cache[:len(cache) // 2])
+
+      self.assertTrue(self.run_script(path) == expected)
+      self.assertNotEqual(os.stat(path).st_ino, inode)
+      with open(path, "rb") as f:
+        self.assertTrue(f.read() == cache)
+
 if __name__ == "__main__":
   unittest.main()
@@ -0,0 +1,294 @@
+#include "CollisionMeshCache.h"
+
+#include "../RocketSim.h"
+#include "../DataStream/DataStreamOut.h"
+
+#include "../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
+#include "../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btOptimizedBvh.h"
+#include "../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h"
+#include "../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btTriangleInfoMap.h"
+
+RS_NS_START
+
+// Arrays in the cache start at this alignment, so they can be used in place
+constexpr size_t MESH_CACHE_ALIGNMENT = 16;
+
+// Sizes of everything stored in native layout, a cache written by a build where any of these differ can't be used
+static std::vector<uint32_t> GetCacheLayout() {
+	return {
+		RS_IS_BIG_ENDIAN,
+		sizeof(btScalar), sizeof(btVector3), sizeof(btQuantizedBvhNode), sizeof(btBvhSubtreeInfo), sizeof(btTriangleInfo),
+	};
+}
+
+// Arrays are stored exactly as they are in memory, unlike the rest of the stream
+static void WriteArray(DataStreamOut& out, const void* data, size_t size) {
+	while (out.GetSize() % MESH_CACHE_ALIGNMENT)
+		out.Write<uint8_t>(0);
+
+	if (size > 0)
+		memcpy(out._Claim(size), data, size);
+}
+
+// Get an array written by WriteArray() without copying it, or NULL if the stream is too short
+template <typename T>
+static const T* ReadArray(DataStreamIn& in, size_t amount) {
+	in.pos = (in.pos + MESH_CACHE_ALIGNMENT - 1) / MESH_CACHE_ALIGNMENT * MESH_CACHE_ALIGNMENT;
+	if (amount > in.GetNumBytesLeft() / sizeof(T)) {
+		in.pos = in.GetSize() + 1;
+		return NULL;
+	}
+
+	const T* result = (const T*)(in.GetData() + in.pos);
+	in.pos += amount * sizeof(T);
+	return result;
+}
+
+struct CachedMesh {
+	btVector3 localAabbMin, localAabbMax;
+	btVector3 bvhAabbMin, bvhAabbMax, bvhQuantization;
+
+	// btTriangleInfoMap thresholds, from m_convexEpsilon to m_zeroAreaThreshold
+	btScalar infoMapParams[6];
+
+	uint32_t numVerts, numTris, numNodes, numSubtreeHeaders, numInfos;
+
+	// In the mapped cache
+	const btVector3* verts;
+	const uint32_t* indices;
+	const btQuantizedBvhNode* nodes;
+	const btBvhSubtreeInfo* subtreeHeaders;
+	const int* infoKeys;
+	const btTriangleInfo* infos;
+};
+
+static void WriteMesh(DataStreamOut& out, const CollisionMeshFile& meshFile, btBvhTriangleMeshShape* mesh) {
+	constexpr char ERROR_PREFIX[] = "CollisionMeshCache::Write(): ";
+
+	const unsigned char* vertexBase;
+	const unsigned char* indexBase;
+	int numVerts, vertexStride, indexStride, numTris;
+	mesh->getMeshInterface()->getLockedReadOnlyVertexIndexBase(&vertexBase, numVerts, vertexStride, &indexBase, indexStride, numTris);
+
+	if (mesh->getMeshInterface()->getNumSubParts() != 1 || vertexStride != sizeof(btVector3) || indexStride != sizeof(uint32_t) * 3)
+		RS_ERR_CLOSE(ERROR_PREFIX << "Arena collision mesh is not laid out like a built mesh");
+
+	btOptimizedBvh* bvh = mesh->getOptimizedBvh();
+	if (!bvh || !bvh->isQuantized())
+		RS_ERR_CLOSE(ERROR_PREFIX << "Arena collision mesh has no quantized BVH");
+
+	btTriangleInfoMap* infoMap = mesh->getTriangleInfoMap();
+	if (!infoMap)
+		RS_ERR_CLOSE(ERROR_PREFIX << "Arena collision mesh has no triangle info map");
+
+	out.Write<uint32_t>(meshFile.hash);
+	out.Write<uint32_t>(numVerts);
+	out.Write<uint32_t>(numTris);
+
+	out.Write<btVector3>(mesh->getLocalAabbMin());
+	out.Write<btVector3>(mesh->getLocalAabbMax());
+	out.Write<btVector3>(bvh->getBvhAabbMin());
+	out.Write<btVector3>(bvh->getBvhAabbMax());
+	out.Write<btVector3>(bvh->getBvhQuantization());
+
+	btScalar infoMapParams[] = {
+		infoMap->m_convexEpsilon, infoMap->m_planarEpsilon, infoMap->m_equalVertexThreshold,
+		infoMap->m_edgeDistanceThreshold, infoMap->m_maxEdgeAngleThreshold, infoMap->m_zeroAreaThreshold
+	};
+	for (btScalar param : infoMapParams)
+		out.Write<btScalar>(param);
+
+	out.Write<uint32_t>(bvh->getNumUsedNodes());
+	out.Write<uint32_t>(bvh->getSubtreeInfoArray().size());
+	out.Write<uint32_t>(infoMap->size());
+
+	// Triangle infos in the map's order, so inserting them again gives the same map
+	std::vector<int> infoKeys;
+	std::vector<btTriangleInfo> infos;
+	for (int i = 0; i < infoMap->size(); i++) {
+		infoKeys.push_back(infoMap->getKeyAtIndex(i).getUid1());
+		infos.push_back(*infoMap->getAtIndex(i));
+	}
+
+	WriteArray(out, vertexBase, numVerts * sizeof(btVector3));
+	WriteArray(out, indexBase, numTris * sizeof(uint32_t) * 3);
+	WriteArray(out, &bvh->getQuantizedNodeArray()[0], bvh->getNumUsedNodes() * sizeof(btQuantizedBvhNode));
+	WriteArray(out, &bvh->getSubtreeInfoArray()[0], bvh->getSubtreeInfoArray().size() * sizeof(btBvhSubtreeInfo));
+	WriteArray(out, infoKeys.data(), infoKeys.size() * sizeof(int));
+	WriteArray(out, infos.data(), infos.size() * sizeof(btTriangleInfo));
+}
+
+static bool ReadMesh(DataStreamIn& in, const CollisionMeshFile& meshFile, CachedMesh& result) {
+	uint32_t hash = in.Read<uint32_t>();
+	result.numVerts = in.Read<uint32_t>();
+	result.numTris = in.Read<uint32_t>();
+	if (hash != meshFile.hash || result.numVerts != meshFile.vertices.size() || result.numTris != meshFile.tris.size())
+		return false;
+
+	result.localAabbMin = in.Read<btVector3>();
+	result.localAabbMax = in.Read<btVector3>();
+	result.bvhAabbMin = in.Read<btVector3>();
+	result.bvhAabbMax = in.Read<btVector3>();
+	result.bvhQuantization = in.Read<btVector3>();
+
+	for (btScalar& param : result.infoMapParams)
+		param = in.Read<btScalar>();
+
+	result.numNodes = in.Read<uint32_t>();
+	result.numSubtreeHeaders = in.Read<uint32_t>();
+	result.numInfos = in.Read<uint32_t>();
+
+	result.verts = ReadArray<btVector3>(in, result.numVerts);
+	result.indices = ReadArray<uint32_t>(in, result.numTris * 3);
+	result.nodes = ReadArray<btQuantizedBvhNode>(in, result.numNodes);
+	result.subtreeHeaders = ReadArray<btBvhSubtreeInfo>(in, result.numSubtreeHeaders);
+	result.infoKeys = ReadArray<int>(in, result.numInfos);
+	result.infos = ReadArray<btTriangleInfo>(in, result.numInfos);
+
+	if (in.IsOverflown())
+		return false;
+
+	// Mesh hashes are only of the truncated vertex positions, so make sure the mesh is exactly the same
+	for (uint32_t i = 0; i < result.numVerts; i++) {
+		const CollisionMeshFile::Vertex& vert = meshFile.vertices[i];
+		if (result.verts[i] != btVector3(vert.x, vert.y, vert.z))
+			return false;
+	}
+
+	for (uint32_t i = 0; i < result.numTris; i++)
+		for (int j = 0; j < 3; j++)
+			if (result.indices[i * 3 + j] != (uint32_t)meshFile.tris[i].vertexIndexes[j])
+				return false;
+
+	return true;
+}
+
+static btBvhTriangleMeshShape* MakeMesh(const CachedMesh& cachedMesh) {
+	btIndexedMesh indexedMesh;
+	indexedMesh.m_numTriangles = cachedMesh.numTris;
+	indexedMesh.m_triangleIndexBase = (const unsigned char*)cachedMesh.indices;
+	indexedMesh.m_triangleIndexStride = sizeof(uint32_t) * 3;
+	indexedMesh.m_numVertices = cachedMesh.numVerts;
+	indexedMesh.m_vertexBase = (const unsigned char*)cachedMesh.verts;
+	indexedMesh.m_vertexStride = sizeof(btVector3);
+
+	auto meshInterface = new btTriangleIndexVertexArray();
+	meshInterface->addIndexedMesh(indexedMesh);
+
+	// Otherwise the shape would go through every triangle to calculate it again
+	meshInterface->setPremadeAabb(cachedMesh.localAabbMin, cachedMesh.localAabbMax);
+
+	// Static meshes never refit their BVH, so the nodes are only ever read from
+	auto bvh = new btOptimizedBvh();
+	bvh->initializeQuantizedFromBuffers(
+		cachedMesh.bvhAabbMin, cachedMesh.bvhAabbMax, cachedMesh.bvhQuantization,
+		(btQuantizedBvhNode*)cachedMesh.nodes, cachedMesh.numNodes,
+		(btBvhSubtreeInfo*)cachedMesh.subtreeHeaders, cachedMesh.numSubtreeHeaders
+	);
+
+	auto mesh = new btBvhTriangleMeshShape(meshInterface, true, false);
+	mesh->setOptimizedBvh(bvh);
+
+	auto infoMap = new btTriangleInfoMap();
+	infoMap->m_convexEpsilon = cachedMesh.infoMapParams[0];
+	infoMap->m_planarEpsilon = cachedMesh.infoMapParams[1];
+	infoMap->m_equalVertexThreshold = cachedMesh.infoMapParams[2];
+	infoMap->m_edgeDistanceThreshold = cachedMesh.infoMapParams[3];
+	infoMap->m_maxEdgeAngleThreshold = cachedMesh.infoMapParams[4];
+	infoMap->m_zeroAreaThreshold = cachedMesh.infoMapParams[5];
+	for (uint32_t i = 0; i < cachedMesh.numInfos; i++)
+		infoMap->insert(cachedMesh.infoKeys[i], cachedMesh.infos[i]);
+	mesh->setTriangleInfoMap(infoMap);
+
+	return mesh;
+}
+
+void CollisionMeshCache::Write(std::filesystem::path filePath, const std::map<GameMode, std::vector<CollisionMeshFile>>& meshFilesMap) {
+	constexpr char ERROR_PREFIX[] = "CollisionMeshCache::Write(): ";
+
+	DataStreamOut out = {};
+	out.Write<uint32_t>(RS_VERSION_ID);
+	out.Write<uint32_t>(MESH_CACHE_MAGIC);
+
+	std::vector<uint32_t> layout = GetCacheLayout();
+	out.Write<uint32_t>(layout.size());
+	for (uint32_t size : layout)
+		out.Write<uint32_t>(size);
+
+	out.Write<uint32_t>(meshFilesMap.size());
+	for (auto& mapPair : meshFilesMap) {
+		GameMode gameMode = mapPair.first;
+		auto& meshFiles = mapPair.second;
+		auto& meshes = RocketSim::GetArenaCollisionShapes(gameMode);
+
+		if (meshes.size() != meshFiles.size())
+			RS_ERR_CLOSE(ERROR_PREFIX << "Have " << meshes.size() << " " << GAMEMODE_STRS[(int)gameMode] << " arena collision meshes, but " << meshFiles.size() << " mesh files");
+
+		out.Write<uint8_t>((uint8_t)gameMode);
+		out.Write<uint32_t>(meshes.size());
+		for (size_t i = 0; i < meshes.size(); i++)
+			WriteMesh(out, meshFiles[i], meshes[i]);
+	}
+
+	// Other processes could be loading or writing the same cache, so it's only replaced once fully written
+	std::filesystem::path tempPath = filePath;
+	tempPath += ".tmp" + std::to_string(std::random_device()());
+	out.WriteToFile(tempPath, false);
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, filePath, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		RS_ERR_CLOSE(ERROR_PREFIX << "Failed to write to file " << filePath << ", cannot replace file.");
+	}
+}
+
+bool CollisionMeshCache::Load(std::filesystem::path filePath, const std::map<GameMode, std::vector<CollisionMeshFile>>& meshFilesMap) {
+	auto mappedFile = std::make_shared<MappedFile>(filePath);
+	if (!mappedFile->GetData())
+		return false;
+
+	DataStreamIn in = DataStreamIn(mappedFile->GetData(), mappedFile->GetSize());
+	if (!in.DoVersionCheck() || in.Read<uint32_t>() != MESH_CACHE_MAGIC)
+		return false;
+
+	std::vector<uint32_t> layout = GetCacheLayout();
+	if (in.Read<uint32_t>() != layout.size())
+		return false;
+	for (uint32_t size : layout)
+		if (in.Read<uint32_t>() != size)
+			return false;
+
+	if (in.Read<uint32_t>() != meshFilesMap.size())
+		return false;
+
+	// Nothing is made until the whole cache is known to match
+	std::map<GameMode, std::vector<CachedMesh>> cachedMeshesMap;
+	for (auto& mapPair : meshFilesMap) {
+		GameMode gameMode = mapPair.first;
+		auto& meshFiles = mapPair.second;
+
+		if (in.Read<uint8_t>() != (uint8_t)gameMode || in.Read<uint32_t>() != meshFiles.size())
+			return false;
+
+		auto& cachedMeshes = cachedMeshesMap[gameMode];
+		cachedMeshes.resize(meshFiles.size());
+		for (size_t i = 0; i < meshFiles.size(); i++)
+			if (!ReadMesh(in, meshFiles[i], cachedMeshes[i]))
+				return false;
+	}
+
+	for (auto& mapPair : cachedMeshesMap) {
+		auto& meshes = RocketSim::GetArenaCollisionShapes(mapPair.first);
+		for (const CachedMesh& cachedMesh : mapPair.second)
+			meshes.push_back(MakeMesh(cachedMesh));
+	}
+
+	// The meshes use the cache in place, and are never freed either
+	static std::shared_ptr<MappedFile> loadedCache;
+	loadedCache = mappedFile;
+
+	return true;
+}
+
+RS_NS_END
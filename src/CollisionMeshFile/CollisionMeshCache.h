@@ -0,0 +1,24 @@
+#pragma once
+#include "CollisionMeshFile.h"
+#include "../Sim/GameMode.h"
+
+RS_NS_START
+
+// Follows the RocketSim version ID at the start of mesh cache files
+constexpr uint32_t MESH_CACHE_MAGIC = 0x48434D53; // "SMCH"
+
+// Stores the arena collision shapes RocketSim::Init() builds from the collision mesh files (triangles, BVHs, and triangle info maps),
+//	so that they can be loaded instead of built again in every process
+// The triangles and BVHs are used in place from the memory-mapped cache, so every process loading it shares those pages
+// NOTE: Caches are stored in native byte order and layout, and are only loaded by the same version and build of RocketSim
+namespace CollisionMeshCache {
+	// Writes the arena collision shapes that were built from these mesh files
+	// The cache is written to a temporary file that then replaces it, so it's never seen partially written
+	void Write(std::filesystem::path filePath, const std::map<GameMode, std::vector<CollisionMeshFile>>& meshFilesMap);
+
+	// Loads the arena collision shapes of these mesh files from the cache
+	// Returns false if there is no cache, or it was not written from the exact same mesh files by this build
+	bool Load(std::filesystem::path filePath, const std::map<GameMode, std::vector<CollisionMeshFile>>& meshFilesMap);
+}
+
+RS_NS_END
@@ -38,7 +38,7 @@ void CollisionMeshFile::ReadFromStream(DataStreamIn& in, bool silent, std::strin
 	if (in.IsOverflown()) {
 		RS_ERR_CLOSE(
 			ERROR_PREFIX_STR << "Invalid collision mesh file at \"" << filePath <<
-			"\" (input data overflown by " << (in.pos - in.data.size()) << " bytes!)");
+			"\" (input data overflown by " << (in.pos - in.GetSize()) << " bytes!)");
 	}
 
 	// Verify that the triangle data is correct
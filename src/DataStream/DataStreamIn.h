@@ -2,58 +2,81 @@
 #include "../BaseInc.h"
 
 #include "SerializeObject.h"
+#include "MappedFile.h"
 
 #include <cstring>
+#include <memory>
 
 RS_NS_START
 // Basic struct for reading raw data from a file
+// Reads from its own buffer (data), or without copying from a caller-provided buffer or a memory-mapped file
 struct DataStreamIn {
 	std::vector<byte> data;
 	size_t pos = 0;
 
+	// Buffer that is read from instead of data, if set
+	const byte* fixedBuf = NULL;
+	size_t fixedSize = 0;
+
+	// Keeps the mapping of a file opened with DataStreamIn(filePath, ...) alive
+	std::shared_ptr<MappedFile> mappedFile;
+
 	DataStreamIn() = default;
 
+	// Read from a caller-provided buffer, which must outlive the stream
+	// NOTE: Takes bytes rather than void* so that file path strings don't convert to it
+	DataStreamIn(const byte* buffer, size_t bufferSize) : fixedBuf(buffer), fixedSize(bufferSize) {}
+
+	// Memory-map the file and read from it directly
 	DataStreamIn(std::filesystem::path filePath, bool versionCheck) {
-		std::ifstream fileStream = std::ifstream(filePath, std::ios::binary);
-		if (!fileStream.good())
+		mappedFile = std::make_shared<MappedFile>(filePath);
+		if (!mappedFile->IsValid())
 			RS_ERR_CLOSE("Failed to read file " << filePath << ", cannot open file.");
-		
-		fileStream >> std::noskipws;
-		data = std::vector<byte>(std::istreambuf_iterator<char>(fileStream), std::istreambuf_iterator<char>());
+
+		fixedBuf = mappedFile->GetData();
+		fixedSize = mappedFile->GetSize();
 
 		if (versionCheck && !DoVersionCheck()) {
 			RS_ERR_CLOSE("Failed to read file " << filePath << ", file is invalid or from a different version of RocketSim.");
 		}
 	}
 
+	const byte* GetData() const {
+		return fixedBuf ? fixedBuf : data.data();
+	}
+
+	size_t GetSize() const {
+		return fixedBuf ? fixedSize : data.size();
+	}
+
 	bool DoVersionCheck() {
 		uint32_t versionID = Read<uint32_t>();
 		return versionID == RS_VERSION_ID;
 	}
 
 	bool IsDone() const {
-		return pos >= data.size();
+		return pos >= GetSize();
 	}
 
 	bool IsOverflown() const {
-		return pos > data.size();
+		return pos > GetSize();
 	}
 
 	size_t GetNumBytesLeft() const {
 		if (IsDone()) {
 			return 0;
 		} else {
-			return data.size() - pos;
+			return GetSize() - pos;
 		}
 	}
 
 	void ReadBytes(void* out, size_t amount) {
 		if (GetNumBytesLeft() >= amount) {
 			byte* asBytes = (byte*)out;
-			memcpy(asBytes, data.data() + pos, amount);
+			memcpy(asBytes, GetData() + pos, amount);
 
 			if (RS_IS_BIG_ENDIAN)
-				std::reverse(asBytes, asBytes + sizeof(amount));
+				std::reverse(asBytes, asBytes + amount);
 		}
 
 		pos += amount;
@@ -71,18 +94,23 @@ struct DataStreamIn {
 		out = Read<T>();
 	}
 
-	void ReadMultipleFromList(std::vector<SerializeObject> objs) {
+	void ReadMultipleFromList(const std::vector<SerializeObject>& objs) {
 		uint32_t amount = Read<uint32_t>();
 		if (amount != objs.size())
 			RS_ERR_CLOSE("DataStreamIn::ReadMultipleFromList(): Prop count mismatch, expected " << objs.size() << " but have " << amount << ".");
-		
+
 		for (const SerializeObject& obj : objs)
 			ReadBytes(obj.ptr, obj.size);
 	}
 
+	// Reads the amount of args written by DataStreamOut::WriteMultiple(), then each arg
 	template <typename... Args>
 	void ReadMultiple(Args&... args) {
-		ReadMultipleFromList({ args... });
+		uint32_t amount = Read<uint32_t>();
+		if (amount != sizeof...(Args))
+			RS_ERR_CLOSE("DataStreamIn::ReadMultiple(): Prop count mismatch, expected " << sizeof...(Args) << " but have " << amount << ".");
+
+		(ReadBytes(&args, sizeof(Args)), ...);
 	}
 };
 
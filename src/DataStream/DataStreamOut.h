@@ -6,25 +6,82 @@
 RS_NS_START
 
 // Basic struct for writing raw data to a file
+// Writes into a growable buffer (data), or into a fixed caller-provided buffer (see DataStreamOut(byte*, size_t))
+// Nothing is allocated once the growable buffer is big enough, so a stream can be Clear()'d and re-used
 struct DataStreamOut {
 	std::vector<byte> data;
 	size_t pos = 0;
 
+	// Caller-provided buffer that is written into instead of data, if set
+	byte* fixedBuf = NULL;
+	size_t fixedSize = 0;
+
 	DataStreamOut() = default;
 
-	void WriteBytes(const void* ptr, size_t amount) {
-		data.reserve(amount);
-		if (RS_IS_BIG_ENDIAN) {
-			byte* reversed = (byte*)malloc(amount);
-			memcpy(reversed, ptr, amount);
-			std::reverse(reversed, reversed + amount);
-			data.insert(data.end(), (byte*)reversed, (byte*)reversed + amount);
-			free(reversed);
-		} else {
-			data.insert(data.end(), (byte*)ptr, (byte*)ptr + amount);
+	// Start with room for this many bytes
+	DataStreamOut(size_t reserveSize) {
+		data.reserve(reserveSize);
+	}
+
+	// Write into a caller-provided buffer, which must outlive the stream
+	// Writes past the end of the buffer are dropped, check IsOverflown() when done
+	DataStreamOut(byte* buffer, size_t bufferSize) : fixedBuf(buffer), fixedSize(bufferSize) {}
+
+	byte* GetData() {
+		return fixedBuf ? fixedBuf : data.data();
+	}
+
+	// Amount of bytes written
+	size_t GetSize() const {
+		return pos;
+	}
+
+	// True if more was written than fits in the fixed buffer
+	bool IsOverflown() const {
+		return fixedBuf && pos > fixedSize;
+	}
+
+	// Start writing from the beginning again, keeping the buffer
+	void Clear() {
+		data.clear();
+		pos = 0;
+	}
+
+	// Drop everything written after the first size bytes
+	void Truncate(size_t size) {
+		assert(size <= pos);
+		pos = size;
+		if (!fixedBuf)
+			data.resize(size);
+	}
+
+	// Get where the next amount of bytes should be written to, or NULL if they don't fit in the fixed buffer
+	byte* _Claim(size_t amount) {
+		size_t end = pos + amount;
+		if (fixedBuf) {
+			byte* dest = (end <= fixedSize) ? (fixedBuf + pos) : NULL;
+			pos = end;
+			return dest;
 		}
 
-		pos += amount;
+		if (end > data.capacity())
+			data.reserve(RS_MAX(end, data.capacity() * 2));
+		data.resize(end);
+
+		byte* dest = data.data() + pos;
+		pos = end;
+		return dest;
+	}
+
+	static void _Copy(byte* dest, const void* ptr, size_t amount) {
+		memcpy(dest, ptr, amount);
+		if (RS_IS_BIG_ENDIAN)
+			std::reverse(dest, dest + amount);
+	}
+
+	void WriteBytes(const void* ptr, size_t amount) {
+		if (byte* dest = _Claim(amount))
+			_Copy(dest, ptr, amount);
 	}
 
 	template <typename T>
@@ -32,15 +89,27 @@ struct DataStreamOut {
 		WriteBytes(&val, sizeof(T));
 	}
 
-	void WriteMultipleFromList(std::vector<SerializeObject> objs) {
+	void WriteMultipleFromList(const std::vector<SerializeObject>& objs) {
 		Write<uint32_t>(objs.size());
 		for (const SerializeObject& obj : objs)
 			WriteBytes(obj.ptr, obj.size);
 	}
 
+	// Writes the amount of args, then each arg
+	// The total size is known at compile time, so everything is written in one go
 	template<typename... Args>
-	void WriteMultiple(Args... args) {
-		WriteMultipleFromList({ args... });
+	void WriteMultiple(const Args&... args) {
+		constexpr size_t TOTAL_SIZE = sizeof(uint32_t) + (sizeof(Args) + ... + 0);
+
+		byte* dest = _Claim(TOTAL_SIZE);
+		if (!dest)
+			return;
+
+		uint32_t amount = sizeof...(Args);
+		_Copy(dest, &amount, sizeof(amount));
+		dest += sizeof(amount);
+
+		((_Copy(dest, &args, sizeof(Args)), dest += sizeof(Args)), ...);
 	}
 
 	void WriteToFile(std::filesystem::path filePath, bool writeVersionCheck) {
@@ -50,12 +119,12 @@ struct DataStreamOut {
 
 		if (writeVersionCheck) {
 			uint32_t version = RS_VERSION_ID;
-			byte* versionBytes = (byte*)&version;
-			data.insert(data.begin(), versionBytes, versionBytes + sizeof(version));
+			fileStream.write((char*)&version, sizeof(version));
 		}
 
-		if (!data.empty())
-			fileStream.write((char*)data.data(), data.size());
+		size_t size = fixedBuf ? RS_MIN(pos, fixedSize) : pos;
+		if (size > 0)
+			fileStream.write((char*)GetData(), size);
 	}
 };
 
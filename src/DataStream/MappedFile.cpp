@@ -0,0 +1,86 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+RS_NS_START
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(std::filesystem::path filePath) {
+	HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+	_fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+		return;
+
+	if (fileSize.QuadPart == 0) {
+		_isEmpty = true;
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping)
+		return;
+	_mappingHandle = mapping;
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+		return;
+
+	_data = (const byte*)view;
+	_size = (size_t)fileSize.QuadPart;
+}
+
+MappedFile::~MappedFile() {
+	if (_data)
+		UnmapViewOfFile(_data);
+	if (_mappingHandle)
+		CloseHandle(_mappingHandle);
+	if (_fileHandle)
+		CloseHandle(_fileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(std::filesystem::path filePath) {
+	int fd = open(filePath.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) == 0) {
+		if (fileStat.st_size == 0) {
+			_isEmpty = true;
+		} else {
+			void* map = mmap(NULL, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (map != MAP_FAILED) {
+				_data = (const byte*)map;
+				_size = fileStat.st_size;
+			}
+		}
+	}
+
+	// The mapping stays valid after closing
+	close(fd);
+}
+
+MappedFile::~MappedFile() {
+	if (_data)
+		munmap((void*)_data, _size);
+}
+
+#endif
+
+RS_NS_END
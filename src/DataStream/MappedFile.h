@@ -0,0 +1,35 @@
+#pragma once
+#include "../Framework.h"
+
+RS_NS_START
+
+// Read-only memory mapping of an entire file
+// The pages are shared with every other process mapping the same file
+class MappedFile {
+public:
+	RSAPI MappedFile(std::filesystem::path filePath);
+	RSAPI ~MappedFile();
+
+	MappedFile(const MappedFile& other) = delete;
+	MappedFile& operator =(const MappedFile& other) = delete;
+
+	// NULL if the file could not be opened or mapped
+	const byte* GetData() const { return _data; }
+	size_t GetSize() const { return _size; }
+
+	bool IsValid() const { return _data != NULL || _isEmpty; }
+
+private:
+	const byte* _data = NULL;
+	size_t _size = 0;
+
+	// Empty files can't be mapped, but are still valid
+	bool _isEmpty = false;
+
+#ifdef _WIN32
+	void* _fileHandle = NULL;
+	void* _mappingHandle = NULL;
+#endif
+};
+
+RS_NS_END
@@ -1,6 +1,6 @@
 #pragma once
 
-#define RS_VERSION "2.1.1"
+#define RS_VERSION "2.2.0"
 
 #include <cstdint>
 #include <cstdlib>
@@ -36,6 +36,89 @@ float LinearPieceCurve::GetOutput(float input, float defaultOutput) const {
 	return output;
 }
 
+FlatLinearPieceCurve::FlatLinearPieceCurve(const LinearPieceCurve& curve) {
+	if (curve.valueMappings.size() > MAX_POINTS)
+		RS_ERR_CLOSE("FlatLinearPieceCurve: Curve has too many points (" << curve.valueMappings.size() << " > " << MAX_POINTS << ")");
+
+	numPoints = 0;
+	for (auto& pair : curve.valueMappings) {
+		inputs[numPoints] = pair.first;
+		outputs[numPoints] = pair.second;
+		numPoints++;
+	}
+}
+
+float FlatLinearPieceCurve::GetOutput(float input, float defaultOutput) const {
+	if (numPoints == 0)
+		return defaultOutput;
+
+	if (input <= inputs[0])
+		return outputs[0];
+
+	for (int i = 1; i < numPoints; i++) {
+		if (inputs[i] > input) {
+			// Same math as LinearPieceCurve::GetOutput(), so results are identical
+			float rangeBetween = inputs[i] - inputs[i - 1];
+			float valDiffBetween = outputs[i] - outputs[i - 1];
+			float linearInterpFactor = (input - inputs[i - 1]) / rangeBetween;
+			return outputs[i - 1] + valDiffBetween * linearInterpFactor;
+		}
+	}
+
+	return outputs[numPoints - 1];
+}
+
+void FlatLinearPieceCurve::GetOutput4(const float* in, float* outputsOut, float defaultOutput) const {
+#ifdef BT_USE_SSE
+	if (numPoints < 2) {
+		float output = numPoints ? outputs[0] : defaultOutput;
+		for (int i = 0; i < 4; i++)
+			outputsOut[i] = output;
+		return;
+	}
+
+	__m128 input = _mm_loadu_ps(in);
+
+	// Start on the first segment, then move each lane to the last segment whose start it isn't before
+	// "Isn't before" is !(start > input), so NaN inputs end up past the last point, just like GetOutput()
+	__m128
+		beforeIn = _mm_set1_ps(inputs[0]), beforeOut = _mm_set1_ps(outputs[0]),
+		afterIn = _mm_set1_ps(inputs[1]), afterOut = _mm_set1_ps(outputs[1]);
+	for (int i = 2; i < numPoints; i++) {
+		__m128 mask = _mm_cmpngt_ps(_mm_set1_ps(inputs[i - 1]), input);
+		beforeIn = _mm_or_ps(_mm_and_ps(mask, _mm_set1_ps(inputs[i - 1])), _mm_andnot_ps(mask, beforeIn));
+		beforeOut = _mm_or_ps(_mm_and_ps(mask, _mm_set1_ps(outputs[i - 1])), _mm_andnot_ps(mask, beforeOut));
+		afterIn = _mm_or_ps(_mm_and_ps(mask, _mm_set1_ps(inputs[i])), _mm_andnot_ps(mask, afterIn));
+		afterOut = _mm_or_ps(_mm_and_ps(mask, _mm_set1_ps(outputs[i])), _mm_andnot_ps(mask, afterOut));
+	}
+
+	__m128 rangeBetween = _mm_sub_ps(afterIn, beforeIn);
+	__m128 valDiffBetween = _mm_sub_ps(afterOut, beforeOut);
+	__m128 linearInterpFactor = _mm_div_ps(_mm_sub_ps(input, beforeIn), rangeBetween);
+	__m128 result = _mm_add_ps(beforeOut, _mm_mul_ps(valDiffBetween, linearInterpFactor));
+
+	__m128 pastLastMask = _mm_cmpngt_ps(_mm_set1_ps(inputs[numPoints - 1]), input);
+	result = _mm_or_ps(_mm_and_ps(pastLastMask, _mm_set1_ps(outputs[numPoints - 1])), _mm_andnot_ps(pastLastMask, result));
+
+	__m128 beforeFirstMask = _mm_cmple_ps(input, _mm_set1_ps(inputs[0]));
+	result = _mm_or_ps(_mm_and_ps(beforeFirstMask, _mm_set1_ps(outputs[0])), _mm_andnot_ps(beforeFirstMask, result));
+
+	_mm_storeu_ps(outputsOut, result);
+#else
+	for (int i = 0; i < 4; i++)
+		outputsOut[i] = GetOutput(in[i], defaultOutput);
+#endif
+}
+
+void FlatLinearPieceCurve::GetOutputN(const float* in, float* outputsOut, size_t amount, float defaultOutput) const {
+	size_t i = 0;
+	for (; i + 4 <= amount; i += 4)
+		GetOutput4(in + i, outputsOut + i, defaultOutput);
+
+	for (; i < amount; i++)
+		outputsOut[i] = GetOutput(in[i], defaultOutput);
+}
+
 btVector3 Math::RoundVec(btVector3 vec, float precision) {
 	vec.x() = roundf(vec.x() / precision) * precision;
 	vec.y() = roundf(vec.y() / precision) * precision;
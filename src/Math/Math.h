@@ -9,6 +9,26 @@ struct LinearPieceCurve {
 	RSAPI float GetOutput(float input, float defaultOutput = 1) const;
 };
 
+// LinearPieceCurve with its points copied into flat arrays, for curves that are evaluated every tick
+// Outputs are exactly the same as LinearPieceCurve::GetOutput()
+struct FlatLinearPieceCurve {
+	constexpr static int MAX_POINTS = 8;
+
+	int numPoints;
+	float inputs[MAX_POINTS];
+	float outputs[MAX_POINTS];
+
+	RSAPI FlatLinearPieceCurve(const LinearPieceCurve& curve);
+
+	RSAPI float GetOutput(float input, float defaultOutput = 1) const;
+
+	// Evaluate 4 inputs at once, using SIMD where available
+	RSAPI void GetOutput4(const float* in, float* outputsOut, float defaultOutput = 1) const;
+
+	// Evaluate any amount of inputs, 4 at a time
+	RSAPI void GetOutputN(const float* in, float* outputsOut, size_t amount, float defaultOutput = 1) const;
+};
+
 namespace Math {
 	RSAPI btVector3 RoundVec(btVector3 vec, float precision);
 
@@ -34,6 +34,9 @@ namespace RLConst {
 		CARCAR_COLLISION_FRICTION = 0.09f,
 		CARCAR_COLLISION_RESTITUTION = 0.1f,
 
+		ARENA_COLLISION_FRICTION = 0.6f,
+		ARENA_COLLISION_RESTITUTION = 0.3f,
+
 		BALL_REST_Z = 93.15f, // Greater than ball radius because of arena mesh collision margin
 		BALL_MAX_ANG_SPEED = 6.f, // Ball can never exceed this angular velocity (radians/s)
 		BALL_DRAG = 0.03f, // Net-velocity drag multiplier
@@ -435,6 +438,23 @@ namespace RLConst {
 			{2200.f, 417.f},
 		}
 	};
+
+	// Flattened copies of the curves above that are evaluated every tick
+	namespace Flat {
+		const static FlatLinearPieceCurve
+			STEER_ANGLE_FROM_SPEED_CURVE = RLConst::STEER_ANGLE_FROM_SPEED_CURVE,
+			POWERSLIDE_STEER_ANGLE_FROM_SPEED_CURVE = RLConst::POWERSLIDE_STEER_ANGLE_FROM_SPEED_CURVE,
+			DRIVE_SPEED_TORQUE_FACTOR_CURVE = RLConst::DRIVE_SPEED_TORQUE_FACTOR_CURVE,
+			NON_STICKY_FRICTION_FACTOR_CURVE = RLConst::NON_STICKY_FRICTION_FACTOR_CURVE,
+			LAT_FRICTION_CURVE = RLConst::LAT_FRICTION_CURVE,
+			LONG_FRICTION_CURVE = RLConst::LONG_FRICTION_CURVE,
+			HANDBRAKE_LAT_FRICTION_FACTOR_CURVE = RLConst::HANDBRAKE_LAT_FRICTION_FACTOR_CURVE,
+			HANDBRAKE_LONG_FRICTION_FACTOR_CURVE = RLConst::HANDBRAKE_LONG_FRICTION_FACTOR_CURVE,
+			BALL_CAR_EXTRA_IMPULSE_FACTOR_CURVE = RLConst::BALL_CAR_EXTRA_IMPULSE_FACTOR_CURVE,
+			BUMP_VEL_AMOUNT_GROUND_CURVE = RLConst::BUMP_VEL_AMOUNT_GROUND_CURVE,
+			BUMP_VEL_AMOUNT_AIR_CURVE = RLConst::BUMP_VEL_AMOUNT_AIR_CURVE,
+			BUMP_UPWARD_VEL_AMOUNT_CURVE = RLConst::BUMP_UPWARD_VEL_AMOUNT_CURVE;
+	}
 }
 
 RS_NS_END
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "RocketSim.h"
 
+#include "CollisionMeshFile/CollisionMeshCache.h"
+
 #include "../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
 #include "../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btTriangleMesh.h"
 #include "../libsrc/bullet3-3.24/BulletCollision/CollisionDispatch/btInternalEdgeUtility.h"
@@ -67,7 +69,7 @@ SuspensionCollisionGrid& RocketSim::GetDefaultSuspColGrid(GameMode gameMode, boo
 }
 #endif
 
-void RocketSim::Init(std::filesystem::path collisionMeshesFolder, bool silent) {
+void RocketSim::Init(std::filesystem::path collisionMeshesFolder, bool silent, std::filesystem::path meshCachePath) {
 
 	std::map<GameMode, std::vector<FileData>> meshFileMap = {};
 
@@ -89,17 +91,17 @@ void RocketSim::Init(std::filesystem::path collisionMeshesFolder, bool silent) {
 			auto entryPath = entry.path();
 			if (entryPath.has_extension() && entryPath.extension() == COLLISION_MESH_FILE_EXTENSION) {
 				DataStreamIn streamIn = DataStreamIn(entryPath, false);
-				meshFileMap[gameMode].push_back(streamIn.data);
+				meshFileMap[gameMode].push_back(FileData(streamIn.GetData(), streamIn.GetData() + streamIn.GetSize()));
 			}
 		}
 	}
 
-	RocketSim::InitFromMem(meshFileMap, silent);
+	RocketSim::InitFromMem(meshFileMap, silent, meshCachePath);
 
 	_collisionMeshesFolder = collisionMeshesFolder;
 }
 
-void RocketSim::InitFromMem(const std::map<GameMode, std::vector<FileData>>& meshFilesMap, bool silent) {
+void RocketSim::InitFromMem(const std::map<GameMode, std::vector<FileData>>& meshFilesMap, bool silent, std::filesystem::path meshCachePath) {
 
 	constexpr char MSG_PREFIX[] = "RocketSim::Init(): ";
 
@@ -122,6 +124,7 @@ void RocketSim::InitFromMem(const std::map<GameMode, std::vector<FileData>>& mes
 
 		uint64_t startMS = RS_CUR_MS();
 
+		std::map<GameMode, std::vector<CollisionMeshFile>> loadedMeshFilesMap = {};
 		for (auto& mapPair : meshFilesMap) { // Load collision meshes for soccar and hoops
 			GameMode gameMode = mapPair.first;
 			auto& meshFiles = mapPair.second;
@@ -135,15 +138,12 @@ void RocketSim::InitFromMem(const std::map<GameMode, std::vector<FileData>>& mes
 				continue;
 			}
 
-			auto& meshes = GetArenaCollisionShapes(gameMode);
-
 			MeshHashSet targetHashes = MeshHashSet(gameMode);
 
 			// Load collision meshes
 			int idx = 0;
 			for (auto& entry : meshFiles) {
-				DataStreamIn dataStream = {};
-				dataStream.data = entry;
+				DataStreamIn dataStream = DataStreamIn(entry.data(), entry.size());
 				CollisionMeshFile meshFile = {};
 				meshFile.ReadFromStream(dataStream, silent);
 				int& hashCount = targetHashes[meshFile.hash];
@@ -162,15 +162,33 @@ void RocketSim::InitFromMem(const std::map<GameMode, std::vector<FileData>>& mes
 				}
 				hashCount++;
 
-				btTriangleMesh* triMesh = meshFile.MakeBulletMesh();
+				loadedMeshFilesMap[gameMode].push_back(std::move(meshFile));
+				idx++;
+			}
+		}
+
+		bool loadedFromCache = !meshCachePath.empty() && CollisionMeshCache::Load(meshCachePath, loadedMeshFilesMap);
+		if (!silent && !meshCachePath.empty()) {
+			if (loadedFromCache) {
+				RS_LOG("Loaded arena meshes from mesh cache " << meshCachePath);
+			} else {
+				RS_LOG("Mesh cache " << meshCachePath << " is missing or outdated, building arena meshes...");
+			}
+		}
+
+		if (!loadedFromCache) {
+			for (auto& mapPair : loadedMeshFilesMap) {
+				auto& meshes = GetArenaCollisionShapes(mapPair.first);
 
-				auto bvtMesh = new btBvhTriangleMeshShape(triMesh, true);
-				btTriangleInfoMap* infoMap = new btTriangleInfoMap();
-				btGenerateInternalEdgeInfo(bvtMesh, infoMap);
-				bvtMesh->setTriangleInfoMap(infoMap);
-				meshes.push_back(bvtMesh);
+				for (CollisionMeshFile& meshFile : mapPair.second) {
+					btTriangleMesh* triMesh = meshFile.MakeBulletMesh();
 
-				idx++;
+					auto bvtMesh = new btBvhTriangleMeshShape(triMesh, true);
+					btTriangleInfoMap* infoMap = new btTriangleInfoMap();
+					btGenerateInternalEdgeInfo(bvtMesh, infoMap);
+					bvtMesh->setTriangleInfoMap(infoMap);
+					meshes.push_back(bvtMesh);
+				}
 			}
 		}
 
@@ -191,8 +209,8 @@ void RocketSim::InitFromMem(const std::map<GameMode, std::vector<FileData>>& mes
 						RS_LOG("Building collision suspension grids from " << GAMEMODE_STRS[(int)gameMode] << " arena meshes...");
 
 					for (int j = 0; j < 2; j++) {
+						// Arenas copy these grids, sharing their world collision cells
 						auto& grid = GetDefaultSuspColGrid(gameMode, j);
-						grid.Allocate();
 						grid.SetupWorldCollision(meshes);
 					}
 				}
@@ -200,6 +218,15 @@ void RocketSim::InitFromMem(const std::map<GameMode, std::vector<FileData>>& mes
 		}
 #endif
 
+		if (!loadedFromCache && !meshCachePath.empty()) {
+			// Only saves later inits some time, so failing to write it isn't fatal
+			try {
+				CollisionMeshCache::Write(meshCachePath, loadedMeshFilesMap);
+			} catch (std::exception& e) {
+				if (!silent)
+					RS_WARN(MSG_PREFIX << "Failed to write mesh cache: " << e.what());
+			}
+		}
 
 		uint64_t elapsedMS = RS_CUR_MS() - startMS;
 
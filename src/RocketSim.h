@@ -25,12 +25,14 @@ namespace RocketSim {
 	extern std::filesystem::path _collisionMeshesFolder;
 	extern std::mutex _beginInitMutex;
 
-	void Init(std::filesystem::path collisionMeshesFolder, bool silent = false);
+	// If a mesh cache path is given, the arena collision meshes are loaded from that cache instead of built,
+	//	unless it was written from different mesh files, in which case they are built and the cache is written again (see CollisionMeshCache)
+	void Init(std::filesystem::path collisionMeshesFolder, bool silent = false, std::filesystem::path meshCachePath = {});
 
 	// Instead of loading a collision meshes folder, you can pass in the meshes in this memory-only format
 	// The map sorts mesh files to their respective game modes, where each game mode has a list of mesh files
 	// The mesh files themselves are just byte arrays
-	void InitFromMem(const std::map<GameMode, std::vector<FileData>>& meshFilesMap, bool silent = false);
+	void InitFromMem(const std::map<GameMode, std::vector<FileData>>& meshFilesMap, bool silent = false, std::filesystem::path meshCachePath = {});
 
 	void AssertInitialized(const char* errorMsgPrefix);
 
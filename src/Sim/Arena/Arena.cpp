@@ -1,5 +1,8 @@
 #include "Arena.h"
 #include "../../RocketSim.h"
+#include "../ArenaPool/ArenaPool.h"
+#include "../ArenaRecorder/ArenaRecorder.h"
+#include "../Replay/ReplayRecorder.h"
 
 #include "../../../libsrc/bullet3-3.24/BulletCollision/BroadphaseCollision/btAxisSweep3.h"
 #include "../../../libsrc/bullet3-3.24/BulletCollision/BroadphaseCollision/btDbvtBroadphase.h"
@@ -11,8 +14,17 @@
 #include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btBoxShape.h"
 #include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btSphereShape.h"
 
+#include <tuple>
+
 RS_NS_START
 
+Arena::SharedStaticCollision::~SharedStaticCollision() {
+	delete broadphaseStatics;
+	delete[] rbs;
+	delete[] planeShapes;
+	delete[] bvhShapes;
+}
+
 RSAPI void Arena::SetMutatorConfig(const MutatorConfig& mutatorConfig) {
 
 	bool
@@ -237,8 +249,9 @@ void Arena::ResetToRandomKickoff(int seed) {
 	}
 }
 
+template <GameMode GAMEMODE>
 bool Arena::_BulletContactAddedCallback(
-	btManifoldPoint& contactPoint,
+	void* userInfo, btManifoldPoint& contactPoint,
 	const btCollisionObjectWrapper* objA, int partID_A, int indexA,
 	const btCollisionObjectWrapper* objB, int partID_B, int indexB) {
 
@@ -269,12 +282,12 @@ bool Arena::_BulletContactAddedCallback(
 	if (carInvolved) {
 
 		Car* car = (Car*)bodyA->getUserPointer();
-		Arena* arenaInst = (Arena*)car->_bulletVehicle.m_dynamicsWorld->getWorldUserInfo();
+		Arena* arenaInst = (Arena*)userInfo;
 
 		if (userIndexB == BT_USERINFO_TYPE_BALL) {
 			// Car + Ball
 			arenaInst->
-				_BtCallback_OnCarBallCollision(car, (Ball*)bodyB->getUserPointer(), contactPoint, shouldSwap);
+				_BtCallback_OnCarBallCollision<GAMEMODE>(car, (Ball*)bodyB->getUserPointer(), contactPoint, shouldSwap);
 		} else if (userIndexB == BT_USERINFO_TYPE_CAR) {
 			// Car + Car
 			arenaInst->
@@ -284,13 +297,13 @@ bool Arena::_BulletContactAddedCallback(
 			arenaInst->
 				_BtCallback_OnCarWorldCollision(car, (btCollisionObject*)bodyB->getUserPointer(), contactPoint);
 		}
-	} else if (userIndexA == BT_USERINFO_TYPE_BALL && userIndexB == -1) {
+	} else if (GAMEMODE != GameMode::THE_VOID && userIndexA == BT_USERINFO_TYPE_BALL && userIndexB == -1) {
 		// Ball + World
-		Arena* arenaInst = (Arena*)bodyB->getUserPointer();
-		arenaInst->ball->_OnWorldCollision(arenaInst->gameMode, contactPoint.m_normalWorldOnB, arenaInst->tickTime);
+		Arena* arenaInst = (Arena*)userInfo;
+		arenaInst->ball->_OnWorldCollision(GAMEMODE, contactPoint.m_normalWorldOnB, arenaInst->tickTime);
 		
 		// Set as special
-		if (arenaInst->gameMode != GameMode::SNOWDAY)
+		if (GAMEMODE != GameMode::SNOWDAY)
 			contactPoint.m_isSpecial = true;
 	}
 	
@@ -302,6 +315,13 @@ bool Arena::_BulletContactAddedCallback(
 	return true;
 }
 
+btContactAddedCallback Arena::_GetBulletContactAddedCallback(GameMode gameMode) {
+	return GameModeDispatch(gameMode, [](auto gameModeConst) -> btContactAddedCallback {
+		return &_BulletContactAddedCallback<decltype(gameModeConst)::value>;
+	});
+}
+
+template <GameMode GAMEMODE>
 void Arena::_BtCallback_OnCarBallCollision(Car* car, Ball* ball, btManifoldPoint& manifoldPoint, bool ballIsBodyA) {
 	using namespace RLConst;
 
@@ -314,6 +334,10 @@ void Arena::_BtCallback_OnCarBallCollision(Car* car, Ball* ball, btManifoldPoint
 
 	auto& ballHitInfo = car->_internalState.ballHitInfo;
 
+	// Only count one touch per tick, even if there are multiple contact points
+	if (!ballHitInfo.isValid || ballHitInfo.tickCountWhenHit != this->tickCount)
+		car->_eventCounts.ballTouches++;
+
 	ballHitInfo.isValid = true;
 
 	ballHitInfo.relativePosOnBall = (ballIsBodyA ? manifoldPoint.m_localPointA : manifoldPoint.m_localPointB) * BT_TO_UU;
@@ -343,21 +367,21 @@ void Arena::_BtCallback_OnCarBallCollision(Car* car, Ball* ball, btManifoldPoint
 
 	if (relSpeed > 0) {
 		bool extraZScale = 
-			gameMode == GameMode::HOOPS && 
+			GAMEMODE == GameMode::HOOPS && 
 			carState.isOnGround &&
 			carState.rotMat.up.z > BALL_CAR_EXTRA_IMPULSE_Z_SCALE_HOOPS_NORMAL_Z_THRESH;
 		float zScale = extraZScale ? BALL_CAR_EXTRA_IMPULSE_Z_SCALE_HOOPS_GROUND : BALL_CAR_EXTRA_IMPULSE_Z_SCALE;
 		btVector3 hitDir = (relPos * btVector3(1, 1, zScale)).safeNormalized();
 		btVector3 forwardDirAdjustment = carForward * hitDir.dot(carForward) * (1 - BALL_CAR_EXTRA_IMPULSE_FORWARD_SCALE);
 		hitDir = (hitDir - forwardDirAdjustment).safeNormalized();
-		btVector3 addedVel = (hitDir * relSpeed) * BALL_CAR_EXTRA_IMPULSE_FACTOR_CURVE.GetOutput(relSpeed) * _mutatorConfig.ballHitExtraForceScale;
+		btVector3 addedVel = (hitDir * relSpeed) * Flat::BALL_CAR_EXTRA_IMPULSE_FACTOR_CURVE.GetOutput(relSpeed) * _mutatorConfig.ballHitExtraForceScale;
 		ballHitInfo.extraHitVel = addedVel;
 
 		// Velocity won't be actually added until the end of this tick
 		ball->_velocityImpulseCache += addedVel * UU_TO_BT;
 	}
 
-	ball->_OnHit(gameMode, car);
+	ball->_OnHit<GAMEMODE>(car);
 }
 
 void Arena::_BtCallback_OnCarCarCollision(Car* car1, Car* car2, btManifoldPoint& manifoldPoint) {
@@ -416,18 +440,20 @@ void Arena::_BtCallback_OnCarCarCollision(Car* car1, Car* car2, btManifoldPoint&
 
 					if (isDemo) {
 						car2->Demolish(_mutatorConfig.respawnDelay);
+						car1->_eventCounts.demosInflicted++;
+						car2->_eventCounts.timesDemoed++;
 					} else {
 						bool groundHit = car2->_internalState.isOnGround;
 
 						float baseScale =
-							(groundHit ? BUMP_VEL_AMOUNT_GROUND_CURVE : BUMP_VEL_AMOUNT_AIR_CURVE).GetOutput(speedTowardsOtherCar);
+							(groundHit ? Flat::BUMP_VEL_AMOUNT_GROUND_CURVE : Flat::BUMP_VEL_AMOUNT_AIR_CURVE).GetOutput(speedTowardsOtherCar);
 
 						Vec hitUpDir =
 							(otherState.isOnGround ? (Vec)car2->GetUpDir() : Vec(0, 0, 1));
 
 						Vec bumpImpulse =
 							velDir * baseScale +
-							hitUpDir * BUMP_UPWARD_VEL_AMOUNT_CURVE.GetOutput(speedTowardsOtherCar)
+							hitUpDir * Flat::BUMP_UPWARD_VEL_AMOUNT_CURVE.GetOutput(speedTowardsOtherCar)
 							* _mutatorConfig.bumpForceScale;
 
 						car2->_velocityImpulseCache += bumpImpulse * UU_TO_BT;
@@ -460,6 +486,9 @@ Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mu
 
 	RocketSim::AssertInitialized("Cannot create Arena, ");
 
+	if (config.memWeightMode == ArenaMemWeightMode::SHARED && !config.useCustomBroadphase)
+		RS_ERR_CLOSE("Cannot create Arena, ArenaMemWeightMode::SHARED requires useCustomBroadphase");
+
 	this->gameMode = gameMode;
 	this->tickTime = 1 / tickRate;
 
@@ -471,6 +500,10 @@ Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mu
 		if (_config.memWeightMode == ArenaMemWeightMode::LIGHT) {
 			collisionConfigConstructionInfo.m_defaultMaxPersistentManifoldPoolSize /= 32;
 			collisionConfigConstructionInfo.m_defaultMaxCollisionAlgorithmPoolSize /= 64;
+		} else if (_config.memWeightMode == ArenaMemWeightMode::SHARED) {
+			// Enough for a full game, anything past this is heap-allocated instead
+			collisionConfigConstructionInfo.m_defaultMaxPersistentManifoldPoolSize /= 128;
+			collisionConfigConstructionInfo.m_defaultMaxCollisionAlgorithmPoolSize /= 128;
 		} else {
 			collisionConfigConstructionInfo.m_defaultMaxPersistentManifoldPoolSize /= 16;
 			collisionConfigConstructionInfo.m_defaultMaxCollisionAlgorithmPoolSize /= 32;
@@ -490,12 +523,21 @@ Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mu
 				cellSizeMultiplier = 2.0f;
 			}
 
-			_bulletWorldParams.broadphase = new btRSBroadphase(
-				_config.minPos * UU_TO_BT,
-				_config.maxPos * UU_TO_BT,
-				_config.maxAABBLen * UU_TO_BT * cellSizeMultiplier,
-				_bulletWorldParams.overlappingPairCache,
-				_config.maxObjects);
+			if (_config.memWeightMode == ArenaMemWeightMode::SHARED) {
+				_sharedStaticCollision = _GetSharedStaticCollision(gameMode, _config);
+
+				_bulletWorldParams.broadphase = new btRSBroadphase(
+					_sharedStaticCollision->broadphaseStatics,
+					_bulletWorldParams.overlappingPairCache,
+					_config.maxObjects);
+			} else {
+				_bulletWorldParams.broadphase = new btRSBroadphase(
+					_config.minPos * UU_TO_BT,
+					_config.maxPos * UU_TO_BT,
+					_config.maxAABBLen * UU_TO_BT * cellSizeMultiplier,
+					_bulletWorldParams.overlappingPairCache,
+					_config.maxObjects);
+			}
 		} else {
 			_bulletWorldParams.broadphase = new btDbvtBroadphase(_bulletWorldParams.overlappingPairCache);
 		}
@@ -518,21 +560,20 @@ Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mu
 	bool loadArenaStuff = gameMode != GameMode::THE_VOID;
 
 	if (loadArenaStuff) {
-		_SetupArenaCollisionShapes();
+		if (_sharedStaticCollision) {
+			_worldCollisionRBs = _sharedStaticCollision->rbs;
+			_worldCollisionRBAmount = _sharedStaticCollision->rbAmount;
+			_worldCollisionBvhShapes = _sharedStaticCollision->bvhShapes;
+			_worldCollisionPlaneShapes = _sharedStaticCollision->planeShapes;
+		} else {
+			_SetupArenaCollisionShapes();
+		}
 
 #ifndef RS_NO_SUSPCOLGRID
-		_suspColGrid = RocketSim::GetDefaultSuspColGrid(gameMode, memWeightMode == ArenaMemWeightMode::LIGHT);
+		_suspColGrid = RocketSim::GetDefaultSuspColGrid(gameMode, _config.memWeightMode == ArenaMemWeightMode::LIGHT);
+		_suspColGrid.Allocate();
 		_suspColGrid.defaultWorldCollisionRB = &_worldCollisionRBs[0];
 #endif
-
-		// Give arena collision shapes the proper restitution/friction values
-		for (size_t i = 0; i < _worldCollisionRBAmount; i++) {
-			btRigidBody* rb = &_worldCollisionRBs[i];
-			// TODO: Move to RLConst
-			rb->setRestitution(0.3f);
-			rb->setFriction(0.6f);
-			rb->setRollingFriction(0.f);
-		}
 	} else {
 		_worldCollisionRBs = NULL;
 		_worldCollisionRBAmount = 0;
@@ -546,6 +587,16 @@ Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mu
 
 		ball->_BulletSetup(gameMode, &_bulletWorld, _mutatorConfig, _config.noBallRot);
 		ball->SetState(BallState());
+
+		if (_config.useCustomBroadphase) {
+			auto proxy = (btRSBroadphaseProxy*)ball->_rigidBody.getBroadphaseHandle();
+			_initialBallProxy.aabbMin = proxy->m_aabbMin;
+			_initialBallProxy.aabbMax = proxy->m_aabbMax;
+			_initialBallProxy.cellIdx = proxy->cellIdx;
+			_initialBallProxy.iIdx = proxy->iIdx;
+			_initialBallProxy.jIdx = proxy->jIdx;
+			_initialBallProxy.kIdx = proxy->kIdx;
+		}
 	}
 
 	if (loadArenaStuff) { // Initialize boost pads
@@ -586,10 +637,13 @@ Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mu
 		}
 	}
 
-	// Set internal tick callback
-	_bulletWorld.setWorldUserInfo(this);
+	// Contacts are handled by our own dispatcher, so arenas on other threads don't affect us
+	_bulletWorldParams.collisionDispatcher.setContactAddedCallback(_GetBulletContactAddedCallback(gameMode), this);
 
-	gContactAddedCallback = &Arena::_BulletContactAddedCallback;
+	_stepTicksFunc = GameModeDispatch(gameMode, [&](auto gameModeConst) {
+		constexpr GameMode GAMEMODE = decltype(gameModeConst)::value;
+		return _config.useCustomBoostPads ? &Arena::_StepTicks<GAMEMODE, true> : &Arena::_StepTicks<GAMEMODE, false>;
+	});
 }
 
 Arena* Arena::Create(GameMode gameMode, const ArenaConfig& arenaConfig, float tickRate) {
@@ -625,7 +679,7 @@ void Arena::Serialize(DataStreamOut& out) const {
 	}
 }
 
-Arena* Arena::DeserializeNew(DataStreamIn& in) {
+Arena* Arena::DeserializeNew(DataStreamIn& in, ArenaPool* pool) {
 	constexpr char ERROR_PREFIX[] = "Arena::Deserialize(): ";
 
 	GameMode gameMode;
@@ -639,7 +693,8 @@ Arena* Arena::DeserializeNew(DataStreamIn& in) {
 	ArenaConfig newConfig = {};
 	newConfig.Deserialize(in);
 
-	Arena* newArena = new Arena(gameMode, newConfig, 1.f / tickTime);
+	Arena* newArena = pool ? pool->Acquire(gameMode, newConfig, 1.f / tickTime) : new Arena(gameMode, newConfig, 1.f / tickTime);
+	newArena->tickTime = tickTime; // 1 / (1 / tickTime) can be off by a bit
 	newArena->tickCount = tickCount;
 	
 	{ // Deserialize cars
@@ -655,12 +710,9 @@ Arena* Arena::DeserializeNew(DataStreamIn& in) {
 				RS_ERR_CLOSE(ERROR_PREFIX << "Failed to load, got repeated car ID of " << id);
 #endif
 
-			Car* newCar = newArena->DeserializeNewCar(in, team);
-
-			// Force ID
-			newArena->_carIDMap.erase(newCar->id);
-			newArena->_carIDMap[id] = newCar;
-			newCar->id = id;
+			// Have the car get its ID assigned, forcing it afterwards can clobber the map entry of an already loaded car
+			newArena->_lastCarID = id - 1;
+			newArena->DeserializeNewCar(in, team);
 		}
 
 		newArena->_lastCarID = lastCarID;
@@ -720,8 +772,14 @@ Arena* Arena::Clone(bool copyCallbacks) {
 		newCar->id = car->id;
 		newCar->controls = car->controls;
 		newCar->_velocityImpulseCache = car->_velocityImpulseCache;
+		newCar->_eventCounts = car->_eventCounts;
 	}
 
+	// Cars were added with new IDs, so the ID map needs to be updated to their original ones
+	newArena->_carIDMap.clear();
+	for (Car* car : newArena->_cars)
+		newArena->_carIDMap[car->id] = car;
+
 	assert(this->_boostPads.size() == newArena->_boostPads.size());
 	for (int i = 0; i < this->_boostPads.size(); i++)
 		newArena->_boostPads[i]->SetState(this->_boostPads[i]->GetState());
@@ -737,20 +795,200 @@ Car* Arena::DeserializeNewCar(DataStreamIn& in, Team team) {
 	car->_Deserialize(in);
 	car->team = team;
 
+	// Bullet setup gives the car its spawn boost amount, so keep the loaded state aside
+	CarState loadedState = car->_internalState;
+
 	_AddCarFromPtr(car);
 
 	car->_BulletSetup(gameMode, &_bulletWorld, _mutatorConfig);
-	car->SetState(car->_internalState);
+	car->SetState(loadedState);
 
 	return car;
 }
 
+void Arena::SaveSnapshot(ArenaSnapshot& snapshot) const {
+	snapshot.gameMode = gameMode;
+	snapshot.tickCount = tickCount;
+	snapshot.solverTimeStep = _bulletWorld.getSolverInfo().m_timeStep;
+
+	{ // Save ball
+		BallSnapshot& ballSnapshot = snapshot.ball;
+		ballSnapshot.internalState = ball->_internalState;
+		ballSnapshot.velocityImpulseCache = ball->_velocityImpulseCache;
+		ballSnapshot.groundStickApplied = ball->_groundStickApplied;
+		ballSnapshot.rigidBody.Save(ball->_rigidBody);
+	}
+
+	snapshot.cars.resize(_cars.size());
+	size_t carIdx = 0;
+	for (Car* car : _cars) {
+		CarSnapshot& carSnapshot = snapshot.cars[carIdx++];
+		carSnapshot.id = car->id;
+		carSnapshot.controls = car->controls;
+		carSnapshot.internalState = car->_internalState;
+		carSnapshot.velocityImpulseCache = car->_velocityImpulseCache;
+		carSnapshot.eventCounts = car->_eventCounts;
+		carSnapshot.rigidBody.Save(car->_rigidBody);
+
+		assert(car->_bulletVehicle.getNumWheels() == 4);
+		for (int i = 0; i < 4; i++)
+			carSnapshot.wheels[i] = car->_bulletVehicle.m_wheelInfo[i];
+		carSnapshot.pitchControl = car->_bulletVehicle.m_pitchControl;
+		carSnapshot.steeringValue = car->_bulletVehicle.m_steeringValue;
+	}
+
+	snapshot.boostPads.resize(_boostPads.size());
+	for (size_t i = 0; i < _boostPads.size(); i++)
+		snapshot.boostPads[i] = _boostPads[i]->_internalState;
+
+	if (_config.useCustomBroadphase) {
+		// The order of dynamic proxies decides the order of collision pairs, so it is part of the state
+		auto broadphase = (btRSBroadphase*)_bulletWorldParams.broadphase;
+		snapshot.broadphaseProxies.resize(broadphase->dynProxies.size());
+		for (size_t i = 0; i < broadphase->dynProxies.size(); i++) {
+			btRSBroadphaseProxy* proxy = broadphase->dynProxies[i];
+			auto colObj = (btCollisionObject*)proxy->m_clientObject;
+
+			BroadphaseProxySnapshot& proxySnapshot = snapshot.broadphaseProxies[i];
+			proxySnapshot.carID = (colObj->getUserIndex() == BT_USERINFO_TYPE_CAR) ? ((Car*)colObj->getUserPointer())->id : 0;
+			proxySnapshot.aabbMin = proxy->m_aabbMin;
+			proxySnapshot.aabbMax = proxy->m_aabbMax;
+			proxySnapshot.cellIdx = proxy->cellIdx;
+			proxySnapshot.iIdx = proxy->iIdx;
+			proxySnapshot.jIdx = proxy->jIdx;
+			proxySnapshot.kIdx = proxy->kIdx;
+		}
+	} else {
+		snapshot.broadphaseProxies.clear();
+	}
+}
+
+void Arena::RestoreSnapshot(const ArenaSnapshot& snapshot) {
+	constexpr char ERROR_PREFIX[] = "Arena::RestoreSnapshot(): ";
+
+	// Make sure the snapshot fits before changing anything
+	if (snapshot.gameMode != gameMode)
+		RS_ERR_CLOSE(ERROR_PREFIX << "Snapshot game mode (" << GAMEMODE_STRS[(int)snapshot.gameMode] << ") does not match the arena's");
+
+	if (snapshot.cars.size() != _cars.size())
+		RS_ERR_CLOSE(ERROR_PREFIX << "Snapshot has " << snapshot.cars.size() << " cars, but the arena has " << _cars.size());
+
+	for (const CarSnapshot& carSnapshot : snapshot.cars)
+		if (_carIDMap.find(carSnapshot.id) == _carIDMap.end())
+			RS_ERR_CLOSE(ERROR_PREFIX << "Snapshot has a car with ID " << carSnapshot.id << ", which is not in the arena");
+
+	if (snapshot.boostPads.size() != _boostPads.size())
+		RS_ERR_CLOSE(ERROR_PREFIX << "Snapshot has " << snapshot.boostPads.size() << " boost pads, but the arena has " << _boostPads.size());
+
+	btRSBroadphase* broadphase = NULL;
+	if (_config.useCustomBroadphase && !snapshot.broadphaseProxies.empty()) {
+		broadphase = (btRSBroadphase*)_bulletWorldParams.broadphase;
+		if (snapshot.broadphaseProxies.size() != broadphase->dynProxies.size())
+			RS_ERR_CLOSE(ERROR_PREFIX << "Snapshot broadphase does not match the arena's");
+
+		for (const BroadphaseProxySnapshot& proxySnapshot : snapshot.broadphaseProxies)
+			if (proxySnapshot.carID && _carIDMap.find(proxySnapshot.carID) == _carIDMap.end())
+				RS_ERR_CLOSE(ERROR_PREFIX << "Snapshot broadphase has a car with ID " << proxySnapshot.carID << ", which is not in the arena");
+	}
+
+	tickCount = snapshot.tickCount;
+	_bulletWorld.getSolverInfo().m_timeStep = snapshot.solverTimeStep;
+
+	{ // Restore ball
+		const BallSnapshot& ballSnapshot = snapshot.ball;
+		ball->_internalState = ballSnapshot.internalState;
+		ball->_velocityImpulseCache = ballSnapshot.velocityImpulseCache;
+		ball->_groundStickApplied = ballSnapshot.groundStickApplied;
+		ballSnapshot.rigidBody.Restore(ball->_rigidBody);
+	}
+
+	for (const CarSnapshot& carSnapshot : snapshot.cars) {
+		Car* car = _carIDMap[carSnapshot.id];
+		car->controls = carSnapshot.controls;
+		car->_internalState = carSnapshot.internalState;
+		car->_velocityImpulseCache = carSnapshot.velocityImpulseCache;
+		car->_eventCounts = carSnapshot.eventCounts;
+		carSnapshot.rigidBody.Restore(car->_rigidBody);
+
+		for (int i = 0; i < 4; i++) {
+			btWheelInfoRL& wheel = car->_bulletVehicle.m_wheelInfo[i];
+			wheel = carSnapshot.wheels[i];
+
+			// May belong to another arena, and is found again by the next suspension raycast anyway
+			wheel.m_raycastInfo.m_groundObject = NULL;
+		}
+		car->_bulletVehicle.m_pitchControl = carSnapshot.pitchControl;
+		car->_bulletVehicle.m_steeringValue = carSnapshot.steeringValue;
+	}
+
+	for (size_t i = 0; i < _boostPads.size(); i++) {
+		_boostPads[i]->_internalState = snapshot.boostPads[i];
+
+		// Only valid during a tick, and could point to another arena's car
+		_boostPads[i]->_internalState.curLockedCar = NULL;
+	}
+
+	if (broadphase) {
+		for (size_t i = 0; i < snapshot.broadphaseProxies.size(); i++) {
+			const BroadphaseProxySnapshot& proxySnapshot = snapshot.broadphaseProxies[i];
+			btRigidBody& rb = proxySnapshot.carID ? _carIDMap[proxySnapshot.carID]->_rigidBody : ball->_rigidBody;
+
+			auto proxy = (btRSBroadphaseProxy*)rb.getBroadphaseHandle();
+			proxy->m_aabbMin = proxySnapshot.aabbMin;
+			proxy->m_aabbMax = proxySnapshot.aabbMax;
+			proxy->cellIdx = proxySnapshot.cellIdx;
+			proxy->iIdx = proxySnapshot.iIdx;
+			proxy->jIdx = proxySnapshot.jIdx;
+			proxy->kIdx = proxySnapshot.kIdx;
+			broadphase->dynProxies[i] = proxy;
+		}
+	}
+}
+
+void Arena::Reset() {
+	while (!_carIDMap.empty())
+		RemoveCar(_carIDMap.begin()->first);
+	_lastCarID = 0;
+
+	tickCount = 0;
+
+	// Stepping sets the solver's time step, a new arena starts with btContactSolverInfo's default
+	_bulletWorld.getSolverInfo().m_timeStep = btScalar(1.f / 60.f);
+
+	ball->SetState(BallState());
+	ball->_groundStickApplied = false;
+	ball->_rigidBody.clearForces();
+
+	if (_config.useCustomBroadphase) {
+		// The ball stays listed around its last cell while it's the only dynamic proxy (see btRSBroadphase::setAabb()),
+		//	so put it back where a new arena has it
+		auto proxy = (btRSBroadphaseProxy*)ball->_rigidBody.getBroadphaseHandle();
+		proxy->m_aabbMin = _initialBallProxy.aabbMin;
+		proxy->m_aabbMax = _initialBallProxy.aabbMax;
+		proxy->cellIdx = _initialBallProxy.cellIdx;
+		proxy->iIdx = _initialBallProxy.iIdx;
+		proxy->jIdx = _initialBallProxy.jIdx;
+		proxy->kIdx = _initialBallProxy.kIdx;
+	}
+
+	// Hand out the freed broadphase handles in the same order as a new arena would
+	_bulletWorldParams.broadphase->resetPool(&_bulletWorldParams.collisionDispatcher);
+
+	for (BoostPad* pad : _boostPads)
+		pad->SetState(BoostPadState());
+}
+
 void Arena::Step(int ticksToSimulate) {
 	_stop = false;
+	(this->*_stepTicksFunc)(ticksToSimulate);
+}
 
+template <GameMode GAMEMODE, bool USE_CUSTOM_BOOST_PADS>
+void Arena::_StepTicks(int ticksToSimulate) {
 	for (int i = 0; i < ticksToSimulate && !_stop; i++) {
 
-		_bulletWorld.setWorldUserInfo(this);
+		if (_replayRecorder)
+			_replayRecorder->_BeginTick();
 
 		{ // Ball zero-vel sleeping
 			if (ball->_rigidBody.m_linearVelocity.length2() == 0 && ball->_rigidBody.m_angularVelocity.length2() == 0) {
@@ -762,7 +1000,7 @@ void Arena::Step(int ticksToSimulate) {
 
 		bool ballOnly = _cars.empty();
 
-		bool hasArenaStuff = (gameMode != GameMode::THE_VOID);
+		constexpr bool hasArenaStuff = (GAMEMODE != GameMode::THE_VOID);
 		bool shouldUpdateSuspColGrid = hasArenaStuff && !ballOnly;
 		if (shouldUpdateSuspColGrid) {
 #ifndef RS_NO_SUSPCOLGRID
@@ -794,7 +1032,7 @@ void Arena::Step(int ticksToSimulate) {
 				suspColGridPtr = NULL;
 			}
 #endif
-			car->_PreTickUpdate(gameMode, tickTime, _mutatorConfig, suspColGridPtr);
+			car->_PreTickUpdate(GAMEMODE, tickTime, _mutatorConfig, suspColGridPtr);
 		}
 
 		if (shouldUpdateSuspColGrid) {
@@ -809,16 +1047,16 @@ void Arena::Step(int ticksToSimulate) {
 		}
 
 		// Update ball
-		ball->_PreTickUpdate(gameMode, tickTime);
+		ball->_PreTickUpdate<GAMEMODE>(tickTime);
 
 		// Update world
 		_bulletWorld.stepSimulation(tickTime, 0, tickTime);
 
 		for (Car* car : _cars) {
-			car->_PostTickUpdate(gameMode, tickTime, _mutatorConfig);
+			car->_PostTickUpdate(GAMEMODE, tickTime, _mutatorConfig);
 			car->_FinishPhysicsTick(_mutatorConfig);
-			if (hasArenaStuff) {
-				if (_config.useCustomBoostPads) {
+			if constexpr (hasArenaStuff) {
+				if constexpr (USE_CUSTOM_BOOST_PADS) {
 					// TODO: This is quite slow, we should use a sorting method of some sort
 					for (auto& boostPad : _boostPads) {
 						boostPad->_CheckCollide(car);
@@ -833,20 +1071,29 @@ void Arena::Step(int ticksToSimulate) {
 		{
 			for (BoostPad* pad : _boostPads)
 			{
-				if (pad->_PostTickUpdate(tickTime, _mutatorConfig) && _boostPickupCallback.func)
-					_boostPickupCallback.func(this, pad->_internalState.curLockedCar, pad, _boostPickupCallback.userInfo);
+				if (pad->_PostTickUpdate(tickTime, _mutatorConfig)) {
+					pad->_internalState.curLockedCar->_eventCounts.boostPickups++;
+					if (_boostPickupCallback.func)
+						_boostPickupCallback.func(this, pad->_internalState.curLockedCar, pad, _boostPickupCallback.userInfo);
+				}
 			}
 		}
 
 		ball->_FinishPhysicsTick(_mutatorConfig);
 
 		if (_goalScoreCallback.func != NULL) { // Potentially fire goal score callback
-			if (IsBallScored()) {
+			if (_IsBallScored<GAMEMODE>()) {
 				_goalScoreCallback.func(this, RS_TEAM_FROM_Y(-ball->_rigidBody.getWorldTransform().m_origin.y()), _goalScoreCallback.userInfo);
 			}
 		}
 
 		tickCount++;
+
+		if (_recorder)
+			_recorder->_RecordTick();
+
+		if (_replayRecorder)
+			_replayRecorder->_EndTick();
 	}
 }
 
@@ -854,6 +1101,50 @@ void Arena::Stop() {
 	_stop = true;
 }
 
+ArenaStepResult Arena::StepAndExport(
+	int ticksToSimulate, const CarControls* controls,
+	CarState* carStatesOut, CarEventCounts* carEventsOut, BallState* ballStateOut) {
+
+	_exportCars.assign(_cars.begin(), _cars.end());
+	std::sort(_exportCars.begin(), _exportCars.end(), [](Car* a, Car* b) { return a->id < b->id; });
+
+	_exportEventCounts.resize(_exportCars.size());
+	for (size_t i = 0; i < _exportCars.size(); i++) {
+		if (controls)
+			_exportCars[i]->controls = controls[i];
+		_exportEventCounts[i] = _exportCars[i]->_eventCounts;
+	}
+
+	ArenaStepResult result = {};
+	while (result.ticksSimulated < ticksToSimulate) {
+		Step(1);
+		result.ticksSimulated++;
+
+		if (IsBallScored()) {
+			result.goalScored = true;
+			result.scoringTeam = RS_TEAM_FROM_Y(-ball->_rigidBody.getWorldTransform().m_origin.y());
+			break;
+		}
+
+		// Step() resets this, so check it ourselves in case a callback wants us to stop
+		if (_stop)
+			break;
+	}
+
+	for (size_t i = 0; i < _exportCars.size(); i++) {
+		Car* car = _exportCars[i];
+		if (carStatesOut)
+			carStatesOut[i] = car->GetState();
+		if (carEventsOut)
+			carEventsOut[i] = car->_eventCounts - _exportEventCounts[i];
+	}
+
+	if (ballStateOut)
+		*ballStateOut = ball->GetState();
+
+	return result;
+}
+
 // Returns negative: within
 // Note that the returned margin is squared
 float BallWithinHoopsGoalXYMarginSq(float x, float y) {
@@ -989,36 +1280,34 @@ bool Arena::IsBallProbablyGoingIn(float maxTime, float extraMargin, Team* goalTe
 	}
 }
 
-RSAPI bool Arena::IsBallScored() const {
-	switch (gameMode) {
-	case GameMode::SOCCAR:
-	case GameMode::HEATSEEKER:
-	case GameMode::SNOWDAY:
-	{
+template <GameMode GAMEMODE>
+bool Arena::_IsBallScored() const {
+	if constexpr (GAMEMODE == GameMode::SOCCAR || GAMEMODE == GameMode::HEATSEEKER || GAMEMODE == GameMode::SNOWDAY) {
 		float ballPosY = ball->_rigidBody.getWorldTransform().m_origin.y() * BT_TO_UU;
 		return abs(ballPosY) > (_mutatorConfig.goalBaseThresholdY + _mutatorConfig.ballRadius);
-	}
-	case GameMode::HOOPS:
-	{
+	} else if constexpr (GAMEMODE == GameMode::HOOPS) {
 		if (ball->_rigidBody.getWorldTransform().m_origin.z() < RLConst::HOOPS_GOAL_SCORE_THRESHOLD_Z * UU_TO_BT) {
-			constexpr float
-				SCALE_Y = 0.9f,
-				OFFSET_Y = 2770.f,
-				RADIUS_SQ = 716 * 716;
-
 			Vec ballPos = ball->_rigidBody.getWorldTransform().m_origin * BT_TO_UU;
 			return BallWithinHoopsGoalXYMarginSq(ballPos.x, ballPos.y) < 0;
 		} else {
 			return false;
 		}
-	}
-	default:
+	} else {
 		return false;
 	}
 }
 
+RSAPI bool Arena::IsBallScored() const {
+	return GameModeDispatch(gameMode, [this](auto gameModeConst) { return _IsBallScored<decltype(gameModeConst)::value>(); });
+}
+
 Arena::~Arena() {
 
+	if (_recorder)
+		_recorder->_Close();
+	if (_replayRecorder)
+		_replayRecorder->_Close();
+
 	// Remove all from bullet world constraints
 	while (_bulletWorld.getNumConstraints() > 0)
 		_bulletWorld.removeConstraint(0);
@@ -1047,15 +1336,25 @@ Arena::~Arena() {
 		}
 	}
 
-	delete[] _worldCollisionRBs;
-	delete[] _worldCollisionPlaneShapes;
-	delete[] _worldCollisionBvhShapes;
+	// Shared world collision is freed along with the last arena using it
+	if (!_sharedStaticCollision) {
+		delete[] _worldCollisionRBs;
+		delete[] _worldCollisionPlaneShapes;
+		delete[] _worldCollisionBvhShapes;
+	}
 
 	delete _bulletWorldParams.overlappingPairCache;
 	delete _bulletWorldParams.broadphase;
 }
 
-void Arena::_SetupArenaCollisionShapes() {
+// Makes the static collision shapes and rigidbodies of a game mode's arena, without adding them to anything
+// The rigidbodies are the arena meshes followed by the arena collision planes
+// isHoopsNetOut is set for each rigidbody that should only collide with the ball
+static void MakeArenaCollisionShapes(
+	GameMode gameMode,
+	btRigidBody*& rbsOut, size_t& rbAmountOut, btBvhTriangleMeshShape*& bvhShapesOut, btStaticPlaneShape*& planeShapesOut,
+	std::vector<bool>& isHoopsNetOut) {
+
 	assert(gameMode != GameMode::THE_VOID);
 	bool isHoops = gameMode == GameMode::HOOPS;
 
@@ -1068,19 +1367,31 @@ void Arena::_SetupArenaCollisionShapes() {
 		)
 	}
 
-	_worldCollisionBvhShapes = new btBvhTriangleMeshShape[collisionMeshes.size()];
+	bvhShapesOut = new btBvhTriangleMeshShape[collisionMeshes.size()];
 
 	size_t planeAmount = isHoops ? 6 : 4;
-	_worldCollisionPlaneShapes = new btStaticPlaneShape[planeAmount];
+	planeShapesOut = new btStaticPlaneShape[planeAmount];
+
+	rbAmountOut = collisionMeshes.size() + planeAmount;
+	rbsOut = new btRigidBody[rbAmountOut];
+	isHoopsNetOut.assign(rbAmountOut, false);
 
-	_worldCollisionRBAmount = collisionMeshes.size() + planeAmount;
-	_worldCollisionRBs = new btRigidBody[_worldCollisionRBAmount];
+	auto fnAddStaticCollisionShape =
+		[&](size_t rbIndex, btCollisionShape* shape, btVector3 posBT = btVector3(0, 0, 0)) {
+			assert(rbIndex < rbAmountOut);
+			btRigidBody& shapeRB = rbsOut[rbIndex];
+			shapeRB = btRigidBody(0, NULL, shape);
+			shapeRB.setWorldTransform(btTransform(btMatrix3x3::getIdentity(), posBT));
+
+			// Give arena collision shapes the proper restitution/friction values
+			shapeRB.setRestitution(RLConst::ARENA_COLLISION_RESTITUTION);
+			shapeRB.setFriction(RLConst::ARENA_COLLISION_FRICTION);
+			shapeRB.setRollingFriction(0.f);
+		};
 
 	for (size_t i = 0; i < collisionMeshes.size(); i++) {
 		auto mesh = collisionMeshes[i];
 
-		bool isHoopsNet = false;
-
 		if (isHoops) { // Detect net mesh and disable car collision
 			const unsigned char* vertexBase;
 			int numVerts, stride;
@@ -1090,14 +1401,16 @@ void Arena::_SetupArenaCollisionShapes() {
 			
 			constexpr int HOOPS_NET_NUM_VERTS = 505;
 			if (numVerts == HOOPS_NET_NUM_VERTS) {
-				isHoopsNet = true;
+				isHoopsNetOut[i] = true;
 			}
 		}
 
-		_AddStaticCollisionShape(i, i, mesh, _worldCollisionBvhShapes, btVector3(0,0,0), isHoopsNet);
+		bvhShapesOut[i] = *mesh;
 
 		// Don't free the BVH when we deconstruct this arena
-		_worldCollisionBvhShapes[i].m_ownsBvh = false;
+		bvhShapesOut[i].m_ownsBvh = false;
+
+		fnAddStaticCollisionShape(i, &bvhShapesOut[i]);
 	}
 
 	{ // Add arena collision planes (floor/walls/ceiling)
@@ -1111,58 +1424,117 @@ void Arena::_SetupArenaCollisionShapes() {
 		// TODO: This is all very repetitive and silly
 
 		// Floor
-		auto floorShape = btStaticPlaneShape(btVector3(0, 0, 1), 0);
-		_AddStaticCollisionShape(
-			collisionMeshes.size() + 0,
-			0,
-			&floorShape, _worldCollisionPlaneShapes
-		);
+		planeShapesOut[0] = btStaticPlaneShape(btVector3(0, 0, 1), 0);
+		fnAddStaticCollisionShape(collisionMeshes.size() + 0, &planeShapesOut[0]);
 		
 		// Ceiling
-		auto ceilingShape = btStaticPlaneShape(btVector3(0, 0, -1), 0);
-		_AddStaticCollisionShape(
-			collisionMeshes.size() + 1,
-			1,
-			&ceilingShape, _worldCollisionPlaneShapes,
-			Vec(0, 0, height) * UU_TO_BT
-		);
+		planeShapesOut[1] = btStaticPlaneShape(btVector3(0, 0, -1), 0);
+		fnAddStaticCollisionShape(collisionMeshes.size() + 1, &planeShapesOut[1], Vec(0, 0, height) * UU_TO_BT);
 
 		// Side walls
-		auto leftWallShape = btStaticPlaneShape(btVector3(1, 0, 0), 0);
-		_AddStaticCollisionShape(
-			collisionMeshes.size() + 2,
-			2,
-			&leftWallShape, _worldCollisionPlaneShapes,
-			Vec(-extentX, 0, height / 2) * UU_TO_BT
-		);
-		auto rightWallShape = btStaticPlaneShape(btVector3(-1, 0, 0), 0);
-		_AddStaticCollisionShape(
-			collisionMeshes.size() + 3,
-			3,
-			&rightWallShape, _worldCollisionPlaneShapes,
-			Vec(extentX, 0, height / 2) * UU_TO_BT
-		);
+		planeShapesOut[2] = btStaticPlaneShape(btVector3(1, 0, 0), 0);
+		fnAddStaticCollisionShape(collisionMeshes.size() + 2, &planeShapesOut[2], Vec(-extentX, 0, height / 2) * UU_TO_BT);
+		planeShapesOut[3] = btStaticPlaneShape(btVector3(-1, 0, 0), 0);
+		fnAddStaticCollisionShape(collisionMeshes.size() + 3, &planeShapesOut[3], Vec(extentX, 0, height / 2) * UU_TO_BT);
 
 		if (isHoops) {
 			// Y walls
-			auto blueWallShape = btStaticPlaneShape(btVector3(0, 1, 0), 0);
-			_AddStaticCollisionShape(
-				collisionMeshes.size() + 4,
-				4,
-				&blueWallShape, _worldCollisionPlaneShapes,
-				Vec(0, -extentY, height / 2) * UU_TO_BT
-			);
-			auto orangeWallShape = btStaticPlaneShape(btVector3(0, -1, 0), 0);
-			_AddStaticCollisionShape(
-				collisionMeshes.size() + 5,
-				5,
-				&orangeWallShape, _worldCollisionPlaneShapes,
-				Vec(0, extentY, height / 2) * UU_TO_BT
-			);
+			planeShapesOut[4] = btStaticPlaneShape(btVector3(0, 1, 0), 0);
+			fnAddStaticCollisionShape(collisionMeshes.size() + 4, &planeShapesOut[4], Vec(0, -extentY, height / 2) * UU_TO_BT);
+			planeShapesOut[5] = btStaticPlaneShape(btVector3(0, -1, 0), 0);
+			fnAddStaticCollisionShape(collisionMeshes.size() + 5, &planeShapesOut[5], Vec(0, extentY, height / 2) * UU_TO_BT);
+		}
+	}
+}
+
+void Arena::_SetupArenaCollisionShapes() {
+	std::vector<bool> isHoopsNet;
+	MakeArenaCollisionShapes(
+		gameMode, _worldCollisionRBs, _worldCollisionRBAmount, _worldCollisionBvhShapes, _worldCollisionPlaneShapes, isHoopsNet
+	);
+
+	for (size_t i = 0; i < _worldCollisionRBAmount; i++) {
+		btRigidBody& shapeRB = _worldCollisionRBs[i];
+		shapeRB.setUserPointer(this);
+		if (isHoopsNet[i]) {
+			_bulletWorld.addRigidBody(&shapeRB, CollisionMasks::HOOPS_NET, CollisionMasks::HOOPS_NET);
+		} else {
+			_bulletWorld.addRigidBody(&shapeRB);
 		}
 	}
 }
 
+std::shared_ptr<const Arena::SharedStaticCollision> Arena::_GetSharedStaticCollision(GameMode gameMode, const ArenaConfig& config) {
+	btVector3 minPos = config.minPos * UU_TO_BT;
+	btVector3 maxPos = config.maxPos * UU_TO_BT;
+	float cellSize = config.maxAABBLen * UU_TO_BT;
+
+	using SharedStaticCollisionKey = std::tuple<GameMode, float, float, float, float, float, float, float>;
+	// Only weak references are kept, so the collision is freed along with the last arena using it
+	static std::map<SharedStaticCollisionKey, std::weak_ptr<const SharedStaticCollision>> cache;
+	static std::mutex cacheMutex;
+
+	SharedStaticCollisionKey key = {
+		gameMode,
+		minPos.x(), minPos.y(), minPos.z(),
+		maxPos.x(), maxPos.y(), maxPos.z(),
+		cellSize
+	};
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	auto itr = cache.find(key);
+	if (itr != cache.end()) {
+		if (auto existing = itr->second.lock())
+			return existing;
+	}
+
+	auto sharedStaticCollision = std::make_shared<SharedStaticCollision>();
+
+	std::vector<bool> isHoopsNet;
+	if (gameMode != GameMode::THE_VOID) {
+		MakeArenaCollisionShapes(
+			gameMode,
+			sharedStaticCollision->rbs, sharedStaticCollision->rbAmount,
+			sharedStaticCollision->bvhShapes, sharedStaticCollision->planeShapes,
+			isHoopsNet
+		);
+	}
+
+	auto broadphaseStatics = new btRSBroadphaseStatics(minPos, maxPos, cellSize, sharedStaticCollision->rbAmount);
+	sharedStaticCollision->broadphaseStatics = broadphaseStatics;
+
+	btVector3 contactThreshold = btVector3(gContactBreakingThreshold, gContactBreakingThreshold, gContactBreakingThreshold);
+	for (size_t i = 0; i < sharedStaticCollision->rbAmount; i++) {
+		btRigidBody& rb = sharedStaticCollision->rbs[i];
+
+		// Put the rigidbody in the same state as a static one in an arena's world after its first step,
+		//	see btDiscreteDynamicsWorld::addRigidBody() and btCollisionWorld::updateSingleAabb()
+		rb.setActivationState(ISLAND_SLEEPING);
+
+		btVector3 aabbMin, aabbMax;
+		rb.getCollisionShape()->getAabb(rb.getWorldTransform(), aabbMin, aabbMax);
+		aabbMin -= contactThreshold;
+		aabbMax += contactThreshold;
+
+		int group, mask;
+		if (isHoopsNet[i]) {
+			group = mask = CollisionMasks::HOOPS_NET;
+		} else {
+			group = btBroadphaseProxy::StaticFilter;
+			mask = btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter;
+		}
+
+		rb.setBroadphaseHandle(
+			broadphaseStatics->createProxy(aabbMin, aabbMax, rb.getCollisionShape()->getShapeType(), &rb, group, mask)
+		);
+	}
+
+	broadphaseStatics->build();
+
+	cache[key] = sharedStaticCollision;
+	return sharedStaticCollision;
+}
+
 void Arena::SetCarCarCollision(bool enable)
 {
 	_mutatorConfig.enableCarCarCollision = enable;
@@ -10,6 +10,7 @@
 #include "../SuspensionCollisionGrid/SuspensionCollisionGrid.h"
 #include "../MutatorConfig/MutatorConfig.h"
 #include "ArenaConfig/ArenaConfig.h"
+#include "ArenaSnapshot/ArenaSnapshot.h"
 
 #include "../../../libsrc/bullet3-3.24/BulletCollision/BroadphaseCollision/btDbvtBroadphase.h"
 #include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btStaticPlaneShape.h"
@@ -19,13 +20,28 @@
 #include "../../../libsrc/bullet3-3.24/BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h"
 #include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h"
 
+class btRSBroadphaseStatics;
+
 RS_NS_START
 
+class ArenaPool;
+class ArenaRecorder;
+class ReplayRecorder;
+
 using BallTouchEventFn   = void(*)(class Arena* arena, Car *car, void* userInfo);
 using BoostPickupEventFn = void(*)(class Arena* arena, Car *car, BoostPad *boostPad, void* userInfo);
 using CarBumpEventFn     = void(*)(class Arena* arena, Car* bumper, Car* victim, bool isDemo, void* userInfo);
 using GoalScoreEventFn   = void(*)(class Arena* arena, Team scoringTeam, void* userInfo);
 
+// Result of Arena::StepAndExport()
+struct ArenaStepResult {
+	// Can be less than requested if a goal was scored or Stop() was called
+	int ticksSimulated = 0;
+
+	bool goalScored = false;
+	Team scoringTeam = Team::BLUE; // Only valid if goalScored
+};
+
 // The container for all game simulation
 // Stores cars, the ball, all arena collisions, and manages the overall game state
 class Arena {
@@ -49,6 +65,9 @@ public:
 
 	SuspensionCollisionGrid _suspColGrid;
 
+	// The ball's broadphase proxy right after construction, restored by Reset() (only used with the custom broadphase)
+	BroadphaseProxySnapshot _initialBallProxy = {};
+
 	MutatorConfig _mutatorConfig;
 
 	const MutatorConfig& GetMutatorConfig() { return _mutatorConfig; }
@@ -62,9 +81,15 @@ public:
 		return 1 / tickTime;
 	}
 
-	// Total ticks this arena instance has been simulated for, never resets
+	// Total ticks this arena instance has been simulated for, only reset by Reset()
 	uint64_t tickCount = 0;
 
+	// Recorder called at the end of every tick, if any (see ArenaRecorder)
+	ArenaRecorder* _recorder = NULL;
+
+	// Replay recorder called at the start and end of every tick, if any (see ReplayRecorder)
+	ReplayRecorder* _replayRecorder = NULL;
+
 	const std::unordered_set<Car*>& GetCars() { return _cars; }
 	const std::vector<BoostPad*>& GetBoostPads() { return _boostPads; }
 
@@ -97,6 +122,21 @@ public:
 	btBvhTriangleMeshShape* _worldCollisionBvhShapes = NULL;
 	btStaticPlaneShape* _worldCollisionPlaneShapes = NULL;
 
+	// Static arena collision shared with all other arenas of the same setup, only used with ArenaMemWeightMode::SHARED
+	// The world collision arrays above then point into this, and are in our broadphase but not in our Bullet world
+	// BallPredSim collides with these as well, using the broadphase statics to find the ones near the ball
+	struct SharedStaticCollision {
+		btRigidBody* rbs = NULL;
+		size_t rbAmount = 0;
+		btBvhTriangleMeshShape* bvhShapes = NULL;
+		btStaticPlaneShape* planeShapes = NULL;
+
+		btRSBroadphaseStatics* broadphaseStatics = NULL;
+
+		~SharedStaticCollision();
+	};
+	std::shared_ptr<const SharedStaticCollision> _sharedStaticCollision;
+
 	struct {
 		BallTouchEventFn func = nullptr;
 		void* userInfo = nullptr;
@@ -128,7 +168,8 @@ public:
 	RSAPI void Serialize(DataStreamOut& out) const;
 
 	// Load new arena from serialized data
-	RSAPI static Arena* DeserializeNew(DataStreamIn& in);
+	// If a pool is given, the arena is acquired from it instead of always being constructed (see ArenaPool::Acquire())
+	RSAPI static Arena* DeserializeNew(DataStreamIn& in, ArenaPool* pool = NULL);
 
 	Arena(const Arena& other) = delete; // No copy constructor, use Arena::Clone() instead
 	Arena& operator =(const Arena& other) = delete; // No copy operator, use Arena::Clone() instead
@@ -142,12 +183,47 @@ public:
 	// NOTE: Car ID will not be restored
 	RSAPI Car* DeserializeNewCar(DataStreamIn& in, Team team);
 
+	// Save the dynamic state of the arena (cars, ball, boost pads, and tick count) into a snapshot
+	// Does not allocate unless the snapshot needs more room than it had before
+	RSAPI void SaveSnapshot(ArenaSnapshot& snapshot) const;
+
+	// Restore a snapshot saved from this arena, or from an arena with the same setup and the same car IDs
+	// Much faster than Clone() or DeserializeNew(), as nothing is reallocated
+	// When restoring into the arena the snapshot was saved from, simulation afterwards is identical to
+	//	what it was after saving, as long as the custom broadphase is used (btDbvtBroadphase contacts are not restored)
+	// NOTE: The arena's callbacks, mutator config, and car configs are not part of the snapshot
+	RSAPI void RestoreSnapshot(const ArenaSnapshot& snapshot);
+
+	// Remove all cars and put the ball, boost pads, tick count, and car IDs back to how they were when the arena was created
+	// Nothing is freed, so broadphase cells, the pair cache, and the collision dispatcher's pools are all kept for re-use
+	// NOTE: The arena's callbacks and mutator config are kept
+	RSAPI void Reset();
+
 	// Simulate everything in the arena for a given number of ticks
 	RSAPI void Step(int ticksToSimulate = 1);
 
+	// Step() specialized for a gamemode and boost pad setup, so none of that is checked every tick
+	template <GameMode GAMEMODE, bool USE_CUSTOM_BOOST_PADS>
+	void _StepTicks(int ticksToSimulate);
+
+	// The _StepTicks() specialization for this arena, chosen once when constructed
+	void (Arena::*_stepTicksFunc)(int ticksToSimulate) = NULL;
+
 	// Stop simulation
 	RSAPI void Stop();
 
+	// Apply controls, simulate, and export the results in one call, stopping early once a goal is scored
+	// Per-car arrays are in ascending car ID order with one entry per car, and any of them can be NULL
+	// carEventsOut receives only the events that happened during this call
+	RSAPI ArenaStepResult StepAndExport(
+		int ticksToSimulate, const CarControls* controls,
+		CarState* carStatesOut, CarEventCounts* carEventsOut, BallState* ballStateOut = NULL
+	);
+
+	// Scratch buffers for StepAndExport(), kept to avoid reallocating every call
+	std::vector<Car*> _exportCars;
+	std::vector<CarEventCounts> _exportEventCounts;
+
 	RSAPI void ResetToRandomKickoff(int seed = -1);
 
 	// Returns true if the ball is probably going in, does not account for wall or ceiling bounces
@@ -160,40 +236,30 @@ public:
 	// Works for all gamemodes (and does nothing in THE_VOID)
 	RSAPI bool IsBallScored() const;
 
+	template <GameMode GAMEMODE>
+	bool _IsBallScored() const;
+
 	// Free all associated memory
 	RSAPI ~Arena();
 
-	// NOTE: Passed shape pointer will be freed when arena is deconstructed
-	template <class T>
-	btRigidBody* _AddStaticCollisionShape(
-		size_t rbIndex, size_t meshListIndex, T* shape, T* meshList, btVector3 posBT = btVector3(0, 0, 0), 
-		bool isHoopsNet = false) {
-
-		static_assert(std::is_base_of<btCollisionShape, T>::value);
-		meshList[meshListIndex] = *shape;
-
-		assert(rbIndex < _worldCollisionRBAmount);
-		btRigidBody& shapeRB = _worldCollisionRBs[rbIndex];
-		shapeRB = btRigidBody(0, NULL, &meshList[meshListIndex]);
-		shapeRB.setWorldTransform(btTransform(btMatrix3x3::getIdentity(), posBT));
-		shapeRB.setUserPointer(this);
-		if (isHoopsNet) {
-			_bulletWorld.addRigidBody(&shapeRB, CollisionMasks::HOOPS_NET, CollisionMasks::HOOPS_NET);
-		} else {
-			_bulletWorld.addRigidBody(&shapeRB);
-		}
-		return &shapeRB;
-	}
-
 	void _SetupArenaCollisionShapes();
 
+	// Finds or builds the shared static collision for a setup
+	static std::shared_ptr<const SharedStaticCollision> _GetSharedStaticCollision(GameMode gameMode, const ArenaConfig& config);
+
 	// Static function called by Bullet internally when adding a collision point
+	// Set on each arena's own collision dispatcher, with the arena as userInfo
+	template <GameMode GAMEMODE>
 	static bool _BulletContactAddedCallback(
-		btManifoldPoint& cp,
+		void* userInfo, btManifoldPoint& cp,
 		const btCollisionObjectWrapper* colObjA, int partID_A, int indexA,
 		const btCollisionObjectWrapper* colObjB, int partID_B, int indexB
 	);
 
+	// Returns _BulletContactAddedCallback() specialized for this gamemode
+	static btContactAddedCallback _GetBulletContactAddedCallback(GameMode gameMode);
+
+	template <GameMode GAMEMODE>
 	void _BtCallback_OnCarBallCollision(Car* car, Ball* ball, btManifoldPoint& manifoldPoint, bool ballIsBodyA);
 	void _BtCallback_OnCarCarCollision(Car* car1, Car* car2, btManifoldPoint& manifoldPoint);
 	void _BtCallback_OnCarWorldCollision(Car* car, btCollisionObject* worldObject, btManifoldPoint& manifoldPoint);
@@ -11,8 +11,13 @@ RS_NS_START
 // Will affect whether high memory consumption is used to slightly increase speed or not
 enum class ArenaMemWeightMode : byte {
 	HEAVY, // ~1,263KB per arena with 4 cars
-	LIGHT  // ~383KB per arena with 4 cars
+	LIGHT, // ~383KB per arena with 4 cars
 	// Measurements last updated 2024/5/9
+
+	// Arena collision meshes, planes, and broadphase cells are shared read-only between all arenas with the same setup
+	// Each arena only stores its own dynamic objects, which makes running a huge amount of arenas feasible
+	// Simulates the same as HEAVY, but requires useCustomBroadphase
+	SHARED
 };
 
 // Custom boost pad
@@ -56,6 +61,6 @@ struct ArenaConfig {
 };
 
 #define ARENA_CONFIG_SERIALIZATION_FIELDS \
-minPos, maxPos, maxAABBLen, noBallRot, useCustomBroadphase
+memWeightMode, minPos, maxPos, maxAABBLen, noBallRot, useCustomBroadphase, maxObjects
 
 RS_NS_END
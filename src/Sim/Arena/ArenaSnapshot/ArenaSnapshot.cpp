@@ -0,0 +1,166 @@
+#include "ArenaSnapshot.h"
+
+RS_NS_START
+
+void RigidBodySnapshot::Save(const btRigidBody& rb) {
+	worldTransform = rb.getWorldTransform();
+	interpolationWorldTransform = rb.m_interpolationWorldTransform;
+	interpolationLinearVelocity = rb.m_interpolationLinearVelocity;
+	interpolationAngularVelocity = rb.m_interpolationAngularVelocity;
+	linearVelocity = rb.m_linearVelocity;
+	angularVelocity = rb.m_angularVelocity;
+	invInertiaTensorWorld = rb.m_invInertiaTensorWorld;
+	totalForce = rb.m_totalForce;
+	totalTorque = rb.m_totalTorque;
+	deltaLinearVelocity = rb.m_deltaLinearVelocity;
+	deltaAngularVelocity = rb.m_deltaAngularVelocity;
+	pushVelocity = rb.m_pushVelocity;
+	turnVelocity = rb.m_turnVelocity;
+	activationState = rb.m_activationState1;
+	collisionFlags = rb.m_collisionFlags;
+	deactivationTime = rb.m_deactivationTime;
+	hitFraction = rb.m_hitFraction;
+	specialResolveInfo = rb.m_specialResolveInfo;
+}
+
+void RigidBodySnapshot::Restore(btRigidBody& rb) const {
+	rb.getWorldTransform() = worldTransform;
+	rb.m_interpolationWorldTransform = interpolationWorldTransform;
+	rb.m_interpolationLinearVelocity = interpolationLinearVelocity;
+	rb.m_interpolationAngularVelocity = interpolationAngularVelocity;
+	rb.m_linearVelocity = linearVelocity;
+	rb.m_angularVelocity = angularVelocity;
+	rb.m_invInertiaTensorWorld = invInertiaTensorWorld;
+	rb.m_totalForce = totalForce;
+	rb.m_totalTorque = totalTorque;
+	rb.m_deltaLinearVelocity = deltaLinearVelocity;
+	rb.m_deltaAngularVelocity = deltaAngularVelocity;
+	rb.m_pushVelocity = pushVelocity;
+	rb.m_turnVelocity = turnVelocity;
+	rb.m_activationState1 = activationState;
+	rb.m_collisionFlags = collisionFlags;
+	rb.m_deactivationTime = deactivationTime;
+	rb.m_hitFraction = hitFraction;
+	rb.m_specialResolveInfo = specialResolveInfo;
+}
+
+void RigidBodySnapshot::Serialize(DataStreamOut& out) const {
+	out.WriteMultiple(RIGIDBODY_SNAPSHOT_SERIALIZATION_FIELDS);
+}
+
+void RigidBodySnapshot::Deserialize(DataStreamIn& in) {
+	in.ReadMultiple(RIGIDBODY_SNAPSHOT_SERIALIZATION_FIELDS);
+}
+
+void CarSnapshot::Serialize(DataStreamOut& out) const {
+	out.WriteMultiple(id, velocityImpulseCache, pitchControl, steeringValue);
+	out.WriteMultiple(CAR_CONTROLS_SERIALIZATION_FIELDS(controls));
+	out.WriteMultiple(CAR_EVENT_COUNTS_SERIALIZATION_FIELDS(eventCounts));
+
+	internalState.Serialize(out);
+
+	// Left out by CarState::Serialize(), but still used by the arena
+	const BallHitInfo& ballHitInfo = internalState.ballHitInfo;
+	out.Write<uint64_t>(internalState.updateCounter);
+	if (!ballHitInfo.isValid)
+		out.WriteMultiple(
+			ballHitInfo.relativePosOnBall, ballHitInfo.ballPos, ballHitInfo.extraHitVel,
+			ballHitInfo.tickCountWhenHit, ballHitInfo.tickCountWhenExtraImpulseApplied
+		);
+
+	rigidBody.Serialize(out);
+	for (const btWheelInfoRL& wheel : wheels)
+		out.WriteMultiple(WHEEL_SNAPSHOT_SERIALIZATION_FIELDS(wheel));
+}
+
+void CarSnapshot::Deserialize(DataStreamIn& in) {
+	in.ReadMultiple(id, velocityImpulseCache, pitchControl, steeringValue);
+	in.ReadMultiple(CAR_CONTROLS_SERIALIZATION_FIELDS(controls));
+	in.ReadMultiple(CAR_EVENT_COUNTS_SERIALIZATION_FIELDS(eventCounts));
+
+	internalState.Deserialize(in);
+
+	BallHitInfo& ballHitInfo = internalState.ballHitInfo;
+	in.Read<uint64_t>(internalState.updateCounter);
+	if (!ballHitInfo.isValid)
+		in.ReadMultiple(
+			ballHitInfo.relativePosOnBall, ballHitInfo.ballPos, ballHitInfo.extraHitVel,
+			ballHitInfo.tickCountWhenHit, ballHitInfo.tickCountWhenExtraImpulseApplied
+		);
+
+	rigidBody.Deserialize(in);
+	for (btWheelInfoRL& wheel : wheels) {
+		in.ReadMultiple(WHEEL_SNAPSHOT_SERIALIZATION_FIELDS(wheel));
+		wheel.m_raycastInfo.m_groundObject = NULL;
+		wheel.m_clientInfo = NULL;
+	}
+}
+
+void BallSnapshot::Serialize(DataStreamOut& out) const {
+	out.WriteMultiple(velocityImpulseCache, groundStickApplied);
+
+	internalState.Serialize(out);
+	out.Write<uint64_t>(internalState.updateCounter);
+
+	rigidBody.Serialize(out);
+}
+
+void BallSnapshot::Deserialize(DataStreamIn& in) {
+	in.ReadMultiple(velocityImpulseCache, groundStickApplied);
+
+	internalState.Deserialize(in);
+	in.Read<uint64_t>(internalState.updateCounter);
+
+	rigidBody.Deserialize(in);
+}
+
+void BroadphaseProxySnapshot::Serialize(DataStreamOut& out) const {
+	out.WriteMultiple(BROADPHASE_PROXY_SNAPSHOT_SERIALIZATION_FIELDS);
+}
+
+void BroadphaseProxySnapshot::Deserialize(DataStreamIn& in) {
+	in.ReadMultiple(BROADPHASE_PROXY_SNAPSHOT_SERIALIZATION_FIELDS);
+}
+
+template <typename T>
+static void WriteList(DataStreamOut& out, const std::vector<T>& list) {
+	out.Write<uint32_t>(list.size());
+	for (const T& val : list)
+		val.Serialize(out);
+}
+
+template <typename T>
+static void ReadList(DataStreamIn& in, std::vector<T>& list) {
+	// Every entry takes at least a byte, so a larger amount can't be valid
+	uint32_t amount = in.Read<uint32_t>();
+	if (amount > in.GetNumBytesLeft())
+		RS_ERR_CLOSE("ArenaSnapshot::Deserialize(): Snapshot is truncated");
+
+	list.resize(amount);
+	for (T& val : list) {
+		val.Deserialize(in);
+		if (in.IsOverflown())
+			RS_ERR_CLOSE("ArenaSnapshot::Deserialize(): Snapshot is truncated");
+	}
+}
+
+void ArenaSnapshot::Serialize(DataStreamOut& out) const {
+	out.WriteMultiple(gameMode, tickCount, solverTimeStep);
+	ball.Serialize(out);
+	WriteList(out, cars);
+	WriteList(out, boostPads);
+	WriteList(out, broadphaseProxies);
+}
+
+void ArenaSnapshot::Deserialize(DataStreamIn& in) {
+	in.ReadMultiple(gameMode, tickCount, solverTimeStep);
+	ball.Deserialize(in);
+	ReadList(in, cars);
+	ReadList(in, boostPads);
+	ReadList(in, broadphaseProxies);
+
+	if (in.IsOverflown())
+		RS_ERR_CLOSE("ArenaSnapshot::Deserialize(): Snapshot is truncated");
+}
+
+RS_NS_END
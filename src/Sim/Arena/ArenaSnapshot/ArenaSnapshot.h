@@ -0,0 +1,108 @@
+#pragma once
+#include "../../Car/Car.h"
+#include "../../Ball/Ball.h"
+#include "../../BoostPad/BoostPad.h"
+#include "../../../DataStream/DataStreamOut.h"
+#include "../../../DataStream/DataStreamIn.h"
+
+RS_NS_START
+
+// Everything about a rigidbody that can change while simulating
+struct RigidBodySnapshot {
+	btTransform worldTransform, interpolationWorldTransform;
+	btVector3 interpolationLinearVelocity, interpolationAngularVelocity;
+	btVector3 linearVelocity, angularVelocity;
+	btMatrix3x3 invInertiaTensorWorld;
+	btVector3 totalForce, totalTorque;
+	btVector3 deltaLinearVelocity, deltaAngularVelocity, pushVelocity, turnVelocity;
+	int activationState, collisionFlags;
+	float deactivationTime, hitFraction;
+	btCollisionObject::btSpecialResolveInfo specialResolveInfo;
+
+	void Save(const btRigidBody& rb);
+	void Restore(btRigidBody& rb) const;
+
+	void Serialize(DataStreamOut& out) const;
+	void Deserialize(DataStreamIn& in);
+};
+#define RIGIDBODY_SNAPSHOT_SERIALIZATION_FIELDS \
+worldTransform, interpolationWorldTransform, interpolationLinearVelocity, interpolationAngularVelocity, \
+linearVelocity, angularVelocity, invInertiaTensorWorld, totalForce, totalTorque, \
+deltaLinearVelocity, deltaAngularVelocity, pushVelocity, turnVelocity, \
+activationState, collisionFlags, deactivationTime, hitFraction, \
+specialResolveInfo.m_numSpecialCollisions, specialResolveInfo.m_totalNormal, specialResolveInfo.m_totalDist, \
+specialResolveInfo.m_restitution, specialResolveInfo.m_friction
+
+struct CarSnapshot {
+	uint32_t id;
+	CarControls controls;
+	CarState internalState;
+	Vec velocityImpulseCache;
+	CarEventCounts eventCounts;
+
+	RigidBodySnapshot rigidBody;
+	btWheelInfoRL wheels[4];
+	float pitchControl, steeringValue;
+
+	void Serialize(DataStreamOut& out) const;
+	void Deserialize(DataStreamIn& in);
+};
+
+// NOTE: Does not include the ground object or client info pointers
+#define WHEEL_SNAPSHOT_SERIALIZATION_FIELDS(name) \
+name.m_raycastInfo.m_contactNormalWS, name.m_raycastInfo.m_contactPointWS, name.m_raycastInfo.m_suspensionLength, \
+name.m_raycastInfo.m_hardPointWS, name.m_raycastInfo.m_wheelDirectionWS, name.m_raycastInfo.m_wheelAxleWS, \
+name.m_raycastInfo.m_isInContact, name.m_worldTransform, \
+name.m_chassisConnectionPointCS, name.m_wheelDirectionCS, name.m_wheelAxleCS, \
+name.m_suspensionRestLength1, name.m_maxSuspensionTravelCm, name.m_wheelsRadius, name.m_suspensionStiffness, \
+name.m_wheelsDampingCompression, name.m_wheelsDampingRelaxation, name.m_frictionSlip, name.m_steering, \
+name.m_rotation, name.m_deltaRotation, name.m_rollInfluence, name.m_maxSuspensionForce, \
+name.m_engineForce, name.m_brake, name.m_bIsFrontWheel, \
+name.m_clippedInvContactDotSuspension, name.m_suspensionRelativeVelocity, name.m_wheelsSuspensionForce, name.m_skidInfo, \
+name.m_isInContactWithWorld, name.m_steerAngle, name.m_velAtContactPoint, \
+name.m_latFriction, name.m_longFriction, name.m_impulse, name.m_suspensionForceScale, name.m_extraPushback
+
+struct BallSnapshot {
+	BallState internalState;
+	Vec velocityImpulseCache;
+	bool groundStickApplied;
+
+	RigidBodySnapshot rigidBody;
+
+	void Serialize(DataStreamOut& out) const;
+	void Deserialize(DataStreamIn& in);
+};
+
+// A dynamic proxy of btRSBroadphase, in the order the broadphase lists them
+struct BroadphaseProxySnapshot {
+	uint32_t carID; // 0 for the ball
+	btVector3 aabbMin, aabbMax;
+	int cellIdx, iIdx, jIdx, kIdx;
+
+	void Serialize(DataStreamOut& out) const;
+	void Deserialize(DataStreamIn& in);
+};
+#define BROADPHASE_PROXY_SNAPSHOT_SERIALIZATION_FIELDS \
+carID, aabbMin, aabbMax, cellIdx, iIdx, jIdx, kIdx
+
+// The dynamic state of an arena, see Arena::SaveSnapshot() and Arena::RestoreSnapshot()
+// Re-using a snapshot only allocates when it needs to hold more cars than before
+struct ArenaSnapshot {
+	GameMode gameMode;
+	uint64_t tickCount;
+
+	// Left over in the solver from the last step, and used by the next tick's suspension before the step sets it again
+	float solverTimeStep;
+
+	BallSnapshot ball;
+	std::vector<CarSnapshot> cars;
+	std::vector<BoostPadState> boostPads;
+	std::vector<BroadphaseProxySnapshot> broadphaseProxies;
+
+	// Written field by field like Car::Serialize(), along with the state those leave out (such as update counters),
+	//	so a deserialized snapshot restores exactly
+	RSAPI void Serialize(DataStreamOut& out) const;
+	RSAPI void Deserialize(DataStreamIn& in);
+};
+
+RS_NS_END
@@ -0,0 +1,133 @@
+#include "ArenaPool.h"
+#include "../ArenaRecorder/ArenaRecorder.h"
+#include "../Replay/ReplayRecorder.h"
+
+RS_NS_START
+
+static bool ArenaConfigsMatch(const ArenaConfig& a, const ArenaConfig& b) {
+	if (
+		a.memWeightMode != b.memWeightMode ||
+		!(a.minPos == b.minPos) || !(a.maxPos == b.maxPos) ||
+		a.maxAABBLen != b.maxAABBLen ||
+		a.noBallRot != b.noBallRot ||
+		a.useCustomBroadphase != b.useCustomBroadphase ||
+		a.maxObjects != b.maxObjects ||
+		a.useCustomBoostPads != b.useCustomBoostPads
+		)
+		return false;
+
+	if (a.useCustomBoostPads) {
+		if (a.customBoostPads.size() != b.customBoostPads.size())
+			return false;
+
+		for (size_t i = 0; i < a.customBoostPads.size(); i++) {
+			const BoostPadConfig& padA = a.customBoostPads[i];
+			const BoostPadConfig& padB = b.customBoostPads[i];
+			if (!(padA.pos == padB.pos) || padA.isBig != padB.isBig)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+ArenaPool::ArenaPool(size_t maxFreePerSetup) : maxFreePerSetup(maxFreePerSetup) {}
+
+static int RoundTickRate(float tickRate) {
+	return (int)roundf(tickRate);
+}
+
+ArenaPool::_Setup* ArenaPool::_FindSetup(GameMode gameMode, const ArenaConfig& config, int tickRate) {
+	for (_Setup& setup : _setups)
+		if (setup.gameMode == gameMode && setup.tickRate == tickRate && ArenaConfigsMatch(setup.config, config))
+			return &setup;
+
+	return NULL;
+}
+
+Arena* ArenaPool::Acquire(GameMode gameMode, const ArenaConfig& arenaConfig, float tickRate) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_Setup* setup = _FindSetup(gameMode, arenaConfig, RoundTickRate(tickRate));
+		if (setup && !setup->freeArenas.empty()) {
+			Arena* arena = setup->freeArenas.back();
+			setup->freeArenas.pop_back();
+
+			// The setup only matches the rounded tick rate, so use the exact one asked for
+			arena->tickTime = 1 / tickRate;
+			return arena;
+		}
+	}
+
+	// Construct outside of the lock, as it takes a while
+	return Arena::Create(gameMode, arenaConfig, tickRate);
+}
+
+void ArenaPool::Release(Arena* arena) {
+	if (!arena->ownsCars || !arena->ownsBall || !arena->ownsBoostPads)
+		RS_ERR_CLOSE("ArenaPool::Release(): Arena must own its cars, ball, and boost pads");
+
+	// Reset outside of the lock, as the arena is only ours now
+	// Mutator config goes first, as it can remake the ball
+	if (arena->_recorder)
+		arena->_recorder->_Close();
+	if (arena->_replayRecorder)
+		arena->_replayRecorder->_Close();
+	arena->SetMutatorConfig(MutatorConfig(arena->gameMode));
+	arena->Reset();
+
+	// Cleared directly, as the boost pickup and goal score setters throw on THE_VOID
+	arena->_ballTouchCallback = {};
+	arena->_carBumpCallback = {};
+	arena->_boostPickupCallback = {};
+	arena->_goalScoreCallback = {};
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		int tickRate = RoundTickRate(arena->GetTickRate());
+		_Setup* setup = _FindSetup(arena->gameMode, arena->GetArenaConfig(), tickRate);
+		if (!setup) {
+			_Setup newSetup = {};
+			newSetup.gameMode = arena->gameMode;
+			newSetup.config = arena->GetArenaConfig();
+			newSetup.tickRate = tickRate;
+			_setups.push_back(std::move(newSetup));
+			setup = &_setups.back();
+		}
+
+		if (setup->freeArenas.size() < maxFreePerSetup) {
+			setup->freeArenas.push_back(arena);
+			return;
+		}
+	}
+
+	// Pool is full for this setup
+	delete arena;
+}
+
+size_t ArenaPool::GetFreeAmount() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	size_t total = 0;
+	for (const _Setup& setup : _setups)
+		total += setup.freeArenas.size();
+	return total;
+}
+
+void ArenaPool::Clear() {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	for (_Setup& setup : _setups)
+		for (Arena* arena : setup.freeArenas)
+			delete arena;
+
+	_setups.clear();
+}
+
+ArenaPool::~ArenaPool() {
+	Clear();
+}
+
+RS_NS_END
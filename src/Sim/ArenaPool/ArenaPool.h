@@ -0,0 +1,58 @@
+#pragma once
+#include "../Arena/Arena.h"
+
+#include <mutex>
+
+RS_NS_START
+
+// Keeps arenas that are no longer needed, so they can be handed out again instead of constructing new ones
+// Free arenas are kept per setup (gamemode, arena config, and tick rate), and are reset when released (see Arena::Reset())
+// Tick rates are matched as whole numbers (i.e. 120 and 119.99 are the same setup), but acquired arenas run at the exact tick rate asked for
+// Safe to use from multiple threads
+class ArenaPool {
+public:
+
+	// Maximum amount of free arenas kept for each setup, extra released arenas are destroyed instead
+	size_t maxFreePerSetup;
+
+	RSAPI ArenaPool(size_t maxFreePerSetup = 64);
+
+	ArenaPool(const ArenaPool& other) = delete;
+	ArenaPool& operator =(const ArenaPool& other) = delete;
+
+	// Get an arena with this setup, in the same state as a newly created one
+	// Re-uses a released arena if one with the same setup is free, otherwise creates a new one
+	// NOTE: Give the arena back with Release() when done, or destroy it yourself
+	RSAPI Arena* Acquire(GameMode gameMode, const ArenaConfig& arenaConfig = {}, float tickRate = 120);
+
+	// Reset an arena and keep it for a later Acquire() with the same setup
+	// The arena does not need to have come from Acquire(), but it must own its cars, ball, and boost pads
+	// Its callbacks and mutator config are cleared and its recorders are closed, so it is handed out like a newly created arena
+	// NOTE: The arena must not be used after releasing it
+	RSAPI void Release(Arena* arena);
+
+	// Returns the total amount of free arenas in the pool
+	RSAPI size_t GetFreeAmount() const;
+
+	// Destroy all free arenas
+	RSAPI void Clear();
+
+	// Destroys all free arenas, arenas that are still acquired are not affected
+	RSAPI ~ArenaPool();
+
+	struct _Setup {
+		GameMode gameMode;
+		ArenaConfig config;
+		int tickRate;
+
+		std::vector<Arena*> freeArenas;
+	};
+	std::vector<_Setup> _setups;
+
+	_Setup* _FindSetup(GameMode gameMode, const ArenaConfig& config, int tickRate);
+
+private:
+	mutable std::mutex _mutex;
+};
+
+RS_NS_END
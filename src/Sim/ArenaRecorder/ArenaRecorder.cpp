@@ -0,0 +1,342 @@
+#include "ArenaRecorder.h"
+
+RS_NS_START
+
+static void WriteVec(float* out, const Vec& vec) {
+	out[0] = vec.x;
+	out[1] = vec.y;
+	out[2] = vec.z;
+}
+
+static void WriteRotMat(float* out, const RotMat& rotMat) {
+	WriteVec(out + 0, rotMat.forward);
+	WriteVec(out + 3, rotMat.right);
+	WriteVec(out + 6, rotMat.up);
+}
+
+ArenaRecorder::ArenaRecorder(Arena* arena, std::filesystem::path filePath, const ArenaRecorderConfig& config)
+	: config(config), _arena(arena) {
+	constexpr char ERROR_PREFIX[] = "ArenaRecorder::ArenaRecorder(): ";
+
+	if (arena->_recorder)
+		RS_ERR_CLOSE(ERROR_PREFIX << "Arena is already being recorded");
+
+	if (config.chunkTicks == 0)
+		RS_ERR_CLOSE(ERROR_PREFIX << "Chunks must have at least one tick");
+
+	this->config.maxPendingChunks = RS_MAX(config.maxPendingChunks, 1);
+
+	for (Car* car : arena->_cars)
+		_carIDs.push_back(car->id);
+	std::sort(_carIDs.begin(), _carIDs.end());
+
+	uint32_t numCars = _carIDs.size();
+	uint32_t numPads = arena->_boostPads.size();
+
+	// Must match the order of _Column
+	_columns = {
+		{ "tick", 'u', 8, {} },
+		{ "ball_pos", 'f', 4, { 3 } },
+		{ "ball_vel", 'f', 4, { 3 } },
+		{ "ball_ang_vel", 'f', 4, { 3 } },
+		{ "ball_rot_mat", 'f', 4, { 3, 3 } },
+		{ "car_pos", 'f', 4, { numCars, 3 } },
+		{ "car_vel", 'f', 4, { numCars, 3 } },
+		{ "car_ang_vel", 'f', 4, { numCars, 3 } },
+		{ "car_rot_mat", 'f', 4, { numCars, 3, 3 } },
+		{ "car_boost", 'f', 4, { numCars } },
+		{ "car_flags", 'u', 4, { numCars } },
+		{ "car_controls", 'f', 4, { numCars, 5 } }, // throttle, steer, pitch, yaw, roll
+		{ "car_buttons", 'u', 1, { numCars, 3 } }, // jump, boost, handbrake
+		{ "car_events", 'u', 4, { numCars, 4 } }, // ball touches, demos inflicted, times demoed, boost pickups
+		{ "pad_active", 'u', 1, { numPads } },
+		{ "pad_cooldown", 'f', 4, { numPads } },
+		{ "goal", 'u', 1, {} },
+	};
+
+	size_t chunkSize = 0;
+	for (const ArenaRecordingColumn& column : _columns) {
+		_columnOffsets.push_back(chunkSize);
+		chunkSize = ArenaRecordingCodec::AlignPos(chunkSize + config.chunkTicks * column.GetTickSize());
+	}
+	_columnOffsets.push_back(chunkSize);
+
+	_fileStream = std::ofstream(filePath, std::ios::binary);
+	if (!_fileStream.good())
+		RS_ERR_CLOSE(ERROR_PREFIX << "Failed to write to file " << filePath << ", cannot open file.");
+
+	{ // Write header
+		DataStreamOut out = {};
+		out.Write<uint32_t>(RS_VERSION_ID);
+		out.Write<uint32_t>(ARENA_RECORDING_MAGIC);
+		out.Write<uint8_t>((uint8_t)arena->gameMode);
+		out.Write<float>(arena->tickTime);
+		out.Write<uint8_t>(config.compress);
+
+		out.Write<uint32_t>(numCars);
+		for (uint32_t id : _carIDs) {
+			out.Write<uint32_t>(id);
+			out.Write<uint8_t>((uint8_t)arena->_carIDMap[id]->team);
+		}
+
+		out.Write<uint32_t>(numPads);
+
+		out.Write<uint32_t>(_columns.size());
+		for (const ArenaRecordingColumn& column : _columns) {
+			out.Write<uint8_t>(column.name.size());
+			for (char c : column.name)
+				out.Write<char>(c);
+
+			out.Write<char>(column.kind);
+			out.Write<uint8_t>(column.elemSize);
+			out.Write<uint8_t>(column.shape.size());
+			for (uint32_t dim : column.shape)
+				out.Write<uint32_t>(dim);
+		}
+
+		size_t paddedSize = ArenaRecordingCodec::AlignPos(out.GetSize());
+		while (out.GetSize() < paddedSize)
+			out.Write<uint8_t>(0);
+
+		_fileStream.write((char*)out.GetData(), out.GetSize());
+		_fileStream.flush();
+	}
+
+	_curChunk = _NewChunk();
+	_writerThread = std::thread(&ArenaRecorder::_WriterThreadFunc, this);
+	arena->_recorder = this;
+}
+
+void ArenaRecorder::_RecordTick() {
+	*_GetTickColumn<uint64_t>(COL_TICK) = _arena->tickCount;
+
+	{ // Ball
+		const btRigidBody& rb = _arena->ball->_rigidBody;
+		WriteVec(_GetTickColumn<float>(COL_BALL_POS), rb.getWorldTransform().m_origin * BT_TO_UU);
+		WriteVec(_GetTickColumn<float>(COL_BALL_VEL), rb.m_linearVelocity * BT_TO_UU);
+		WriteVec(_GetTickColumn<float>(COL_BALL_ANG_VEL), rb.m_angularVelocity);
+		WriteRotMat(_GetTickColumn<float>(COL_BALL_ROT_MAT), rb.getWorldTransform().getBasis());
+	}
+
+	{ // Cars
+		float* posOut = _GetTickColumn<float>(COL_CAR_POS);
+		float* velOut = _GetTickColumn<float>(COL_CAR_VEL);
+		float* angVelOut = _GetTickColumn<float>(COL_CAR_ANG_VEL);
+		float* rotMatOut = _GetTickColumn<float>(COL_CAR_ROT_MAT);
+		float* boostOut = _GetTickColumn<float>(COL_CAR_BOOST);
+		uint32_t* flagsOut = _GetTickColumn<uint32_t>(COL_CAR_FLAGS);
+		float* controlsOut = _GetTickColumn<float>(COL_CAR_CONTROLS);
+		uint8_t* buttonsOut = _GetTickColumn<uint8_t>(COL_CAR_BUTTONS);
+		uint32_t* eventsOut = _GetTickColumn<uint32_t>(COL_CAR_EVENTS);
+
+		for (size_t i = 0; i < _carIDs.size(); i++) {
+			auto itr = _arena->_carIDMap.find(_carIDs[i]);
+			if (itr == _arena->_carIDMap.end()) {
+				memset(posOut + i * 3, 0, sizeof(float) * 3);
+				memset(velOut + i * 3, 0, sizeof(float) * 3);
+				memset(angVelOut + i * 3, 0, sizeof(float) * 3);
+				memset(rotMatOut + i * 9, 0, sizeof(float) * 9);
+				boostOut[i] = 0;
+				flagsOut[i] = RECORDED_CAR_REMOVED;
+				memset(controlsOut + i * 5, 0, sizeof(float) * 5);
+				memset(buttonsOut + i * 3, 0, 3);
+				memset(eventsOut + i * 4, 0, sizeof(uint32_t) * 4);
+				continue;
+			}
+
+			const Car* car = itr->second;
+			const CarState& state = car->_internalState;
+
+			// Same as Car::GetState(), without touching the car
+			if (state.isDemoed) {
+				WriteVec(posOut + i * 3, state.pos);
+				WriteVec(velOut + i * 3, state.vel);
+				WriteVec(angVelOut + i * 3, state.angVel);
+			} else {
+				WriteVec(posOut + i * 3, car->_rigidBody.getWorldTransform().m_origin * BT_TO_UU);
+				WriteVec(velOut + i * 3, car->_rigidBody.m_linearVelocity * BT_TO_UU);
+				WriteVec(angVelOut + i * 3, car->_rigidBody.m_angularVelocity);
+			}
+			WriteRotMat(rotMatOut + i * 9, state.rotMat);
+			boostOut[i] = state.boost;
+
+			flagsOut[i] =
+				(state.isOnGround ? RECORDED_CAR_ON_GROUND : 0u) |
+				(state.hasJumped ? RECORDED_CAR_HAS_JUMPED : 0u) |
+				(state.hasDoubleJumped ? RECORDED_CAR_HAS_DOUBLE_JUMPED : 0u) |
+				(state.hasFlipped ? RECORDED_CAR_HAS_FLIPPED : 0u) |
+				(state.isJumping ? RECORDED_CAR_IS_JUMPING : 0u) |
+				(state.isFlipping ? RECORDED_CAR_IS_FLIPPING : 0u) |
+				(state.isSupersonic ? RECORDED_CAR_IS_SUPERSONIC : 0u) |
+				(state.isDemoed ? RECORDED_CAR_IS_DEMOED : 0u);
+
+			const CarControls& controls = car->controls;
+			float* carControlsOut = controlsOut + i * 5;
+			carControlsOut[0] = controls.throttle;
+			carControlsOut[1] = controls.steer;
+			carControlsOut[2] = controls.pitch;
+			carControlsOut[3] = controls.yaw;
+			carControlsOut[4] = controls.roll;
+
+			uint8_t* carButtonsOut = buttonsOut + i * 3;
+			carButtonsOut[0] = controls.jump;
+			carButtonsOut[1] = controls.boost;
+			carButtonsOut[2] = controls.handbrake;
+
+			const CarEventCounts& events = car->_eventCounts;
+			uint32_t* carEventsOut = eventsOut + i * 4;
+			carEventsOut[0] = events.ballTouches;
+			carEventsOut[1] = events.demosInflicted;
+			carEventsOut[2] = events.timesDemoed;
+			carEventsOut[3] = events.boostPickups;
+		}
+	}
+
+	{ // Boost pads
+		uint8_t* activeOut = _GetTickColumn<uint8_t>(COL_PAD_ACTIVE);
+		float* cooldownOut = _GetTickColumn<float>(COL_PAD_COOLDOWN);
+		for (size_t i = 0; i < _arena->_boostPads.size(); i++) {
+			const BoostPadState& padState = _arena->_boostPads[i]->_internalState;
+			activeOut[i] = padState.isActive;
+			cooldownOut[i] = padState.cooldown;
+		}
+	}
+
+	{ // Goal
+		uint8_t goal = 0;
+		if (_arena->IsBallScored())
+			goal = 1 + (uint8_t)RS_TEAM_FROM_Y(-_arena->ball->_rigidBody.getWorldTransform().m_origin.y());
+		*_GetTickColumn<uint8_t>(COL_GOAL) = goal;
+	}
+
+	_curChunk->numTicks++;
+	_numTicksRecorded++;
+	if (_curChunk->numTicks >= config.chunkTicks)
+		_SubmitChunk();
+}
+
+ArenaRecorder::_Chunk* ArenaRecorder::_NewChunk() {
+	_Chunk* chunk = new _Chunk();
+	chunk->data.resize(_columnOffsets.back());
+	return chunk;
+}
+
+void ArenaRecorder::_SubmitChunk() {
+	std::unique_lock<std::mutex> lock(_mutex);
+	_condVar.wait(lock, [this] { return _pendingChunks.size() < config.maxPendingChunks; });
+
+	_pendingChunks.push_back(_curChunk);
+	if (!_freeChunks.empty()) {
+		_curChunk = _freeChunks.back();
+		_freeChunks.pop_back();
+	} else {
+		_curChunk = NULL;
+	}
+
+	lock.unlock();
+	_condVar.notify_all();
+
+	if (!_curChunk)
+		_curChunk = _NewChunk();
+	_curChunk->numTicks = 0;
+}
+
+void ArenaRecorder::_WriteChunk(const _Chunk* chunk, DataStreamOut& out) {
+	out.Clear();
+	out.Write<uint32_t>(chunk->numTicks);
+	out.Write<uint32_t>(0);
+
+	for (size_t i = 0; i < _columns.size(); i++) {
+		const ArenaRecordingColumn& column = _columns[i];
+		const byte* data = chunk->data.data() + _columnOffsets[i];
+		size_t tickSize = column.GetTickSize();
+
+		size_t sizePos = out.GetSize();
+		out.Write<uint64_t>(0);
+
+		if (config.compress) {
+			ArenaRecordingCodec::Encode(data, chunk->numTicks, tickSize, column.elemSize, out);
+		} else {
+			size_t size = chunk->numTicks * tickSize;
+			if (byte* dest = out._Claim(size))
+				memcpy(dest, data, size);
+		}
+
+		uint64_t size = out.GetSize() - sizePos - sizeof(uint64_t);
+		DataStreamOut::_Copy(out.GetData() + sizePos, &size, sizeof(size));
+
+		size_t paddedSize = ArenaRecordingCodec::AlignPos(out.GetSize());
+		while (out.GetSize() < paddedSize)
+			out.Write<uint8_t>(0);
+	}
+
+	// Flushed so the chunk can be read while still recording
+	_fileStream.write((char*)out.GetData(), out.GetSize());
+	_fileStream.flush();
+}
+
+void ArenaRecorder::_WriterThreadFunc() {
+	DataStreamOut out = {};
+
+	while (true) {
+		_Chunk* chunk;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condVar.wait(lock, [this] { return !_pendingChunks.empty() || _closing; });
+			if (_pendingChunks.empty())
+				break;
+
+			chunk = _pendingChunks.front();
+		}
+
+		_WriteChunk(chunk, out);
+
+		{
+			// Only removed once written, so the chunk still counts as pending until then
+			std::lock_guard<std::mutex> lock(_mutex);
+			_pendingChunks.pop_front();
+			_freeChunks.push_back(chunk);
+		}
+		_condVar.notify_all();
+	}
+}
+
+bool ArenaRecorder::_Close() {
+	if (!_arena)
+		return true;
+
+	_arena->_recorder = NULL;
+	_arena = NULL;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_curChunk->numTicks > 0) {
+			_pendingChunks.push_back(_curChunk);
+		} else {
+			_freeChunks.push_back(_curChunk);
+		}
+		_curChunk = NULL;
+		_closing = true;
+	}
+	_condVar.notify_all();
+	_writerThread.join();
+
+	for (_Chunk* chunk : _freeChunks)
+		delete chunk;
+	_freeChunks.clear();
+
+	bool success = _fileStream.good();
+	_fileStream.close();
+	return success;
+}
+
+void ArenaRecorder::Close() {
+	if (!_Close())
+		RS_ERR_CLOSE("ArenaRecorder::Close(): Failed to write recording");
+}
+
+ArenaRecorder::~ArenaRecorder() {
+	_Close();
+}
+
+RS_NS_END
@@ -0,0 +1,123 @@
+#pragma once
+#include "../Arena/Arena.h"
+#include "ArenaRecording.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+RS_NS_START
+
+struct ArenaRecorderConfig {
+	// Ticks stored in each chunk of the file, chunks are written as a whole once filled
+	uint32_t chunkTicks = 1024;
+
+	// Compress columns (see ArenaRecordingCodec)
+	// Uncompressed recordings are bigger, but can be read without decoding anything
+	bool compress = true;
+
+	// Filled chunks that can wait for the writer thread before recording blocks until one is written
+	uint32_t maxPendingChunks = 16;
+};
+
+// Bits of the "car_flags" column
+constexpr uint32_t
+	RECORDED_CAR_ON_GROUND = 1 << 0,
+	RECORDED_CAR_HAS_JUMPED = 1 << 1,
+	RECORDED_CAR_HAS_DOUBLE_JUMPED = 1 << 2,
+	RECORDED_CAR_HAS_FLIPPED = 1 << 3,
+	RECORDED_CAR_IS_JUMPING = 1 << 4,
+	RECORDED_CAR_IS_FLIPPING = 1 << 5,
+	RECORDED_CAR_IS_SUPERSONIC = 1 << 6,
+	RECORDED_CAR_IS_DEMOED = 1 << 7;
+
+// The car was removed from the arena, the rest of its columns are zero
+constexpr uint32_t RECORDED_CAR_REMOVED = 1u << 31;
+
+// Records an arena's state at the end of every tick it simulates to a file, in chunks of columns (see ArenaRecording)
+// Columns: tick, ball (pos, vel, ang vel, rot mat), car (pos, vel, ang vel, rot mat, boost, flags),
+// car controls and buttons, car events (ball touches, demos inflicted, times demoed, boost pickups),
+// boost pads (active, cooldown), and goal (0 if none, otherwise 1 + the scoring team)
+// Filled chunks are compressed and written by a background thread, recording a tick only copies its state
+// NOTE: Cars are fixed when recording starts, cars added afterwards are not recorded
+class ArenaRecorder {
+public:
+	ArenaRecorderConfig config;
+
+	// Starts recording the arena's next ticks
+	// Only one recorder can record an arena at a time
+	RSAPI ArenaRecorder(Arena* arena, std::filesystem::path filePath, const ArenaRecorderConfig& config = {});
+
+	ArenaRecorder(const ArenaRecorder& other) = delete;
+	ArenaRecorder& operator =(const ArenaRecorder& other) = delete;
+
+	// Write any remaining ticks and stop recording
+	// Also done when the recorder or its arena is destroyed
+	RSAPI void Close();
+
+	// Close(), but returns false instead of throwing if writing failed
+	bool _Close();
+
+	bool IsOpen() const {
+		return _arena != NULL;
+	}
+
+	uint64_t GetNumTicksRecorded() const {
+		return _numTicksRecorded;
+	}
+
+	RSAPI ~ArenaRecorder();
+
+	// Called by the arena at the end of every tick
+	void _RecordTick();
+
+	enum _Column {
+		COL_TICK,
+		COL_BALL_POS, COL_BALL_VEL, COL_BALL_ANG_VEL, COL_BALL_ROT_MAT,
+		COL_CAR_POS, COL_CAR_VEL, COL_CAR_ANG_VEL, COL_CAR_ROT_MAT, COL_CAR_BOOST, COL_CAR_FLAGS,
+		COL_CAR_CONTROLS, COL_CAR_BUTTONS, COL_CAR_EVENTS,
+		COL_PAD_ACTIVE, COL_PAD_COOLDOWN,
+		COL_GOAL,
+		COL_AMOUNT
+	};
+
+	struct _Chunk {
+		uint32_t numTicks = 0;
+
+		// Every column for chunkTicks ticks, starting at _columnOffsets
+		std::vector<byte> data;
+	};
+
+	Arena* _arena;
+	std::vector<uint32_t> _carIDs;
+	std::vector<ArenaRecordingColumn> _columns;
+	std::vector<size_t> _columnOffsets;
+
+	_Chunk* _curChunk = NULL;
+	uint64_t _numTicksRecorded = 0;
+
+	// Returns where this tick's values of a column go
+	template <typename T>
+	T* _GetTickColumn(_Column column) {
+		return (T*)(_curChunk->data.data() + _columnOffsets[column] + _curChunk->numTicks * _columns[column].GetTickSize());
+	}
+
+	_Chunk* _NewChunk();
+
+	// Hand the current chunk to the writer thread, and start a new one
+	void _SubmitChunk();
+
+	void _WriteChunk(const _Chunk* chunk, DataStreamOut& out);
+	void _WriterThreadFunc();
+
+	std::ofstream _fileStream;
+	std::thread _writerThread;
+	std::mutex _mutex;
+	std::condition_variable _condVar;
+	std::deque<_Chunk*> _pendingChunks;
+	std::vector<_Chunk*> _freeChunks;
+	bool _closing = false;
+};
+
+RS_NS_END
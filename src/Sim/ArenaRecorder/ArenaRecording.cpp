@@ -0,0 +1,224 @@
+#include "ArenaRecording.h"
+
+#include "../../DataStream/DataStreamIn.h"
+
+RS_NS_START
+
+namespace ArenaRecordingCodec {
+	static uint64_t LoadValue(const byte* ptr, uint8_t elemSize) {
+		switch (elemSize) {
+		case 1: return *ptr;
+		case 2: { uint16_t val; memcpy(&val, ptr, sizeof(val)); return val; }
+		case 4: { uint32_t val; memcpy(&val, ptr, sizeof(val)); return val; }
+		default: { uint64_t val; memcpy(&val, ptr, sizeof(val)); return val; }
+		}
+	}
+
+	static void StoreValue(byte* ptr, uint8_t elemSize, uint64_t val) {
+		switch (elemSize) {
+		case 1: *ptr = (byte)val; break;
+		case 2: { uint16_t v = (uint16_t)val; memcpy(ptr, &v, sizeof(v)); break; }
+		case 4: { uint32_t v = (uint32_t)val; memcpy(ptr, &v, sizeof(v)); break; }
+		default: memcpy(ptr, &val, sizeof(val)); break;
+		}
+	}
+
+	void Encode(const byte* data, size_t numTicks, size_t tickSize, uint8_t elemSize, DataStreamOut& out) {
+		size_t numElems = numTicks * tickSize / elemSize;
+		size_t elemsPerTick = tickSize / elemSize;
+		size_t tagsSize = (numElems + 1) / 2;
+
+		// Claim the most we could need, and give back what we didn't use
+		// If it doesn't fit in a fixed buffer, the stream is left overflown like any other write
+		byte* tags = out._Claim(GetMaxEncodedSize(numElems, elemSize));
+		if (!tags)
+			return;
+
+		byte* dest = tags + tagsSize;
+		memset(tags, 0, tagsSize);
+
+		for (size_t i = 0; i < numElems; i++) {
+			uint64_t val = LoadValue(data + i * elemSize, elemSize);
+			if (i >= elemsPerTick)
+				val ^= LoadValue(data + (i - elemsPerTick) * elemSize, elemSize);
+
+			uint8_t numBytes = 0;
+			while (val >> (numBytes * 8))
+				numBytes++;
+
+			tags[i / 2] |= numBytes << ((i % 2) * 4);
+			for (uint8_t j = 0; j < numBytes; j++)
+				*(dest++) = (byte)(val >> (j * 8));
+		}
+
+		out.Truncate(dest - out.GetData());
+	}
+
+	bool Decode(const byte* data, size_t dataSize, size_t numTicks, size_t tickSize, uint8_t elemSize, byte* out) {
+		size_t numElems = numTicks * tickSize / elemSize;
+		size_t elemsPerTick = tickSize / elemSize;
+		size_t tagsSize = (numElems + 1) / 2;
+		if (dataSize < tagsSize)
+			return false;
+
+		const byte* tags = data;
+		const byte* src = data + tagsSize;
+		const byte* end = data + dataSize;
+
+		for (size_t i = 0; i < numElems; i++) {
+			uint8_t numBytes = (tags[i / 2] >> ((i % 2) * 4)) & 0xF;
+			if (numBytes > elemSize || numBytes > end - src)
+				return false;
+
+			uint64_t val = 0;
+			for (uint8_t j = 0; j < numBytes; j++)
+				val |= (uint64_t)*(src++) << (j * 8);
+
+			if (i >= elemsPerTick)
+				val ^= LoadValue(out + (i - elemsPerTick) * elemSize, elemSize);
+			StoreValue(out + i * elemSize, elemSize, val);
+		}
+
+		return src == end;
+	}
+}
+
+ArenaRecording::ArenaRecording(std::filesystem::path filePath) {
+	constexpr char ERROR_PREFIX[] = "ArenaRecording::ArenaRecording(): ";
+
+	mappedFile = std::make_shared<MappedFile>(filePath);
+	if (!mappedFile->IsValid())
+		RS_ERR_CLOSE(ERROR_PREFIX << "Failed to read file " << filePath << ", cannot open file.");
+
+	DataStreamIn in = DataStreamIn(mappedFile->GetData(), mappedFile->GetSize());
+	if (!in.DoVersionCheck() || in.Read<uint32_t>() != ARENA_RECORDING_MAGIC)
+		RS_ERR_CLOSE(ERROR_PREFIX << "Failed to read file " << filePath << ", file is not a recording or from a different version of RocketSim.");
+
+	gameMode = (GameMode)in.Read<uint8_t>();
+	tickTime = in.Read<float>();
+	compressed = in.Read<uint8_t>();
+
+	uint32_t numCars = in.Read<uint32_t>();
+	if (numCars > in.GetNumBytesLeft())
+		RS_ERR_CLOSE(ERROR_PREFIX << "Invalid car count in " << filePath << ".");
+	for (uint32_t i = 0; i < numCars; i++) {
+		carIDs.push_back(in.Read<uint32_t>());
+		carTeams.push_back(in.Read<uint8_t>());
+	}
+
+	numBoostPads = in.Read<uint32_t>();
+
+	uint32_t numColumns = in.Read<uint32_t>();
+	if (numColumns > in.GetNumBytesLeft())
+		RS_ERR_CLOSE(ERROR_PREFIX << "Invalid column count in " << filePath << ".");
+	columns.resize(numColumns);
+	for (ArenaRecordingColumn& column : columns) {
+		uint8_t nameLen = in.Read<uint8_t>();
+		for (uint8_t i = 0; i < nameLen; i++)
+			column.name += in.Read<char>();
+
+		column.kind = in.Read<char>();
+		column.elemSize = in.Read<uint8_t>();
+		uint8_t numDims = in.Read<uint8_t>();
+		for (uint8_t i = 0; i < numDims; i++)
+			column.shape.push_back(in.Read<uint32_t>());
+
+		if (column.elemSize != 1 && column.elemSize != 2 && column.elemSize != 4 && column.elemSize != 8)
+			RS_ERR_CLOSE(ERROR_PREFIX << "Invalid element size for column \"" << column.name << "\" in " << filePath << ".");
+	}
+
+	if (in.IsOverflown())
+		RS_ERR_CLOSE(ERROR_PREFIX << "File " << filePath << " ends in the header.");
+
+	// Read chunks until the end, a chunk that is cut off was still being written
+	size_t fileSize = in.GetSize();
+	size_t pos = ArenaRecordingCodec::AlignPos(in.pos);
+	while (pos + 8 <= fileSize) {
+		DataStreamIn chunkIn = DataStreamIn(mappedFile->GetData() + pos, fileSize - pos);
+
+		Chunk chunk;
+		chunk.numTicks = chunkIn.Read<uint32_t>();
+
+		bool complete = true;
+		size_t chunkPos = 8;
+		for (ArenaRecordingColumn& column : columns) {
+			if (chunkPos + 8 > chunkIn.GetSize()) {
+				complete = false;
+				break;
+			}
+
+			chunkIn.pos = chunkPos;
+			uint64_t size = chunkIn.Read<uint64_t>();
+			chunkPos += 8;
+
+			if (size > chunkIn.GetSize() - chunkPos) {
+				complete = false;
+				break;
+			}
+
+			if (!compressed && size != chunk.numTicks * column.GetTickSize())
+				RS_ERR_CLOSE(ERROR_PREFIX << "Invalid size for column \"" << column.name << "\" in " << filePath << ".");
+
+			chunk.columnOffsets.push_back(pos + chunkPos);
+			chunk.columnSizes.push_back(size);
+			chunkPos = ArenaRecordingCodec::AlignPos(chunkPos + size);
+		}
+
+		if (!complete)
+			break;
+
+		numTicks += chunk.numTicks;
+		chunks.push_back(std::move(chunk));
+		pos += chunkPos;
+	}
+}
+
+int ArenaRecording::FindColumn(const std::string& name) const {
+	for (size_t i = 0; i < columns.size(); i++)
+		if (columns[i].name == name)
+			return i;
+
+	return -1;
+}
+
+const byte* ArenaRecording::GetChunkColumn(size_t chunkIndex, size_t columnIndex, std::vector<byte>& scratch) const {
+	const Chunk& chunk = chunks[chunkIndex];
+	const ArenaRecordingColumn& column = columns[columnIndex];
+	const byte* data = mappedFile->GetData() + chunk.columnOffsets[columnIndex];
+
+	if (!compressed)
+		return data;
+
+	scratch.resize(chunk.numTicks * column.GetTickSize());
+	bool valid = ArenaRecordingCodec::Decode(
+		data, chunk.columnSizes[columnIndex], chunk.numTicks, column.GetTickSize(), column.elemSize, scratch.data()
+	);
+	if (!valid)
+		RS_ERR_CLOSE("ArenaRecording::GetChunkColumn(): Invalid data for column \"" << column.name << "\" in chunk " << chunkIndex << ".");
+
+	return scratch.data();
+}
+
+void ArenaRecording::ReadColumn(size_t columnIndex, byte* out) const {
+	const ArenaRecordingColumn& column = columns[columnIndex];
+
+	for (size_t i = 0; i < chunks.size(); i++) {
+		const Chunk& chunk = chunks[i];
+		const byte* data = mappedFile->GetData() + chunk.columnOffsets[columnIndex];
+		size_t size = chunk.numTicks * column.GetTickSize();
+
+		if (compressed) {
+			bool valid = ArenaRecordingCodec::Decode(
+				data, chunk.columnSizes[columnIndex], chunk.numTicks, column.GetTickSize(), column.elemSize, out
+			);
+			if (!valid)
+				RS_ERR_CLOSE("ArenaRecording::ReadColumn(): Invalid data for column \"" << column.name << "\" in chunk " << i << ".");
+		} else {
+			memcpy(out, data, size);
+		}
+
+		out += size;
+	}
+}
+
+RS_NS_END
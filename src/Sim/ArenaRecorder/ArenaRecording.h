@@ -0,0 +1,103 @@
+#pragma once
+#include "../GameMode.h"
+#include "../../DataStream/DataStreamOut.h"
+#include "../../DataStream/MappedFile.h"
+
+#include <memory>
+
+RS_NS_START
+
+// Follows the RocketSim version ID at the start of files written by ArenaRecorder
+constexpr uint32_t ARENA_RECORDING_MAGIC = 0x43455253; // "SREC"
+
+// One column of a recording, holding a value of the same shape every tick
+struct ArenaRecordingColumn {
+	std::string name;
+
+	// Same as numpy's dtype kinds: 'f' for floats, 'u' for unsigned integers
+	char kind;
+	uint8_t elemSize;
+
+	// Shape of the value each tick, empty for a single element
+	std::vector<uint32_t> shape;
+
+	size_t GetNumElems() const {
+		size_t result = 1;
+		for (uint32_t dim : shape)
+			result *= dim;
+		return result;
+	}
+
+	// Size of one tick of this column in bytes
+	size_t GetTickSize() const {
+		return GetNumElems() * elemSize;
+	}
+};
+
+// Compression of a compressed recording's columns
+// Each value is XOR'd with the same value from the previous tick of its chunk, so unchanged bits become zero,
+// and then stored without its high zero bytes
+// The byte count of every value is stored first as a 4-bit tag (two per byte), followed by all of the values' bytes
+namespace ArenaRecordingCodec {
+	// Everything in a recording file starts 8-byte aligned, so uncompressed columns can be used in place
+	inline size_t AlignPos(size_t pos) {
+		return (pos + 7) & ~(size_t)7;
+	}
+
+	// Maximum size of an encoded column, for reserving space
+	inline size_t GetMaxEncodedSize(size_t numElems, uint8_t elemSize) {
+		return (numElems + 1) / 2 + numElems * elemSize;
+	}
+
+	// Appends the encoded column to out
+	void Encode(const byte* data, size_t numTicks, size_t tickSize, uint8_t elemSize, DataStreamOut& out);
+
+	// Returns false if the encoded data is invalid
+	bool Decode(const byte* data, size_t dataSize, size_t numTicks, size_t tickSize, uint8_t elemSize, byte* out);
+}
+
+// Reads a file written by ArenaRecorder by memory-mapping it
+// The columns of an uncompressed recording are read in place, without copying anything
+// Chunks are read up to the end of the file, so recordings that are still being written can be read as well
+// NOTE: Column values are in the byte order of the machine that recorded them
+class ArenaRecording {
+public:
+	GameMode gameMode;
+	float tickTime;
+	bool compressed;
+
+	// Cars recorded in the car columns, in ascending ID order
+	std::vector<uint32_t> carIDs;
+	std::vector<uint8_t> carTeams;
+
+	uint32_t numBoostPads;
+
+	std::vector<ArenaRecordingColumn> columns;
+
+	struct Chunk {
+		uint32_t numTicks;
+
+		// Where each column's (possibly encoded) data is in the file
+		std::vector<size_t> columnOffsets, columnSizes;
+	};
+	std::vector<Chunk> chunks;
+
+	// Total ticks in all chunks
+	uint64_t numTicks = 0;
+
+	std::shared_ptr<MappedFile> mappedFile;
+
+	RSAPI ArenaRecording(std::filesystem::path filePath);
+
+	// Returns -1 if there is no column with this name
+	RSAPI int FindColumn(const std::string& name) const;
+
+	// Get a column's values in a chunk, as numTicks * tickSize bytes
+	// Points into the mapped file for uncompressed recordings, otherwise the chunk is decoded into scratch
+	RSAPI const byte* GetChunkColumn(size_t chunkIndex, size_t columnIndex, std::vector<byte>& scratch) const;
+
+	// Copy a column of every chunk into out, which must fit numTicks * tickSize bytes
+	RSAPI void ReadColumn(size_t columnIndex, byte* out) const;
+};
+
+RS_NS_END
@@ -16,7 +16,7 @@ bool BallState::Matches(const BallState& other, float marginPos, float marginVel
 		angVel.DistSq(other.angVel) < (marginAngVel * marginAngVel);
 }
 
-void BallState::Serialize(DataStreamOut& out) {
+void BallState::Serialize(DataStreamOut& out) const {
 	out.WriteMultiple(BALLSTATE_SERIALIZATION_FIELDS);
 }
 
@@ -96,6 +96,7 @@ void Ball::_BulletSetup(GameMode gameMode, btDynamicsWorld* bulletWorld, const M
 	constructionInfo.m_restitution = mutatorConfig.ballWorldRestitution;
 
 	_rigidBody = btRigidBody(constructionInfo);
+	_bulletWorld = bulletWorld;
 	_rigidBody.setUserIndex(BT_USERINFO_TYPE_BALL);
 	_rigidBody.setUserPointer(this);
 
@@ -109,7 +110,9 @@ void Ball::_BulletSetup(GameMode gameMode, btDynamicsWorld* bulletWorld, const M
 	int mask = btBroadphaseProxy::AllFilter;
 	if (!mutatorConfig.enableCarBallCollision)
 		mask &= ~btBroadphaseProxy::CharacterFilter;
-	bulletWorld->addRigidBody(&_rigidBody, btBroadphaseProxy::DefaultFilter | CollisionMasks::HOOPS_NET, mask);
+	// BallPredSim has no world to add the ball to
+	if (bulletWorld)
+		bulletWorld->addRigidBody(&_rigidBody, btBroadphaseProxy::DefaultFilter | CollisionMasks::HOOPS_NET, mask);
 }
 
 void Ball::_FinishPhysicsTick(const MutatorConfig& mutatorConfig) {
@@ -152,8 +155,9 @@ float Ball::GetRadiusBullet() const {
 	}
 }
 
-void Ball::_PreTickUpdate(GameMode gameMode, float tickTime) {
-	if (gameMode == GameMode::HEATSEEKER) {
+template <GameMode GAMEMODE>
+void Ball::_PreTickUpdate(float tickTime) {
+	if constexpr (GAMEMODE == GameMode::HEATSEEKER) {
 		using namespace RLConst;
 
 		auto state = GetState();
@@ -198,13 +202,14 @@ void Ball::_PreTickUpdate(GameMode gameMode, float tickTime) {
 
 			_internalState.hsInfo.timeSinceHit += tickTime;
 		}
-	} else if (gameMode == GameMode::SNOWDAY) {
+	} else if constexpr (GAMEMODE == GameMode::SNOWDAY) {
 		_groundStickApplied = false;
 	}
 }
 
-void Ball::_OnHit(GameMode gameMode, Car* car) {
-	if (gameMode == GameMode::HEATSEEKER) {
+template <GameMode GAMEMODE>
+void Ball::_OnHit(Car* car) {
+	if constexpr (GAMEMODE == GameMode::HEATSEEKER) {
 		using namespace RLConst;
 
 		bool canIncrease = (_internalState.hsInfo.timeSinceHit > Heatseeker::MIN_SPEEDUP_INTERVAL) || (_internalState.hsInfo.yTargetDir == 0);
@@ -217,10 +222,11 @@ void Ball::_OnHit(GameMode gameMode, Car* car) {
 	}
 }
 
-void Ball::_OnWorldCollision(GameMode gameMode, Vec normal, float tickTime) {
+template <GameMode GAMEMODE>
+void Ball::_OnWorldCollision(Vec normal, float tickTime) {
 	using namespace RLConst;
 
-	if (gameMode == GameMode::HEATSEEKER) {
+	if constexpr (GAMEMODE == GameMode::HEATSEEKER) {
 		if (_internalState.hsInfo.yTargetDir != 0 ) {
 			Vec pos = _rigidBody.getWorldTransform().getOrigin() * BT_TO_UU;
 			float relNormalY = normal.y * _internalState.hsInfo.yTargetDir;
@@ -247,7 +253,7 @@ void Ball::_OnWorldCollision(GameMode gameMode, Vec normal, float tickTime) {
 				_velocityImpulseCache += bounceImpulse * UU_TO_BT;
 			}
 		}
-	} else if (gameMode == GameMode::SNOWDAY) {
+	} else if constexpr (GAMEMODE == GameMode::SNOWDAY) {
 		if (!_groundStickApplied) {
 			_rigidBody.applyCentralForce(-normal * Snowday::PUCK_GROUND_STICK_FORCE);
 			_groundStickApplied = true;
@@ -255,4 +261,23 @@ void Ball::_OnWorldCollision(GameMode gameMode, Vec normal, float tickTime) {
 	}
 }
 
+void Ball::_PreTickUpdate(GameMode gameMode, float tickTime) {
+	GameModeDispatch(gameMode, [&](auto gameModeConst) { _PreTickUpdate<decltype(gameModeConst)::value>(tickTime); });
+}
+
+void Ball::_OnWorldCollision(GameMode gameMode, Vec normal, float tickTime) {
+	GameModeDispatch(gameMode, [&](auto gameModeConst) { _OnWorldCollision<decltype(gameModeConst)::value>(normal, tickTime); });
+}
+
+#define RS_INSTANTIATE_BALL_GAMEMODE(gameMode) \
+	template void Ball::_PreTickUpdate<gameMode>(float tickTime); \
+	template void Ball::_OnHit<gameMode>(Car* car); \
+	template void Ball::_OnWorldCollision<gameMode>(Vec normal, float tickTime);
+
+RS_INSTANTIATE_BALL_GAMEMODE(GameMode::SOCCAR)
+RS_INSTANTIATE_BALL_GAMEMODE(GameMode::HOOPS)
+RS_INSTANTIATE_BALL_GAMEMODE(GameMode::HEATSEEKER)
+RS_INSTANTIATE_BALL_GAMEMODE(GameMode::SNOWDAY)
+RS_INSTANTIATE_BALL_GAMEMODE(GameMode::THE_VOID)
+
 RS_NS_END
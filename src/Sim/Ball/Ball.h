@@ -39,13 +39,13 @@ struct BallState : public PhysState {
 
 	bool Matches(const BallState& other, float marginPos = 0.8, float marginVel = 0.4, float marginAngVel = 0.02) const;
 
-	void Serialize(DataStreamOut& out);
+	void Serialize(DataStreamOut& out) const;
 	void Deserialize(DataStreamIn& in);
 };
 
 #define BALLSTATE_SERIALIZATION_FIELDS \
 pos, rotMat, vel, angVel, \
-hsInfo.yTargetDir, hsInfo.curTargetSpeed, hsInfo.timeSinceHit
+hsInfo.yTargetDir, hsInfo.curTargetSpeed, hsInfo.timeSinceHit, lastHitCarID
 
 class Ball {
 public:
@@ -57,6 +57,9 @@ public:
 	btRigidBody _rigidBody;
 	btCollisionShape* _collisionShape;
 
+	// The world the ball was added to, NULL if none
+	btDynamicsWorld* _bulletWorld = NULL;
+
 	// For construction by Arena
 	static Ball* _AllocBall() { return new Ball(); }
 
@@ -79,8 +82,15 @@ public:
 		return GetRadiusBullet() * BT_TO_UU;
 	}
 
+	// Specialized for each gamemode, so the gamemode doesn't need to be checked every tick
+	template <GameMode GAMEMODE>
+	void _PreTickUpdate(float tickTime);
+	template <GameMode GAMEMODE>
+	void _OnHit(class Car* car);
+	template <GameMode GAMEMODE>
+	void _OnWorldCollision(Vec normal, float tickTime);
+
 	void _PreTickUpdate(GameMode gameMode, float tickTime);
-	void _OnHit(GameMode gameMode, class Car* car);
 	void _OnWorldCollision(GameMode gameMode, Vec normal, float tickTime);
 		
 	Ball(const Ball& other) = delete;
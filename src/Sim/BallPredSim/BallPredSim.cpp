@@ -0,0 +1,259 @@
+#include "BallPredSim.h"
+#include "../../RocketSim.h"
+
+#include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h"
+#include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionDispatch/btManifoldResult.h"
+#include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+#include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionDispatch/btInternalEdgeUtility.h"
+#include "../../../libsrc/bullet3-3.24/BulletCollision/BroadphaseCollision/btCollisionAlgorithm.h"
+#include "../../../libsrc/bullet3-3.24/BulletCollision/BroadphaseCollision/btRSBroadphase.h"
+#include "../../../libsrc/bullet3-3.24/LinearMath/btAabbUtil2.h"
+
+RS_NS_START
+
+BallPredSim::BallPredSim(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mutatorConfig(gameMode), _config(config) {
+
+	// Tickrate must be from 15 to 120tps
+	assert(tickRate >= 15 && tickRate <= 120);
+
+	RocketSim::AssertInitialized("Cannot create BallPredSim, ");
+
+	this->gameMode = gameMode;
+	this->tickTime = 1 / tickRate;
+
+	{ // Initialize collision
+		// We only ever have a few manifolds and algorithms at once
+		btDefaultCollisionConstructionInfo collisionConfigConstructionInfo = {};
+		collisionConfigConstructionInfo.m_defaultMaxPersistentManifoldPoolSize = 64;
+		collisionConfigConstructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 64;
+
+		_bulletParams.collisionConfig.setup(collisionConfigConstructionInfo);
+		_bulletParams.collisionDispatcher.setup(&_bulletParams.collisionConfig);
+
+		_bulletParams.dispatchInfo.m_stepCount = 0;
+
+		// Same solver configuration as Arena
+		_bulletParams.solverInfo.m_splitImpulsePenetrationThreshold = 1.0e30f;
+		_bulletParams.solverInfo.m_erp2 = 0.8f;
+	}
+
+	if (gameMode != GameMode::THE_VOID) {
+		_staticCollision = Arena::_GetSharedStaticCollision(gameMode, _config);
+		_staticPairs.resize(_staticCollision->rbAmount);
+	}
+
+	{ // Initialize ball
+		ball = Ball::_AllocBall();
+
+		ball->_BulletSetup(gameMode, NULL, _mutatorConfig, _config.noBallRot);
+		ball->_rigidBody.setGravity(_mutatorConfig.gravity * UU_TO_BT);
+		ball->SetState(BallState());
+	}
+
+	_bulletParams.collisionDispatcher.setContactAddedCallback(&BallPredSim::_BulletContactAddedCallback, this);
+}
+
+BallPredSim* BallPredSim::Create(GameMode gameMode, const ArenaConfig& arenaConfig, float tickRate) {
+	return new BallPredSim(gameMode, arenaConfig, tickRate);
+}
+
+void BallPredSim::_DestroyAlgorithms() {
+	for (StaticPair& pair : _staticPairs) {
+		if (pair.algorithm) {
+			pair.algorithm->~btCollisionAlgorithm();
+			_bulletParams.collisionDispatcher.freeCollisionAlgorithm(pair.algorithm);
+			pair.algorithm = NULL;
+			pair.manifold = NULL;
+		}
+	}
+}
+
+RSAPI void BallPredSim::SetMutatorConfig(const MutatorConfig& mutatorConfig) {
+	bool ballChanged = mutatorConfig.ballRadius != this->_mutatorConfig.ballRadius || mutatorConfig.ballMass != this->_mutatorConfig.ballMass;
+
+	this->_mutatorConfig = mutatorConfig;
+
+	if (ballChanged) {
+		// We'll need to remake the ball, and our algorithms are specific to its old shape
+		_DestroyAlgorithms();
+		delete ball->_collisionShape;
+		ball->_BulletSetup(gameMode, NULL, mutatorConfig, _config.noBallRot);
+	}
+
+	ball->_rigidBody.setGravity(mutatorConfig.gravity * UU_TO_BT);
+	ball->_rigidBody.setFriction(mutatorConfig.ballWorldFriction);
+	ball->_rigidBody.setRestitution(mutatorConfig.ballWorldRestitution);
+	ball->_rigidBody.setDamping(mutatorConfig.ballDrag, 0);
+}
+
+void BallPredSim::Step(int ticksToSimulate) {
+	for (int i = 0; i < ticksToSimulate; i++) {
+
+		{ // Ball zero-vel sleeping
+			if (ball->_rigidBody.m_linearVelocity.length2() == 0 && ball->_rigidBody.m_angularVelocity.length2() == 0) {
+				ball->_rigidBody.setActivationState(ISLAND_SLEEPING);
+			} else {
+				ball->_rigidBody.setActivationState(ACTIVE_TAG);
+			}
+		}
+
+		ball->_PreTickUpdate(gameMode, tickTime);
+
+		_StepBallPhysics();
+
+		ball->_FinishPhysicsTick(_mutatorConfig);
+
+		tickCount++;
+	}
+}
+
+// Has the same effect as the global ordering of manifolds into islands in btSimulationIslandManager
+// With only the ball, every manifold has the same island, so nothing compares as less
+struct BallPredManifoldSortPredicate {
+	SIMD_FORCE_INLINE bool operator()(const btPersistentManifold* /*lhs*/, const btPersistentManifold* /*rhs*/) const {
+		return false;
+	}
+};
+
+void BallPredSim::_StepBallPhysics() {
+	// This mirrors what btDiscreteDynamicsWorld::stepSimulation() does in a ball-only Arena, in the same order
+	btRigidBody& rb = ball->_rigidBody;
+
+	// tickTime is public, so it may have changed since the last step
+	_bulletParams.dispatchInfo.m_timeStep = tickTime;
+	_bulletParams.solverInfo.m_timeStep = tickTime;
+
+	if (rb.isActive())
+		rb.applyGravity();
+
+	{ // Predict unconstrained motion
+		rb.applyDamping(tickTime);
+		rb.predictIntegratedTransform(tickTime, rb.getInterpolationWorldTransform());
+	}
+
+	_manifolds.resize(0);
+
+	// Statics never collide with a sleeping ball
+	if (rb.isActive() && _staticCollision) {
+		// Broadphase AABB, see btCollisionWorld::updateSingleAabb()
+		btVector3 contactThreshold = btVector3(gContactBreakingThreshold, gContactBreakingThreshold, gContactBreakingThreshold);
+		btVector3 aabbMin, aabbMax, aabbMin2, aabbMax2;
+		rb.getCollisionShape()->getAabb(rb.getWorldTransform(), aabbMin, aabbMax);
+		rb.getCollisionShape()->getAabb(rb.getInterpolationWorldTransform(), aabbMin2, aabbMax2);
+		aabbMin -= contactThreshold;
+		aabbMax += contactThreshold;
+		aabbMin2 -= contactThreshold;
+		aabbMax2 += contactThreshold;
+		aabbMin.setMin(aabbMin2);
+		aabbMax.setMax(aabbMax2);
+
+		// Same statics in the same order as btRSBroadphase::calculateOverlappingPairs() would pair the ball with
+		// The ball collides with every static (including the hoops net), so there is nothing to filter
+		const btRSBroadphaseStatics* broadphaseStatics = _staticCollision->broadphaseStatics;
+		btRSBroadphaseProxy* const* proxies;
+		int numProxies;
+		broadphaseStatics->cellLists.get(broadphaseStatics->GetCellIdx(aabbMin), proxies, numProxies);
+
+		for (int i = 0; i < numProxies; i++) {
+			const btRSBroadphaseProxy* proxy = proxies[i];
+			if (!TestAabbAgainstAabb2(aabbMin, aabbMax, proxy->m_aabbMin, proxy->m_aabbMax))
+				continue;
+
+			auto staticRB = (const btCollisionObject*)proxy->m_clientObject;
+			StaticPair& pair = _staticPairs[proxy - broadphaseStatics->m_pHandles];
+
+			btCollisionObjectWrapper staticWrap(0, staticRB->getCollisionShape(), staticRB, staticRB->getWorldTransform(), -1, -1);
+			btCollisionObjectWrapper ballWrap(0, rb.getCollisionShape(), &rb, rb.getWorldTransform(), -1, -1);
+
+			if (!pair.algorithm) {
+				pair.algorithm = _bulletParams.collisionDispatcher.findAlgorithm(&staticWrap, &ballWrap, 0, BT_CONTACT_POINT_ALGORITHMS);
+				if (!pair.algorithm)
+					continue;
+
+				btManifoldArray manifoldArray;
+				pair.algorithm->getAllContactManifolds(manifoldArray);
+				pair.manifold = manifoldArray.size() ? manifoldArray[0] : NULL;
+			} else if (pair.manifold) {
+				// An Arena re-creates this pair every tick, so start from an empty manifold like it would
+				pair.manifold->clearManifold();
+			}
+
+			btManifoldResult contactPointResult(&staticWrap, &ballWrap);
+			contactPointResult.setContactAddedCallback(
+				_bulletParams.collisionDispatcher.getContactAddedCallback(), _bulletParams.collisionDispatcher.getContactAddedUserInfo()
+			);
+			pair.algorithm->processCollision(&staticWrap, &ballWrap, _bulletParams.dispatchInfo, &contactPointResult);
+
+			if (pair.manifold)
+				_manifolds.push_back(pair.manifold);
+		}
+	}
+
+	if (rb.isActive()) {
+		_manifolds.quickSort(BallPredManifoldSortPredicate());
+
+		btCollisionObject* bodies[] = { &rb };
+		_bulletParams.constraintSolver.solveGroup(
+			bodies, 1,
+			_manifolds.size() ? &_manifolds[0] : NULL, _manifolds.size(),
+			NULL, 0,
+			_bulletParams.solverInfo, &_bulletParams.collisionDispatcher
+		);
+	}
+
+	{ // Integrate transforms
+		rb.setHitFraction(1.f);
+		if (rb.isActive()) {
+			btTransform predictedTrans;
+			rb.predictIntegratedTransform(tickTime, predictedTrans);
+			rb.proceedToTransform(predictedTrans);
+		}
+	}
+
+	{ // Update activation state, see btDiscreteDynamicsWorld::updateActivationState()
+		rb.updateDeactivation(tickTime);
+		if (rb.wantsSleeping()) {
+			if (rb.getActivationState() == ACTIVE_TAG)
+				rb.setActivationState(WANTS_DEACTIVATION);
+			if (rb.getActivationState() == ISLAND_SLEEPING) {
+				rb.setAngularVelocity(btVector3(0, 0, 0));
+				rb.setLinearVelocity(btVector3(0, 0, 0));
+			}
+		} else {
+			if (rb.getActivationState() != DISABLE_DEACTIVATION)
+				rb.setActivationState(ACTIVE_TAG);
+		}
+	}
+
+	rb.clearForces();
+}
+
+bool BallPredSim::_BulletContactAddedCallback(
+	void* userInfo, btManifoldPoint& contactPoint,
+	const btCollisionObjectWrapper* objA, int partID_A, int indexA,
+	const btCollisionObjectWrapper* objB, int partID_B, int indexB) {
+
+	auto sim = (BallPredSim*)userInfo;
+	sim->ball->_OnWorldCollision(sim->gameMode, contactPoint.m_normalWorldOnB, sim->tickTime);
+
+	// Set as special
+	if (sim->gameMode != GameMode::SNOWDAY)
+		contactPoint.m_isSpecial = true;
+
+	// The manifold can have the bodies either way around
+	if (objA->m_collisionObject->getUserIndex() == BT_USERINFO_TYPE_BALL) {
+		btAdjustInternalEdgeContacts(contactPoint, objB, objA, partID_B, indexB);
+	} else {
+		btAdjustInternalEdgeContacts(contactPoint, objA, objB, partID_A, indexA);
+	}
+	return true;
+}
+
+BallPredSim::~BallPredSim() {
+	_DestroyAlgorithms();
+
+	Ball::_DestroyBall(ball);
+
+}
+
+RS_NS_END
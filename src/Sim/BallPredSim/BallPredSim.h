@@ -0,0 +1,96 @@
+#pragma once
+#include "../Arena/Arena.h"
+
+RS_NS_START
+
+// A lightweight simulator for the ball on its own, meant for ball prediction
+// Steps the ball directly against the arena's static collision meshes without a full Bullet world,
+//	skipping the broadphase, pair cache, and island management an Arena goes through every tick
+// Collision detection and solving still use Bullet's own algorithms, in the same order an Arena would,
+//	so results match a ball-only Arena with the same settings (using the custom broadphase)
+class BallPredSim {
+public:
+
+	GameMode gameMode;
+
+	// Time in seconds each tick (1/tickrate)
+	float tickTime;
+
+	// Total ticks simulated, never resets
+	uint64_t tickCount = 0;
+
+	Ball* ball;
+
+	// NOTE: BallPredSim should be destroyed after use
+	RSAPI static BallPredSim* Create(GameMode gameMode, const ArenaConfig& arenaConfig = {}, float tickRate = 120);
+
+	BallPredSim(const BallPredSim& other) = delete;
+	BallPredSim& operator =(const BallPredSim& other) = delete;
+
+	const ArenaConfig& GetArenaConfig() const {
+		return _config;
+	}
+
+	float GetTickRate() const {
+		return 1 / tickTime;
+	}
+
+	const MutatorConfig& GetMutatorConfig() { return _mutatorConfig; }
+	RSAPI void SetMutatorConfig(const MutatorConfig& mutatorConfig);
+
+	BallState GetBallState() {
+		return ball->GetState();
+	}
+
+	void SetBallState(const BallState& ballState) {
+		ball->SetState(ballState);
+	}
+
+	// Simulate the ball for a given number of ticks
+	RSAPI void Step(int ticksToSimulate = 1);
+
+	RSAPI ~BallPredSim();
+
+	// Static arena collision, shared with arenas of the same setup (see Arena::_GetSharedStaticCollision())
+	std::shared_ptr<const Arena::SharedStaticCollision> _staticCollision;
+
+	// Persistent collision algorithm of the ball against each static, by broadphase handle index
+	// Manifolds are cleared every tick
+	struct StaticPair {
+		btCollisionAlgorithm* algorithm = NULL;
+		btPersistentManifold* manifold = NULL;
+	};
+	std::vector<StaticPair> _staticPairs;
+
+	struct {
+		btDefaultCollisionConfiguration collisionConfig;
+		btCollisionDispatcher collisionDispatcher;
+		btSequentialImpulseConstraintSolver constraintSolver;
+		btDispatcherInfo dispatchInfo;
+		btContactSolverInfo solverInfo;
+	} _bulletParams;
+
+	// Manifolds with the ball this tick
+	btAlignedObjectArray<btPersistentManifold*> _manifolds;
+
+	MutatorConfig _mutatorConfig;
+	ArenaConfig _config;
+
+	void _StepBallPhysics();
+
+	// Static function called by Bullet internally when adding a collision point, with the sim as userInfo
+	// Only the ball and the arena's statics are ever collided, see Arena::_BulletContactAddedCallback()
+	static bool _BulletContactAddedCallback(
+		void* userInfo, btManifoldPoint& cp,
+		const btCollisionObjectWrapper* colObjA, int partID_A, int indexA,
+		const btCollisionObjectWrapper* colObjB, int partID_B, int indexB
+	);
+
+private:
+	// Constructor for use by BallPredSim::Create()
+	BallPredSim(GameMode gameMode, const ArenaConfig& config, float tickRate);
+
+	void _DestroyAlgorithms();
+};
+
+RS_NS_END
@@ -3,16 +3,20 @@
 RS_NS_START
 
 BallPredTracker::BallPredTracker(Arena* arena, size_t numPredTicks) : numPredTicks(numPredTicks) {
-	// Make ball pred arena
-	this->ballPredArena = Arena::Create(arena->gameMode, arena->GetArenaConfig(), arena->GetTickRate());
+	// Make ball pred sim
+	this->ballPredSim = BallPredSim::Create(arena->gameMode, arena->GetArenaConfig(), arena->GetTickRate());
 	lastUpdateTickCount = 0;
 
-	predData.reserve(numPredTicks);
+	_predData.reserve(numPredTicks);
 	UpdatePredFromArena(arena);
 }
 
+BallPredTracker::BallPredTracker(BallPredSim* ballPredSim, size_t numPredTicks) : ballPredSim(ballPredSim), numPredTicks(numPredTicks) {
+	lastUpdateTickCount = 0;
+}
+
 BallPredTracker::~BallPredTracker() {
-	delete this->ballPredArena;
+	delete this->ballPredSim;
 }
 
 void BallPredTracker::UpdatePredFromArena(Arena* arena) {
@@ -24,35 +28,31 @@ void BallPredTracker::UpdatePredFromArena(Arena* arena) {
 
 void BallPredTracker::UpdatePredManual(const BallState& curBallState, int ticksSinceLastUpdate) {
 
-	bool needsFullRepred;
-	if (ticksSinceLastUpdate < predData.size()) {
-		
-		if (predData[ticksSinceLastUpdate].Matches(curBallState)) {
-			// We can re-use ball prediction data
-			needsFullRepred = false;
-
-			if (ticksSinceLastUpdate > 0) {
-				// Remove the states from the front that are too old, move the rest to the front
-				predData.erase(predData.begin(), predData.begin() + ticksSinceLastUpdate);
-
-				// Predict new states until we reach numPredTicks
-				ballPredArena->ball->SetState(predData.back());
-				while (predData.size() < numPredTicks) {
-					ballPredArena->Step(1);
-					predData.push_back(ballPredArena->ball->GetState());
+	if (_predData.size() != numPredTicks)
+		_ResizePredData();
+
+	// Find the tick in our prediction that the ball is now at
+	// Checks the expected tick first, then moves outwards from it
+	int matchedTick = -1;
+	if (ticksSinceLastUpdate >= 0) {
+		for (int offset = 0; offset <= resyncSearchTicks && matchedTick < 0; offset++) {
+			for (int sign = 1; sign >= -1; sign -= 2) {
+				int tick = ticksSinceLastUpdate + offset * sign;
+				if (tick >= 0 && tick < (int)_predCount && GetPredState(tick).Matches(curBallState)) {
+					matchedTick = tick;
+					break;
 				}
-			} else {
-				// No change, no update needed
+
+				if (offset == 0)
+					break;
 			}
-		} else {
-			needsFullRepred = true;
 		}
- 
-	} else {
-		needsFullRepred = true;
 	}
 
-	if (needsFullRepred) {
+	if (matchedTick >= 0) {
+		// We can re-use ball prediction data from the matching tick onwards
+		_AdvancePred(matchedTick);
+	} else {
 		// Full re-simulation required
 		ForceUpdateAllPred(curBallState);
 	}
@@ -61,21 +61,67 @@ void BallPredTracker::UpdatePredManual(const BallState& curBallState, int ticksS
 }
 
 void BallPredTracker::ForceUpdateAllPred(const BallState& initialBallState) {
-	ballPredArena->ball->SetState(initialBallState);
-	predData.resize(numPredTicks);
-	predData[0] = initialBallState;
+	if (_predData.size() != numPredTicks)
+		_predData.resize(numPredTicks);
+
+	_predStart = 0;
+	_predCount = 0;
+	if (numPredTicks == 0)
+		return;
+
+	ballPredSim->ball->SetState(initialBallState);
+	_predData[0] = initialBallState;
 	for (size_t i = 1; i < numPredTicks; i++) {
-		ballPredArena->Step();
-		predData[i] = ballPredArena->ball->GetState();
+		ballPredSim->Step();
+		_predData[i] = ballPredSim->ball->GetState();
+	}
+	_predCount = numPredTicks;
+}
+
+void BallPredTracker::_ResizePredData() {
+	size_t keepCount = RS_MIN(_predCount, numPredTicks);
+
+	// Unroll the ring into a new buffer, so the current tick is at the front
+	std::vector<BallState> newPredData(numPredTicks);
+	for (size_t i = 0; i < keepCount; i++)
+		newPredData[i] = GetPredState(i);
+
+	_predData.swap(newPredData);
+	_predStart = 0;
+	_predCount = keepCount;
+}
+
+void BallPredTracker::_AdvancePred(size_t ticks) {
+	assert(ticks < _predCount);
+
+	// Drop the states that are too old by moving the start of the ring
+	_predStart += ticks;
+	if (_predStart >= _predData.size())
+		_predStart -= _predData.size();
+	_predCount -= ticks;
+
+	if (_predCount == numPredTicks)
+		return; // No change, no update needed
+
+	// Predict new states into the freed slots until we reach numPredTicks
+	ballPredSim->ball->SetState(GetPredState(_predCount - 1));
+	while (_predCount < numPredTicks) {
+		ballPredSim->Step(1);
+
+		size_t index = _predStart + _predCount;
+		if (index >= _predData.size())
+			index -= _predData.size();
+		_predData[index] = ballPredSim->ball->GetState();
+		_predCount++;
 	}
 }
 
 BallState BallPredTracker::GetBallStateForTime(float predTime) const {
-	if (predData.empty())
+	if (_predCount == 0)
 		RS_ERR_CLOSE("BallPredTracker::GetBallStateForTime(): Predicted ball data is empty, update prediction before calling");
 
-	int index = RS_CLAMP(predTime / ballPredArena->tickTime, 0, predData.size() - 1);
-	return predData[index];
+	int index = RS_CLAMP(predTime / ballPredSim->tickTime, 0, _predCount - 1);
+	return GetPredState(index);
 }
 
-RS_NS_END
\ No newline at end of file
+RS_NS_END
@@ -1,19 +1,28 @@
 #pragma once
-#include "../Arena/Arena.h"
+#include "../BallPredSim/BallPredSim.h"
 
 RS_NS_START
 
 // An external tool struct that predicts the ball of a given arena
 struct BallPredTracker {
-	Arena* ballPredArena;
-	std::vector<BallState> predData;
+	BallPredSim* ballPredSim;
 	size_t numPredTicks;
 
 	int lastUpdateTickCount;
 
-	// arena: The arena you want to predict the ball for (BallPredTracker will make a copy of it without the cars)
+	// If the ball doesn't match the prediction at the expected tick,
+	//	look this many ticks around it for a matching prediction to resume from before re-predicting everything
+	// Makes a missed or doubled update not cost a full re-prediction
+	int resyncSearchTicks = 4;
+
+	// arena: The arena you want to predict the ball for (BallPredTracker will make a ball-only BallPredSim with the same setup)
 	// You do not need to make another arena for BallPredTracker, it does that itself
 	BallPredTracker(Arena* arena, size_t numPredTicks);
+
+	// ballPredSim: The sim to predict with, which BallPredTracker takes ownership of (can be NULL, set it before updating)
+	// Nothing is predicted until the first update
+	BallPredTracker(BallPredSim* ballPredSim, size_t numPredTicks);
+
 	~BallPredTracker();
 
 	// No copying
@@ -24,15 +33,50 @@ struct BallPredTracker {
 	// The arena is needed for the current ball state, as well as the tick count to determine time since last update
 	void UpdatePredFromArena(Arena* arena);
 
-	// An alternate version of UpdatePred which doesn't require the arena, 
+	// An alternate version of UpdatePred which doesn't require the arena,
 	//	but instead you manually provide the current ball state and the ticks since this tracker was last updated
 	void UpdatePredManual(const BallState& curBallState, int ticksSinceLastUpdate);
 
 	// Forcefully re-predicts all ticks
 	void ForceUpdateAllPred(const BallState& initialBallState);
 
+	// Throw away all prediction data, the next update will re-predict everything
+	void ClearPred() {
+		_predData.clear();
+		_predStart = _predCount = 0;
+	}
+
+	// Amount of predicted states, including the current one
+	size_t GetNumPredStates() const {
+		return _predCount;
+	}
+
+	// Get the predicted ball state for a given amount of ticks into the future
+	const BallState& GetPredState(size_t tick) const {
+		assert(tick < _predCount);
+		size_t index = _predStart + tick;
+		if (index >= _predData.size())
+			index -= _predData.size();
+		return _predData[index];
+	}
+
 	// Get the predicted ball state at a given future time delta
 	BallState GetBallStateForTime(float predTime) const;
+
+private:
+	// Ring buffer of predicted states, use GetPredState() to access them in order
+	// Its size is resized to numPredTicks when updating
+	std::vector<BallState> _predData;
+
+	// Index of the current tick in _predData, and the amount of valid states starting from it
+	size_t _predStart = 0;
+	size_t _predCount = 0;
+
+	// Resizes the ring buffer to numPredTicks, keeping as many valid states as possible
+	void _ResizePredData();
+
+	// Drops the first ticks of prediction, then predicts new states until we have numPredTicks
+	void _AdvancePred(size_t ticks);
 };
 
-RS_NS_END
\ No newline at end of file
+RS_NS_END
@@ -322,6 +322,7 @@ void Car::Serialize(DataStreamOut& out) {
 	out.WriteMultiple(CAR_CONTROLS_SERIALIZATION_FIELDS(controls));
 	out.WriteMultiple(CAR_CONFIG_SERIALIZATION_FIELDS(config));
 	GetState().Serialize(out);
+	out.WriteMultiple(CAR_EVENT_COUNTS_SERIALIZATION_FIELDS(_eventCounts));
 }
 
 void Car::_Deserialize(DataStreamIn& in) {
@@ -330,6 +331,7 @@ void Car::_Deserialize(DataStreamIn& in) {
 	CarState newState;
 	newState.Deserialize(in);
 	_internalState = newState;
+	in.ReadMultiple(CAR_EVENT_COUNTS_SERIALIZATION_FIELDS(_eventCounts));
 }
 
 void Car::_UpdateWheels(float tickTime, const MutatorConfig& mutatorConfig, int numWheelsInContact, float forwardSpeed_UU) {
@@ -357,7 +359,7 @@ void Car::_UpdateWheels(float tickTime, const MutatorConfig& mutatorConfig, int
 		realThrottle = 1;
 
 	{ // Update throttle/brake forces
-		float driveSpeedScale = DRIVE_SPEED_TORQUE_FACTOR_CURVE.GetOutput(absForwardSpeed_UU);
+		float driveSpeedScale = Flat::DRIVE_SPEED_TORQUE_FACTOR_CURVE.GetOutput(absForwardSpeed_UU);
 
 		float engineThrottle = realThrottle;
 
@@ -398,11 +400,11 @@ void Car::_UpdateWheels(float tickTime, const MutatorConfig& mutatorConfig, int
 	}
 
 	{ // Update steering
-		float steerAngle = STEER_ANGLE_FROM_SPEED_CURVE.GetOutput(absForwardSpeed_UU);
+		float steerAngle = Flat::STEER_ANGLE_FROM_SPEED_CURVE.GetOutput(absForwardSpeed_UU);
 
 		if (_internalState.handbrakeVal) {
 			steerAngle +=
-				(POWERSLIDE_STEER_ANGLE_FROM_SPEED_CURVE.GetOutput(absForwardSpeed_UU) - steerAngle)
+				(Flat::POWERSLIDE_STEER_ANGLE_FROM_SPEED_CURVE.GetOutput(absForwardSpeed_UU) - steerAngle)
 				* _internalState.handbrakeVal;
 		}
 
@@ -412,6 +414,9 @@ void Car::_UpdateWheels(float tickTime, const MutatorConfig& mutatorConfig, int
 	}
 
 	{ // Update friction
+		// Gather the curve inputs first, so each curve is evaluated for all 4 wheels at once
+		float frictionCurveInputs[4] = {};
+		float contactNormalZs[4] = {};
 		for (int i = 0; i < 4; i++) {
 			auto& wheel = _bulletVehicle.m_wheelInfo[i];
 			if (wheel.m_raycastInfo.m_groundObject) {
@@ -424,8 +429,6 @@ void Car::_UpdateWheels(float tickTime, const MutatorConfig& mutatorConfig, int
 					latDir = wheel.m_worldTransform.getBasis().getColumn(1),
 					longDir = latDir.cross(wheel.m_raycastInfo.m_contactNormalWS);
 
-				float frictionCurveInput = 0;
-
 				btVector3 wheelDelta = wheel.m_raycastInfo.m_hardPointWS - _rigidBody.getWorldTransform().m_origin;
 
 				auto crossVec = (angularVel.cross(wheelDelta) + vel) * BT_TO_UU;
@@ -434,27 +437,45 @@ void Car::_UpdateWheels(float tickTime, const MutatorConfig& mutatorConfig, int
 
 				// Significant friction results in lateral slip
 				if (baseFriction > 5)
-					frictionCurveInput = baseFriction / (abs(crossVec.dot(longDir)) + baseFriction);
+					frictionCurveInputs[i] = baseFriction / (abs(crossVec.dot(longDir)) + baseFriction);
+
+				contactNormalZs[i] = wheel.m_raycastInfo.m_contactNormalWS.z();
+			}
+		}
 
-				float latFriction = LAT_FRICTION_CURVE.GetOutput(frictionCurveInput);
-				float longFriction = LONG_FRICTION_CURVE.GetOutput(frictionCurveInput);
+		bool isContactSticky = realThrottle != 0;
+
+		float latFrictions[4], longFrictions[4], handbrakeLatFactors[4], handbrakeLongFactors[4], nonStickyScales[4];
+		Flat::LAT_FRICTION_CURVE.GetOutput4(frictionCurveInputs, latFrictions);
+		Flat::LONG_FRICTION_CURVE.GetOutput4(frictionCurveInputs, longFrictions);
+		if (_internalState.handbrakeVal) {
+			Flat::HANDBRAKE_LAT_FRICTION_FACTOR_CURVE.GetOutput4(frictionCurveInputs, handbrakeLatFactors);
+			Flat::HANDBRAKE_LONG_FRICTION_FACTOR_CURVE.GetOutput4(frictionCurveInputs, handbrakeLongFactors);
+		}
+		if (!isContactSticky)
+			Flat::NON_STICKY_FRICTION_FACTOR_CURVE.GetOutput4(contactNormalZs, nonStickyScales);
+
+		for (int i = 0; i < 4; i++) {
+			auto& wheel = _bulletVehicle.m_wheelInfo[i];
+			if (wheel.m_raycastInfo.m_groundObject) {
+
+				float latFriction = latFrictions[i];
+				float longFriction = longFrictions[i];
 
 				if (_internalState.handbrakeVal) {
 					float handbrakeAmount = _internalState.handbrakeVal;
 
-					latFriction *= (HANDBRAKE_LAT_FRICTION_FACTOR_CURVE.GetOutput(frictionCurveInput) - 1) * handbrakeAmount + 1;
-					longFriction *= (HANDBRAKE_LONG_FRICTION_FACTOR_CURVE.GetOutput(frictionCurveInput) - 1) * handbrakeAmount + 1;
+					latFriction *= (handbrakeLatFactors[i] - 1) * handbrakeAmount + 1;
+					longFriction *= (handbrakeLongFactors[i] - 1) * handbrakeAmount + 1;
 				} else {
 					longFriction = 1; // If we aren't powersliding, it's not scaled down
 				}
 
-				bool isContactSticky = realThrottle != 0;
-
 				if (isContactSticky) {
 					// Keep current friction values
 				} else {
 					// Scale friction down with non-sticky friction curve
-					float nonStickyScale = NON_STICKY_FRICTION_FACTOR_CURVE.GetOutput(wheel.m_raycastInfo.m_contactNormalWS.z());
+					float nonStickyScale = nonStickyScales[i];
 					latFriction *= nonStickyScale;
 					longFriction *= nonStickyScale;
 				}
@@ -120,13 +120,37 @@ flipRelTorque, jumpTime, isFlipping, flipTime, isJumping, airTimeSinceJump, \
 boost, timeSpentBoosting, supersonicTime, handbrakeVal, isAutoFlipping, \
 autoFlipTimer, autoFlipTorqueScale, isDemoed, demoRespawnTimer, lastControls, \
 worldContact.hasContact, worldContact.contactNormal, \
-carContact.otherCarID, carContact.cooldownTimer
+carContact.otherCarID, carContact.cooldownTimer, isSupersonic, airTime, \
+wheelsWithContact[0], wheelsWithContact[1], wheelsWithContact[2], wheelsWithContact[3]
 
 enum class Team : byte {
 	BLUE = 0,
 	ORANGE = 1
 };
 
+// Running totals of events a car has been involved in, never reset by the arena
+// Kept when the car is serialized, cloned, or restored from a snapshot
+// Subtract an earlier copy to get the events that happened in between
+struct CarEventCounts {
+	// Number of ticks in which the car touched the ball
+	uint32_t ballTouches = 0;
+	uint32_t demosInflicted = 0;
+	uint32_t timesDemoed = 0;
+	uint32_t boostPickups = 0;
+
+	CarEventCounts operator-(const CarEventCounts& other) const {
+		return {
+			ballTouches - other.ballTouches,
+			demosInflicted - other.demosInflicted,
+			timesDemoed - other.timesDemoed,
+			boostPickups - other.boostPickups
+		};
+	}
+};
+
+#define CAR_EVENT_COUNTS_SERIALIZATION_FIELDS(name) \
+name.ballTouches, name.demosInflicted, name.timesDemoed, name.boostPickups
+
 #define RS_OPPOSITE_TEAM(team) ((team) == Team::BLUE ? Team::ORANGE : Team::BLUE)
 #define RS_TEAM_FROM_Y(y) ((y) < 0 ? Team::BLUE : Team::ORANGE)
 
@@ -161,6 +185,9 @@ public:
 	// Those values are only updated when GetState() is called
 	CarState _internalState;
 
+	// Updated by the arena as events happen, serialized with the car (see Car::Serialize())
+	CarEventCounts _eventCounts;
+
 	// Get the forward direction as a unit vector
 	Vec GetForwardDir() const {
 		return _internalState.rotMat.forward;
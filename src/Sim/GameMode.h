@@ -1,6 +1,8 @@
 #pragma once
 #include "../Framework.h"
 
+#include <type_traits>
+
 RS_NS_START
 
 enum class GameMode : byte {
@@ -23,4 +25,24 @@ constexpr const char* GAMEMODE_STRS[] = {
 	"the_void",
 };
 
+// Calls fn(std::integral_constant<GameMode, gameMode>()), so fn can be compiled separately for each gamemode
+// Use decltype(arg)::value in fn to get the gamemode as a constant
+template <typename Fn>
+inline auto GameModeDispatch(GameMode gameMode, Fn&& fn) {
+	switch (gameMode) {
+	case GameMode::SOCCAR:
+		return fn(std::integral_constant<GameMode, GameMode::SOCCAR>());
+	case GameMode::HOOPS:
+		return fn(std::integral_constant<GameMode, GameMode::HOOPS>());
+	case GameMode::HEATSEEKER:
+		return fn(std::integral_constant<GameMode, GameMode::HEATSEEKER>());
+	case GameMode::SNOWDAY:
+		return fn(std::integral_constant<GameMode, GameMode::SNOWDAY>());
+	case GameMode::THE_VOID:
+		return fn(std::integral_constant<GameMode, GameMode::THE_VOID>());
+	default:
+		RS_ERR_CLOSE("GameModeDispatch(): Invalid gamemode " << (int)gameMode);
+	}
+}
+
 RS_NS_END
@@ -0,0 +1,220 @@
+#include "ReplayPlayer.h"
+#include "../ArenaPool/ArenaPool.h"
+
+#include <algorithm>
+
+RS_NS_START
+
+// Version ID and REPLAY_MAGIC
+constexpr size_t REPLAY_HEADER_SIZE = sizeof(uint32_t) * 2;
+
+// Type, tick, discontinuity, and size
+constexpr size_t KEYFRAME_HEADER_SIZE = sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint8_t) + sizeof(uint32_t);
+
+// Car ID, then the controls as written by DataStreamOut::WriteMultiple()
+constexpr size_t TICK_CONTROLS_SIZE = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(float) * 5 + sizeof(bool) * 3;
+
+// Offset of the index record and REPLAY_MAGIC
+constexpr size_t INDEX_FOOTER_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+
+ReplayPlayer::ReplayPlayer(std::filesystem::path filePath, ArenaPool* pool) : _pool(pool), _in(filePath, true) {
+	mappedFile = _in.mappedFile;
+
+	if (_in.Read<uint32_t>() != REPLAY_MAGIC)
+		RS_ERR_CLOSE("ReplayPlayer::ReplayPlayer(): File " << filePath << " is not a replay");
+
+	if (!_ReadIndex())
+		_ScanRecords();
+
+	if (keyframes.empty() || keyframes.front().tick != 0)
+		RS_ERR_CLOSE("ReplayPlayer::ReplayPlayer(): Replay " << filePath << " has no ticks");
+}
+
+bool ReplayPlayer::_ReadIndex() {
+	size_t size = _in.GetSize();
+	if (size < REPLAY_HEADER_SIZE + INDEX_FOOTER_SIZE)
+		return false;
+
+	DataStreamIn in = DataStreamIn(_in.GetData(), size);
+	in.pos = size - INDEX_FOOTER_SIZE;
+	uint64_t indexOffset = in.Read<uint64_t>();
+	if (in.Read<uint32_t>() != REPLAY_MAGIC || indexOffset < REPLAY_HEADER_SIZE || indexOffset >= size - INDEX_FOOTER_SIZE)
+		return false;
+
+	in.pos = indexOffset;
+	if (in.Read<uint8_t>() != (uint8_t)ReplayRecordType::INDEX)
+		return false;
+
+	uint32_t amount = in.Read<uint32_t>();
+	if (amount > in.GetNumBytesLeft() / (sizeof(uint64_t) * 2 + sizeof(uint8_t)))
+		return false;
+
+	keyframes.resize(amount);
+	for (Keyframe& keyframe : keyframes) {
+		keyframe.tick = in.Read<uint64_t>();
+		keyframe.offset = in.Read<uint64_t>();
+		keyframe.discontinuity = in.Read<uint8_t>();
+	}
+	numTicks = in.Read<uint64_t>();
+
+	if (in.IsOverflown()) {
+		keyframes.clear();
+		return false;
+	}
+
+	return true;
+}
+
+void ReplayPlayer::_ScanRecords() {
+	// Read up to the last complete record, as the replay was not closed
+	DataStreamIn in = DataStreamIn(_in.GetData(), _in.GetSize());
+	in.pos = REPLAY_HEADER_SIZE;
+
+	numTicks = 0;
+	while (!in.IsDone()) {
+		size_t offset = in.pos;
+		auto type = (ReplayRecordType)in.Read<uint8_t>();
+
+		if (type == ReplayRecordType::KEYFRAME) {
+			uint64_t tick = in.Read<uint64_t>();
+			bool discontinuity = in.Read<uint8_t>();
+			in.pos += in.Read<uint32_t>();
+			if (in.IsOverflown() || tick != numTicks)
+				break;
+
+			keyframes.push_back({ tick, offset, discontinuity });
+		} else if (type == ReplayRecordType::TICK) {
+			uint32_t amount = in.Read<uint32_t>();
+			in.pos += amount * TICK_CONTROLS_SIZE;
+			if (in.IsOverflown() || keyframes.empty())
+				break;
+
+			numTicks++;
+		} else {
+			break;
+		}
+	}
+}
+
+void ReplayPlayer::_LoadKeyframe(size_t keyframeIndex) {
+	constexpr char ERROR_PREFIX[] = "ReplayPlayer::_LoadKeyframe(): ";
+
+	const Keyframe& keyframe = keyframes[keyframeIndex];
+	_in.pos = keyframe.offset;
+	if (_in.Read<uint8_t>() != (uint8_t)ReplayRecordType::KEYFRAME)
+		RS_ERR_CLOSE(ERROR_PREFIX << "No keyframe at offset " << keyframe.offset);
+	_in.pos = keyframe.offset + KEYFRAME_HEADER_SIZE;
+
+	// Give the current arena back first, so the pool can hand it right back out
+	if (_arena) {
+		if (_pool) {
+			_pool->Release(_arena);
+		} else {
+			delete _arena;
+		}
+		_arena = NULL;
+	}
+
+	Arena* arena = Arena::DeserializeNew(_in, _pool);
+	try {
+		// The serialized arena has the setup, the snapshot has its exact state
+		_snapshot.Deserialize(_in);
+		arena->RestoreSnapshot(_snapshot);
+	} catch (...) {
+		if (_pool) {
+			_pool->Release(arena);
+		} else {
+			delete arena;
+		}
+		throw;
+	}
+
+	_arena = arena;
+	_tick = keyframe.tick;
+
+	_controls.clear();
+	for (const Car* car : _arena->_cars)
+		_controls[car->id] = car->controls;
+}
+
+void ReplayPlayer::_CheckKeyframe() {
+	if (_tick >= numTicks || _in.GetNumBytesLeft() < KEYFRAME_HEADER_SIZE)
+		return;
+
+	size_t offset = _in.pos;
+	if (_in.GetData()[offset] != (uint8_t)ReplayRecordType::KEYFRAME)
+		return;
+
+	auto itr = std::lower_bound(keyframes.begin(), keyframes.end(), _tick,
+		[](const Keyframe& keyframe, uint64_t tick) { return keyframe.tick < tick; });
+
+	if (itr != keyframes.end() && itr->offset == offset && itr->discontinuity) {
+		// The recorded arena was changed here, so the simulated one is no longer it
+		_LoadKeyframe(itr - keyframes.begin());
+	} else {
+		_in.pos = offset + sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint8_t);
+		_in.pos += _in.Read<uint32_t>();
+	}
+}
+
+Arena* ReplayPlayer::Seek(uint64_t tick) {
+	if (tick > numTicks)
+		RS_ERR_CLOSE("ReplayPlayer::Seek(): Tick " << tick << " is past the end of the replay (" << numTicks << " ticks)");
+
+	// Last keyframe at or before the tick
+	auto itr = std::upper_bound(keyframes.begin(), keyframes.end(), tick,
+		[](uint64_t tick, const Keyframe& keyframe) { return tick < keyframe.tick; });
+	size_t keyframeIndex = (itr - keyframes.begin()) - 1;
+
+	// The current arena can be simulated forward if it's already past that keyframe
+	if (!_arena || _tick > tick || _tick < keyframes[keyframeIndex].tick)
+		_LoadKeyframe(keyframeIndex);
+
+	Step(tick - _tick);
+	return _arena;
+}
+
+void ReplayPlayer::Step(int ticksToSimulate) {
+	constexpr char ERROR_PREFIX[] = "ReplayPlayer::Step(): ";
+
+	if (!_arena)
+		RS_ERR_CLOSE(ERROR_PREFIX << "Nothing to simulate, Seek() first");
+
+	if (_tick + ticksToSimulate > numTicks)
+		RS_ERR_CLOSE(ERROR_PREFIX << "Cannot simulate past the end of the replay (" << numTicks << " ticks)");
+
+	for (int i = 0; i < ticksToSimulate; i++) {
+		if (_in.Read<uint8_t>() != (uint8_t)ReplayRecordType::TICK)
+			RS_ERR_CLOSE(ERROR_PREFIX << "No tick record at offset " << (_in.pos - 1));
+
+		uint32_t amount = _in.Read<uint32_t>();
+		for (uint32_t j = 0; j < amount; j++) {
+			uint32_t carID = _in.Read<uint32_t>();
+			CarControls& controls = _controls[carID];
+			_in.ReadMultiple(CAR_CONTROLS_SERIALIZATION_FIELDS(controls));
+		}
+
+		if (_in.IsOverflown())
+			RS_ERR_CLOSE(ERROR_PREFIX << "Replay is truncated");
+
+		for (Car* car : _arena->_cars)
+			car->controls = _controls[car->id];
+
+		_arena->Step(1);
+		_tick++;
+
+		_CheckKeyframe();
+	}
+}
+
+ReplayPlayer::~ReplayPlayer() {
+	if (_arena) {
+		if (_pool) {
+			_pool->Release(_arena);
+		} else {
+			delete _arena;
+		}
+	}
+}
+
+RS_NS_END
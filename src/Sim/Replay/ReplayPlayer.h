@@ -0,0 +1,77 @@
+#pragma once
+#include "ReplayRecorder.h"
+
+RS_NS_START
+
+class ArenaPool;
+
+// Plays back a file written by ReplayRecorder, re-simulating its ticks exactly as they were recorded
+// Seeking loads the nearest keyframe before the tick and simulates forward from there with the recorded controls
+// Replays that were not closed (e.g. still being recorded) are read up to their last complete record
+class ReplayPlayer {
+public:
+	struct Keyframe {
+		uint64_t tick;
+		size_t offset;
+
+		// The arena was changed between steps, rather than simulated into this state
+		bool discontinuity;
+	};
+
+	// In tick order, starting at tick 0
+	std::vector<Keyframe> keyframes;
+
+	// Ticks are counted from the start of the recording (see ReplayRecordType)
+	// Every tick up to and including numTicks (the state after the last tick) can be seeked to
+	uint64_t numTicks;
+
+	std::shared_ptr<MappedFile> mappedFile;
+
+	// If a pool is given, the player's arenas are acquired from it and released back to it
+	RSAPI ReplayPlayer(std::filesystem::path filePath, ArenaPool* pool = NULL);
+
+	ReplayPlayer(const ReplayPlayer& other) = delete;
+	ReplayPlayer& operator =(const ReplayPlayer& other) = delete;
+
+	// Get the arena as it was before simulating this tick
+	// Simulates the current arena forward if that's quicker than loading a keyframe
+	// NOTE: The arena belongs to the player, and is replaced whenever a keyframe is loaded
+	RSAPI Arena* Seek(uint64_t tick);
+
+	// Simulate the current arena forward with the recorded controls
+	RSAPI void Step(int ticksToSimulate = 1);
+
+	// NULL until the first Seek()
+	Arena* GetArena() const {
+		return _arena;
+	}
+
+	// The tick the arena is at
+	uint64_t GetTick() const {
+		return _tick;
+	}
+
+	RSAPI ~ReplayPlayer();
+
+	ArenaPool* _pool;
+	Arena* _arena = NULL;
+	uint64_t _tick = 0;
+
+	// Controls of every car in the arena, as of the last tick
+	std::unordered_map<uint32_t, CarControls> _controls;
+
+	// Where the current arena's next record is in the file
+	DataStreamIn _in;
+
+	// Re-used for every keyframe
+	ArenaSnapshot _snapshot;
+
+	bool _ReadIndex();
+	void _ScanRecords();
+	void _LoadKeyframe(size_t keyframeIndex);
+
+	// Load or skip the keyframe the arena is at, if any
+	void _CheckKeyframe();
+};
+
+RS_NS_END
@@ -0,0 +1,178 @@
+#include "ReplayRecorder.h"
+
+RS_NS_START
+
+static void WriteBtVec(DataStreamOut& out, const btVector3& vec) {
+	out.WriteMultiple(vec.x(), vec.y(), vec.z());
+}
+
+static void WriteRigidBodyState(DataStreamOut& out, const btRigidBody& rb) {
+	const btTransform& transform = rb.getWorldTransform();
+	WriteBtVec(out, transform.m_origin);
+	for (int i = 0; i < 3; i++)
+		WriteBtVec(out, transform.m_basis[i]);
+	WriteBtVec(out, rb.m_linearVelocity);
+	WriteBtVec(out, rb.m_angularVelocity);
+}
+
+static bool ControlsEqual(const CarControls& a, const CarControls& b) {
+	return
+		a.throttle == b.throttle && a.steer == b.steer &&
+		a.pitch == b.pitch && a.yaw == b.yaw && a.roll == b.roll &&
+		a.jump == b.jump && a.boost == b.boost && a.handbrake == b.handbrake;
+}
+
+ReplayRecorder::ReplayRecorder(Arena* arena, std::filesystem::path filePath, const ReplayRecorderConfig& config)
+	: config(config), _arena(arena) {
+	constexpr char ERROR_PREFIX[] = "ReplayRecorder::ReplayRecorder(): ";
+
+	if (arena->_replayRecorder)
+		RS_ERR_CLOSE(ERROR_PREFIX << "Arena is already being recorded");
+
+	if (config.keyframeInterval == 0)
+		RS_ERR_CLOSE(ERROR_PREFIX << "Keyframe interval must be at least one tick");
+
+	_fileStream = std::ofstream(filePath, std::ios::binary);
+	if (!_fileStream.good())
+		RS_ERR_CLOSE(ERROR_PREFIX << "Failed to write to file " << filePath << ", cannot open file.");
+
+	_buffer.Write<uint32_t>(RS_VERSION_ID);
+	_buffer.Write<uint32_t>(REPLAY_MAGIC);
+
+	_keyframeRequested = true;
+	arena->_replayRecorder = this;
+}
+
+void ReplayRecorder::_WriteState(DataStreamOut& out) const {
+	out.Clear();
+	out.Write<uint64_t>(_arena->tickCount);
+
+	WriteRigidBodyState(out, _arena->ball->_rigidBody);
+
+	out.Write<uint32_t>(_arena->_cars.size());
+	for (const Car* car : _arena->_cars) {
+		out.Write<uint32_t>(car->id);
+		WriteRigidBodyState(out, car->_rigidBody);
+
+		// Car::GetState() updates pos, vel, and angVel, so those only come from the rigidbody
+		const CarState& state = car->_internalState;
+		out.WriteMultiple(
+			state.boost, state.isDemoed, state.demoRespawnTimer,
+			state.hasJumped, state.hasDoubleJumped, state.hasFlipped, state.isJumping, state.isFlipping,
+			state.jumpTime, state.flipTime, state.airTime, state.airTimeSinceJump
+		);
+	}
+
+	for (const BoostPad* pad : _arena->_boostPads)
+		out.WriteMultiple(pad->_internalState.isActive, pad->_internalState.cooldown);
+}
+
+void ReplayRecorder::_BeginTick() {
+	// Anything that changed since the end of the last tick wasn't simulated, so it can only be replayed from a keyframe
+	_WriteState(_beginState);
+	bool discontinuity = _keyframeRequested ||
+		_beginState.GetSize() != _endState.GetSize() ||
+		memcmp(_beginState.GetData(), _endState.GetData(), _beginState.GetSize()) != 0;
+
+	if (discontinuity || _numTicksRecorded - _keyframes.back().tick >= config.keyframeInterval)
+		_WriteKeyframe(discontinuity);
+
+	size_t amountPos = _buffer.GetSize();
+	_buffer.Write<uint8_t>((uint8_t)ReplayRecordType::TICK);
+	_buffer.Write<uint32_t>(0);
+
+	uint32_t amount = 0;
+	for (const Car* car : _arena->_cars) {
+		CarControls& lastControls = _lastControls[car->id];
+		if (ControlsEqual(car->controls, lastControls))
+			continue;
+
+		lastControls = car->controls;
+		_buffer.Write<uint32_t>(car->id);
+		_buffer.WriteMultiple(CAR_CONTROLS_SERIALIZATION_FIELDS(lastControls));
+		amount++;
+	}
+	DataStreamOut::_Copy(_buffer.GetData() + amountPos + 1, &amount, sizeof(amount));
+}
+
+void ReplayRecorder::_EndTick() {
+	_WriteState(_endState);
+	_numTicksRecorded++;
+
+	if (_buffer.GetSize() >= config.flushSize)
+		_Flush();
+}
+
+void ReplayRecorder::_WriteKeyframe(bool discontinuity) {
+	_keyframes.push_back({ _numTicksRecorded, _bufferOffset + _buffer.GetSize(), discontinuity });
+	_keyframeRequested = false;
+
+	_keyframeStream.Clear();
+	_arena->Serialize(_keyframeStream);
+	_arena->SaveSnapshot(_snapshot);
+	_snapshot.Serialize(_keyframeStream);
+
+	_buffer.Write<uint8_t>((uint8_t)ReplayRecordType::KEYFRAME);
+	_buffer.Write<uint64_t>(_numTicksRecorded);
+	_buffer.Write<uint8_t>(discontinuity);
+	_buffer.Write<uint32_t>(_keyframeStream.GetSize());
+
+	// Already in stream byte order, so copied as-is rather than through WriteBytes()
+	if (byte* dest = _buffer._Claim(_keyframeStream.GetSize()))
+		memcpy(dest, _keyframeStream.GetData(), _keyframeStream.GetSize());
+
+	// The player only loads keyframes at discontinuities, and skips the rest when simulating through them,
+	//	so only those can start from the controls in the keyframe
+	if (discontinuity) {
+		_lastControls.clear();
+		for (const Car* car : _arena->_cars)
+			_lastControls[car->id] = car->controls;
+	}
+}
+
+void ReplayRecorder::_Flush() {
+	_fileStream.write((char*)_buffer.GetData(), _buffer.GetSize());
+	_bufferOffset += _buffer.GetSize();
+	_buffer.Clear();
+}
+
+bool ReplayRecorder::_Close() {
+	if (!_arena)
+		return true;
+
+	_arena->_replayRecorder = NULL;
+	_arena = NULL;
+
+	// Without any ticks there are no keyframes, and nothing to index
+	if (!_keyframes.empty()) {
+		_Flush();
+
+		uint64_t indexOffset = _bufferOffset;
+		_buffer.Write<uint8_t>((uint8_t)ReplayRecordType::INDEX);
+		_buffer.Write<uint32_t>(_keyframes.size());
+		for (const _Keyframe& keyframe : _keyframes) {
+			_buffer.Write<uint64_t>(keyframe.tick);
+			_buffer.Write<uint64_t>(keyframe.offset);
+			_buffer.Write<uint8_t>(keyframe.discontinuity);
+		}
+		_buffer.Write<uint64_t>(_numTicksRecorded);
+		_buffer.Write<uint64_t>(indexOffset);
+		_buffer.Write<uint32_t>(REPLAY_MAGIC);
+	}
+	_Flush();
+
+	bool success = _fileStream.good();
+	_fileStream.close();
+	return success;
+}
+
+void ReplayRecorder::Close() {
+	if (!_Close())
+		RS_ERR_CLOSE("ReplayRecorder::Close(): Failed to write replay");
+}
+
+ReplayRecorder::~ReplayRecorder() {
+	_Close();
+}
+
+RS_NS_END
@@ -0,0 +1,109 @@
+#pragma once
+#include "../Arena/Arena.h"
+
+#include <unordered_map>
+
+RS_NS_START
+
+// Follows the RocketSim version ID at the start of files written by ReplayRecorder
+constexpr uint32_t REPLAY_MAGIC = 0x4C505253; // "SRPL"
+
+// Every record of a replay file starts with its type
+// Ticks in a replay are counted from the start of the recording, as the arena's tickCount can be changed between steps
+enum class ReplayRecordType : uint8_t {
+	// u64 tick, u8 discontinuity, u32 size, then Arena::Serialize() and ArenaSnapshot::Serialize()
+	// Both are written field by field, so keyframes hold no pointers or struct padding
+	KEYFRAME = 1,
+
+	// u32 amount of cars whose controls changed, then the u32 ID and controls (as in Car::Serialize()) of each
+	TICK = 2,
+
+	// u32 amount of keyframes, then u64 tick, u64 offset, and u8 discontinuity of each, then u64 amount of ticks
+	// Written when closing, followed by the u64 offset of this record and REPLAY_MAGIC at the very end of the file
+	INDEX = 3
+};
+
+struct ReplayRecorderConfig {
+	// Ticks between periodic keyframes, so seeking never simulates more than this many ticks
+	uint32_t keyframeInterval = 1200;
+
+	// Records are written to the file once this many bytes are waiting
+	size_t flushSize = 1 << 20;
+};
+
+// Records every tick an arena simulates to a replay file, which ReplayPlayer can seek through by tick
+// Ticks are stored as the controls of the cars whose controls changed, and every keyframeInterval ticks
+//	the arena is stored in full, including everything needed to re-simulate the exact same ticks from there
+// Other changes to the arena between steps (adding/removing cars, SetState(), kickoff resets, etc.) are found
+//	by comparing the cars, ball, and boost pads against how the last tick left them, and are stored as a new keyframe
+// NOTE: Changes to anything else (e.g. mutators or car configs) are not found, call RequestKeyframe() after making them
+class ReplayRecorder {
+public:
+	ReplayRecorderConfig config;
+
+	// Starts recording the arena's next ticks
+	// Only one replay recorder can record an arena at a time
+	RSAPI ReplayRecorder(Arena* arena, std::filesystem::path filePath, const ReplayRecorderConfig& config = {});
+
+	ReplayRecorder(const ReplayRecorder& other) = delete;
+	ReplayRecorder& operator =(const ReplayRecorder& other) = delete;
+
+	// Store the arena in full before the next tick
+	void RequestKeyframe() {
+		_keyframeRequested = true;
+	}
+
+	// Write the remaining records and the keyframe index, and stop recording
+	// Also done when the recorder or its arena is destroyed
+	RSAPI void Close();
+
+	// Close(), but returns false instead of throwing if writing failed
+	bool _Close();
+
+	bool IsOpen() const {
+		return _arena != NULL;
+	}
+
+	uint64_t GetNumTicksRecorded() const {
+		return _numTicksRecorded;
+	}
+
+	RSAPI ~ReplayRecorder();
+
+	// Called by the arena at the start and end of every tick
+	void _BeginTick();
+	void _EndTick();
+
+	struct _Keyframe {
+		uint64_t tick;
+		uint64_t offset;
+		bool discontinuity;
+	};
+
+	Arena* _arena;
+	std::ofstream _fileStream;
+
+	// Records that are not written to the file yet, which start at _bufferOffset in the file
+	DataStreamOut _buffer;
+	uint64_t _bufferOffset = 0;
+
+	std::vector<_Keyframe> _keyframes;
+	uint64_t _numTicksRecorded = 0;
+	bool _keyframeRequested = false;
+
+	// Controls each car had last tick, to only store the ones that change
+	std::unordered_map<uint32_t, CarControls> _lastControls;
+
+	// Re-used for every keyframe
+	ArenaSnapshot _snapshot;
+	DataStreamOut _keyframeStream;
+
+	// State of the cars and ball at the end of the last tick, and at the start of this one
+	DataStreamOut _endState, _beginState;
+
+	void _WriteState(DataStreamOut& out) const;
+	void _WriteKeyframe(bool discontinuity);
+	void _Flush();
+};
+
+RS_NS_END
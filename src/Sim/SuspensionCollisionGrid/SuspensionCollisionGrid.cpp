@@ -25,7 +25,9 @@ void _SetupWorldCollision(SuspensionCollisionGrid& grid, const std::vector<btBvh
 
 	Vec cellSizeBT = grid.GetCellSize<LIGHT>() * UU_TO_BT;
 
-	// Enable cell.worldCollision for all cells that contain one or more triangle mesh's geometry
+	std::vector<bool> cellsWithin(grid.CELL_AMOUNT_TOTAL[LIGHT], false);
+
+	// Enable world collision for all cells that contain one or more triangle mesh's geometry
 	for (btBvhTriangleMeshShape* triMeshShape : triMeshShapes) {	
 		btVector3 rbMinBT, rbMaxBT;
 		triMeshShape->getAabb(btTransform(), rbMinBT, rbMaxBT);
@@ -51,9 +53,9 @@ void _SetupWorldCollision(SuspensionCollisionGrid& grid, const std::vector<btBvh
 					if (boolCallback.hit) {
 						for (int k = 0; k < grid.CELL_AMOUNT_Z[LIGHT]; k++) {
 
-							SuspensionCollisionGrid::Cell& cell = grid.Get<LIGHT>(i, j, k);
+							auto cell = cellsWithin[grid.GetCellIdx<LIGHT>(i, j, k)];
 
-							if (!cell.worldCollision) {
+							if (!cell) {
 
 								Vec
 									cellMinBT = grid.GetCellMin<LIGHT>(i, j, k) * UU_TO_BT,
@@ -62,7 +64,7 @@ void _SetupWorldCollision(SuspensionCollisionGrid& grid, const std::vector<btBvh
 								boolCallback.hit = false;
 								triMeshShape->processAllTriangles(&boolCallback, cellMinBT, cellMaxBT);
 								if (boolCallback.hit) {
-									cell.worldCollision = true;
+									cell = true;
 									totalCellsWithin++;
 								}
 							}
@@ -73,29 +75,27 @@ void _SetupWorldCollision(SuspensionCollisionGrid& grid, const std::vector<btBvh
 		}
 	}
 
-	SuspensionCollisionGrid clone = SuspensionCollisionGrid(grid.gameMode, grid.lightMem);
-	clone.Allocate();
+	auto worldCollisionCells = std::make_shared<std::vector<bool>>(grid.CELL_AMOUNT_TOTAL[LIGHT], false);
 
-	// Make cell.worldCollision bleed to all surrounding cells
+	// Make world collision bleed to all surrounding cells
 	for (int i = 0; i < grid.CELL_AMOUNT_X[LIGHT]; i++) {
 		for (int j = 0; j < grid.CELL_AMOUNT_Y[LIGHT]; j++) {
 			for (int k = 0; k < grid.CELL_AMOUNT_Z[LIGHT]; k++) {
 
-				SuspensionCollisionGrid::Cell& cell = grid.Get<LIGHT>(i, j, k);
-				if (cell.worldCollision) {
+				if (cellsWithin[grid.GetCellIdx<LIGHT>(i, j, k)]) {
 					for (int i2 = -1; i2 < 2; i2++) {
 						for (int j2 = -1; j2 < 2; j2++) {
 							for (int k2 = -1; k2 < 2; k2++) {
 
-								SuspensionCollisionGrid::Cell& otherCell = clone.Get<LIGHT>(
+								auto otherCell = (*worldCollisionCells)[grid.GetCellIdx<LIGHT>(
 									RS_CLAMP(i + i2, 0, grid.CELL_AMOUNT_X[LIGHT] - 1),
 									RS_CLAMP(j + j2, 0, grid.CELL_AMOUNT_Y[LIGHT] - 1),
 									RS_CLAMP(k + k2, 0, grid.CELL_AMOUNT_Z[LIGHT] - 1)
-								);
+								)];
 
-								if (!otherCell.worldCollision)
+								if (!otherCell)
 									totalCellsBled++;
-								otherCell.worldCollision = true;
+								otherCell = true;
 							}
 						}
 					}
@@ -104,7 +104,7 @@ void _SetupWorldCollision(SuspensionCollisionGrid& grid, const std::vector<btBvh
 		}
 	}
 
-	grid = clone;
+	grid.worldCollisionCells = worldCollisionCells;
 
 	RS_LOG(
 		"SuspensionCollisionGrid::Setup(): Built suspension collision grid, " <<
@@ -126,9 +126,9 @@ btCollisionObject* _CastSuspensionRay(
 	SuspensionCollisionGrid& grid, btVehicleRaycaster* raycaster, 
 	Vec start, Vec end, const btCollisionObject* ignoreObj, btVehicleRaycaster::btVehicleRaycasterResult& result
 ) {
-	SuspensionCollisionGrid::Cell& cell = grid.GetCellFromPos<LIGHT>(start * BT_TO_UU);
+	int cellIdx = grid.GetCellIdxFromPos<LIGHT>(start * BT_TO_UU);
 
-	if (cell.worldCollision || cell.dynamicCollision) {
+	if ((*grid.worldCollisionCells)[cellIdx] || grid.dynamicCollisionCells[cellIdx]) {
 		// TODO: Do world-only or dynamic-only raycasts
 		return (btCollisionObject*)raycaster->castRay(start, end, ignoreObj, result);
 	} else {
@@ -195,7 +195,7 @@ void _UpdateDynamicCollisions(SuspensionCollisionGrid& grid, Vec minBT, Vec maxB
 	for (int i = i1; i <= i2; i++)
 		for (int j = j1; j <= j2; j++)
 			for (int k = k1; k <= k2; k++)
-				grid.Get<LIGHT>(i, j, k).dynamicCollision = true;
+				grid.dynamicCollisionCells[grid.GetCellIdx<LIGHT>(i, j, k)] = true;
 
 	grid.dynamicCellRanges.push_back(
 		{
@@ -219,7 +219,7 @@ void _ClearDynamicCollisions(SuspensionCollisionGrid& grid) {
 		for (int i = range.minX; i <= range.maxX; i++)
 			for (int j = range.minY; j <= range.maxY; j++)
 				for (int k = range.minZ; k <= range.maxZ; k++)
-					grid.Get<LIGHT>(i, j, k).dynamicCollision = false;
+					grid.dynamicCollisionCells[grid.GetCellIdx<LIGHT>(i, j, k)] = false;
 	}
 
 	grid.dynamicCellRanges.clear();
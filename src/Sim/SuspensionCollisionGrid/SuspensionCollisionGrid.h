@@ -28,12 +28,6 @@ struct SuspensionCollisionGrid {
 	// Make sure cell sizes arent't too small, a ray shouldn't be able to travel through multiple cells
 	static_assert(RS_MIN(CELL_SIZE_X[0], RS_MIN(CELL_SIZE_Y[0], CELL_SIZE_Z[0])) > 60, "SuspensionCollisionGrid cells are too small");
 
-	struct Cell {
-		bool 
-			worldCollision = false, 
-			dynamicCollision = false;
-	};
-
 	struct CellRange {
 		int minX, minY, minZ;
 		int maxX, maxY, maxZ;
@@ -52,16 +46,21 @@ struct SuspensionCollisionGrid {
 		cache.height_bt = (isHoops ? RLConst::ARENA_HEIGHT : RLConst::ARENA_HEIGHT) * UU_TO_BT;
 	}
 
-	std::vector<Cell> cellData;
+	// Whether each cell is near any world collision, built by SetupWorldCollision()
+	// This never changes once built, so all copies of a grid share it
+	std::shared_ptr<const std::vector<bool>> worldCollisionCells;
+
+	// Whether each cell is near any dynamic collision this tick, every copy of a grid has its own
+	std::vector<bool> dynamicCollisionCells;
 
+	// Allocates the dynamic collision cells
 	void Allocate() {
-		cellData.resize(CELL_AMOUNT_TOTAL[lightMem]);
+		dynamicCollisionCells.assign(CELL_AMOUNT_TOTAL[lightMem], false);
 	}
 
 	template <bool LIGHT>
-	Cell& Get(int i, int j, int k) {
-		int index = (i * CELL_AMOUNT_Y[LIGHT] * CELL_AMOUNT_Z[LIGHT]) + (j * CELL_AMOUNT_Z[LIGHT]) + k;
-		return cellData[index];
+	int GetCellIdx(int i, int j, int k) const {
+		return (i * CELL_AMOUNT_Y[LIGHT] * CELL_AMOUNT_Z[LIGHT]) + (j * CELL_AMOUNT_Z[LIGHT]) + k;
 	}
 
 	template <bool LIGHT>
@@ -81,10 +80,10 @@ struct SuspensionCollisionGrid {
 	}
 
 	template <bool LIGHT>
-	Cell& GetCellFromPos(Vec pos) {
+	int GetCellIdxFromPos(Vec pos) const {
 		int i, j, k;
 		GetCellIndicesFromPos<LIGHT>(pos, i, j, k);
-		return Get<LIGHT>(i, j, k);
+		return GetCellIdx<LIGHT>(i, j, k);
 	}
 
 	template <bool LIGHT>
@@ -0,0 +1,83 @@
+#include "VecArena.h"
+
+RS_NS_START
+
+VecArena* VecArena::Create(GameMode gameMode, size_t arenaAmount, const ArenaConfig& arenaConfig, float tickRate) {
+	VecArena* vecArena = new VecArena();
+
+	vecArena->arenas.reserve(arenaAmount);
+	for (size_t i = 0; i < arenaAmount; i++)
+		vecArena->arenas.push_back(Arena::Create(gameMode, arenaConfig, tickRate));
+
+	return vecArena;
+}
+
+VecArena* VecArena::Create(const std::vector<Arena*>& arenas) {
+	for (size_t i = 0; i < arenas.size(); i++)
+		for (size_t j = i + 1; j < arenas.size(); j++)
+			if (arenas[i] == arenas[j])
+				RS_ERR_CLOSE("VecArena::Create(): Arena at index " << j << " is a duplicate of index " << i);
+
+	VecArena* vecArena = new VecArena();
+	vecArena->arenas = arenas;
+	vecArena->ownsArenas = false;
+	return vecArena;
+}
+
+size_t VecArena::GetCarAmount() const {
+	size_t total = 0;
+	for (Arena* arena : arenas)
+		total += arena->_cars.size();
+	return total;
+}
+
+std::vector<Car*> VecArena::GetCars() const {
+	std::vector<Car*> cars;
+	cars.reserve(GetCarAmount());
+	for (Arena* arena : arenas)
+		cars.insert(cars.end(), arena->_cars.begin(), arena->_cars.end());
+	return cars;
+}
+
+Car* VecArena::AddCar(size_t arenaIndex, Team team, const CarConfig& config) {
+	if (arenaIndex >= arenas.size())
+		RS_ERR_CLOSE("VecArena::AddCar(): Arena index " << arenaIndex << " is out of range (arena amount: " << arenas.size() << ")");
+
+	return arenas[arenaIndex]->AddCar(team, config);
+}
+
+bool VecArena::RemoveCar(size_t arenaIndex, uint32_t carID) {
+	if (arenaIndex >= arenas.size())
+		RS_ERR_CLOSE("VecArena::RemoveCar(): Arena index " << arenaIndex << " is out of range (arena amount: " << arenas.size() << ")");
+
+	return arenas[arenaIndex]->RemoveCar(carID);
+}
+
+void VecArena::Step(int ticksToSimulate) {
+	for (Arena* arena : arenas)
+		arena->Step(ticksToSimulate);
+}
+
+void VecArena::UpdateStates() {
+	carOffsets.resize(arenas.size() + 1);
+	carStates.resize(GetCarAmount());
+	ballStates.resize(arenas.size());
+
+	size_t carIdx = 0;
+	for (size_t i = 0; i < arenas.size(); i++) {
+		carOffsets[i] = carIdx;
+		for (Car* car : arenas[i]->_cars)
+			carStates[carIdx++] = car->GetState();
+
+		ballStates[i] = arenas[i]->ball->GetState();
+	}
+	carOffsets[arenas.size()] = carIdx;
+}
+
+VecArena::~VecArena() {
+	if (ownsArenas)
+		for (Arena* arena : arenas)
+			delete arena;
+}
+
+RS_NS_END
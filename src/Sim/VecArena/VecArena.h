@@ -0,0 +1,67 @@
+#pragma once
+#include "../Arena/Arena.h"
+
+RS_NS_START
+
+// A batch of arenas that are stepped and read together
+// Step() just calls Arena::Step() on each arena in turn, so each one simulates exactly as it would on its own
+// UpdateStates() gathers every car and ball state into contiguous arrays, to be read in one go
+class VecArena {
+public:
+
+	std::vector<Arena*> arenas;
+
+	// Whether the arenas are destroyed with the VecArena
+	bool ownsArenas = true;
+
+	// Contiguous copies of all car and ball states, filled by UpdateStates()
+	// Cars from arena i are in carStates[carOffsets[i]] to carStates[carOffsets[i + 1] - 1], in the order of Arena::GetCars()
+	// ballStates uses the same indexing as arenas
+	std::vector<CarState> carStates;
+	std::vector<size_t> carOffsets;
+	std::vector<BallState> ballStates;
+
+	// NOTE: VecArena should be destroyed after use
+	RSAPI static VecArena* Create(GameMode gameMode, size_t arenaAmount, const ArenaConfig& arenaConfig = {}, float tickRate = 120);
+
+	// Batch existing arenas, which can have different setups
+	// NOTE: The arenas are not owned, and must not be destroyed while the VecArena still uses them
+	RSAPI static VecArena* Create(const std::vector<Arena*>& arenas);
+
+	VecArena(const VecArena& other) = delete;
+	VecArena& operator =(const VecArena& other) = delete;
+
+	size_t GetArenaAmount() const {
+		return arenas.size();
+	}
+
+	Arena* GetArena(size_t index) {
+		return arenas[index];
+	}
+
+	RSAPI size_t GetCarAmount() const;
+
+	// Returns all cars across all arenas, in the same order as carStates
+	RSAPI std::vector<Car*> GetCars() const;
+
+	RSAPI Car* AddCar(size_t arenaIndex, Team team, const CarConfig& config = CAR_CONFIG_OCTANE);
+
+	// Returns false if the car ID was not found in that arena's cars list
+	RSAPI bool RemoveCar(size_t arenaIndex, uint32_t carID);
+
+	// Simulate every arena for a given number of ticks, one arena after another
+	// An arena that is stopped (see Arena::Stop()) only stops itself, the others still simulate all ticks
+	RSAPI void Step(int ticksToSimulate = 1);
+
+	// Copy the current state of every car and ball into carStates and ballStates
+	RSAPI void UpdateStates();
+
+	// Free all arenas, if owned
+	RSAPI ~VecArena();
+
+private:
+	// Constructor for use by VecArena::Create()
+	VecArena() = default;
+};
+
+RS_NS_END
@@ -64,6 +64,20 @@ const btTransform& btVehicleRL::getWheelTransformWS(int wheelIndex) const {
 void btVehicleRL::updateWheelTransform(int wheelIndex) {
 	btWheelInfoRL& wheel = m_wheelInfo[wheelIndex];
 	updateWheelTransformsWS(wheel);
+	_updateWheelWorldTransform(wheel);
+}
+
+void btVehicleRL::updateWheelTransforms() {
+	// Every wheel is placed from the same chassis transform
+	const btTransform& chassisTrans = getChassisWorldTransform();
+	for (int i = 0; i < getNumWheels(); i++) {
+		btWheelInfoRL& wheel = m_wheelInfo[i];
+		updateWheelTransformsWS(wheel, chassisTrans);
+		_updateWheelWorldTransform(wheel);
+	}
+}
+
+void btVehicleRL::_updateWheelWorldTransform(btWheelInfoRL& wheel) {
 	btVector3 up = -wheel.m_raycastInfo.m_wheelDirectionWS;
 	const btVector3& right = wheel.m_raycastInfo.m_wheelAxleWS;
 	btVector3 fwd = up.cross(right);
@@ -106,28 +120,33 @@ void btVehicleRL::resetSuspension() {
 
 // See: I20 or I21
 void btVehicleRL::updateWheelTransformsWS(btWheelInfoRL& wheel) {
+	updateWheelTransformsWS(wheel, getChassisWorldTransform());
+}
+
+void btVehicleRL::updateWheelTransformsWS(btWheelInfoRL& wheel, const btTransform& chassisTrans) {
 	wheel.m_raycastInfo.m_isInContact = false;
 	wheel.m_isInContactWithWorld = false;
 
-	btTransform chassisTrans = getChassisWorldTransform();
 	wheel.m_raycastInfo.m_hardPointWS = chassisTrans(wheel.m_chassisConnectionPointCS);
 	wheel.m_raycastInfo.m_wheelDirectionWS = chassisTrans.getBasis() * wheel.m_wheelDirectionCS;
 	wheel.m_raycastInfo.m_wheelAxleWS = chassisTrans.getBasis() * wheel.m_wheelAxleCS;
 }
 
-float btVehicleRL::rayCast(btWheelInfoRL& wheel, SuspensionCollisionGrid* grid) {
-	updateWheelTransformsWS(wheel);
-
-	float depth = -1;
-
+// See: I21
+float btVehicleRL::_getSuspensionRay(const btWheelInfoRL& wheel, btVector3& source, btVector3& target) const {
 	float suspensionTravel = wheel.m_maxSuspensionTravelCm / 100;
 	float realRayLength = wheel.getSuspensionRestLength() + suspensionTravel + wheel.m_wheelsRadius - RLConst::BTVehicle::SUSPENSION_SUBTRACTION;
 
-	// See: I21
-	btVector3 source = wheel.m_raycastInfo.m_hardPointWS;
-	btVector3 target = source + (wheel.m_raycastInfo.m_wheelDirectionWS * realRayLength);
-	wheel.m_raycastInfo.m_contactPointWS = target;
-	wheel.m_raycastInfo.m_groundObject = NULL;
+	source = wheel.m_raycastInfo.m_hardPointWS;
+	target = source + (wheel.m_raycastInfo.m_wheelDirectionWS * realRayLength);
+	return realRayLength;
+}
+
+float btVehicleRL::rayCast(btWheelInfoRL& wheel, SuspensionCollisionGrid* grid) {
+	updateWheelTransformsWS(wheel);
+
+	btVector3 source, target;
+	float realRayLength = _getSuspensionRay(wheel, source, target);
 
 	// See: I22
 	btVehicleRaycaster::btVehicleRaycasterResult rayResults;
@@ -140,7 +159,20 @@ float btVehicleRL::rayCast(btWheelInfoRL& wheel, SuspensionCollisionGrid* grid)
 		object = (btCollisionObject*)m_vehicleRaycaster->castRay(source, target, m_chassisBody, rayResults);
 	}
 
-	// See: I23
+	return _applyRayResult(wheel, target, realRayLength, object, rayResults, getUpVector());
+}
+
+// See: I23
+float btVehicleRL::_applyRayResult(
+	btWheelInfoRL& wheel, const btVector3& target, float realRayLength,
+	btCollisionObject* object, const btVehicleRaycaster::btVehicleRaycasterResult& rayResults, const btVector3& upDir) {
+
+	float depth = -1;
+	float suspensionTravel = wheel.m_maxSuspensionTravelCm / 100;
+
+	wheel.m_raycastInfo.m_contactPointWS = target;
+	wheel.m_raycastInfo.m_groundObject = NULL;
+
 	if (object) {
 		wheel.m_raycastInfo.m_contactPointWS = rayResults.m_hitPointInWorld;
 		float fraction = rayResults.m_distFraction;
@@ -151,7 +183,7 @@ float btVehicleRL::rayCast(btWheelInfoRL& wheel, SuspensionCollisionGrid* grid)
 
 		wheel.m_raycastInfo.m_groundObject = object;
 
-		float wheelTraceLenSq = (wheel.m_raycastInfo.m_hardPointWS - wheel.m_raycastInfo.m_contactPointWS).dot(getUpVector());
+		float wheelTraceLenSq = (wheel.m_raycastInfo.m_hardPointWS - wheel.m_raycastInfo.m_contactPointWS).dot(upDir);
 		wheel.m_raycastInfo.m_suspensionLength = wheelTraceLenSq - wheel.m_wheelsRadius;
 
 		//clamp on max suspension travel
@@ -164,7 +196,7 @@ float btVehicleRL::rayCast(btWheelInfoRL& wheel, SuspensionCollisionGrid* grid)
 				wheel.getSuspensionRestLength() + suspensionTravel
 			);
 
-		float denominator = wheel.m_raycastInfo.m_contactNormalWS.dot(getUpVector());
+		float denominator = wheel.m_raycastInfo.m_contactNormalWS.dot(upDir);
 
 		btVector3 relpos = wheel.m_raycastInfo.m_contactPointWS - m_chassisBody->getWorldTransform().m_origin;
 		wheel.m_velAtContactPoint = m_chassisBody->getVelocityInLocalPoint(relpos);
@@ -217,20 +249,38 @@ const btTransform& btVehicleRL::getChassisWorldTransform() const {
 
 void btVehicleRL::updateVehicleFirst(float step, SuspensionCollisionGrid* grid) {
 
-	for (int i = 0; i < getNumWheels(); i++)
-		updateWheelTransform(i);
+	updateWheelTransforms();
 
 	//
 	// simulate suspension
 	//
 
-	int i = 0;
-	for (i = 0; i < m_wheelInfo.size(); i++) {
-		//float depth;
-		//depth =
-		rayCast(m_wheelInfo[i], grid);
+	int numWheels = getNumWheels();
+	btAssert(numWheels <= MAX_WHEELS);
+
+	// The rays only depend on the wheel transforms, so all wheels are cast together
+	btVector3 sources[MAX_WHEELS], targets[MAX_WHEELS];
+	float realRayLengths[MAX_WHEELS];
+	for (int i = 0; i < numWheels; i++)
+		realRayLengths[i] = _getSuspensionRay(m_wheelInfo[i], sources[i], targets[i]);
+
+	btVehicleRaycaster::btVehicleRaycasterResult rayResults[MAX_WHEELS];
+	btCollisionObject* objects[MAX_WHEELS];
+
+	btAssert(m_vehicleRaycaster);
+	for (int i = 0; i < numWheels; i++) {
+		if (grid) {
+			objects[i] = grid->CastSuspensionRay(m_vehicleRaycaster, sources[i], targets[i], m_chassisBody, rayResults[i]);
+		} else {
+			objects[i] = (btCollisionObject*)m_vehicleRaycaster->castRay(sources[i], targets[i], m_chassisBody, rayResults[i]);
+		}
 	}
 
+	// Applying a hit only reads the chassis, m_extraPushback is stored and later added to the suspension force
+	btVector3 upDir = getUpVector();
+	for (int i = 0; i < numWheels; i++)
+		_applyRayResult(m_wheelInfo[i], targets[i], realRayLengths[i], objects[i], rayResults[i], upDir);
+
 	calcFrictionImpulses(step);
 }
 
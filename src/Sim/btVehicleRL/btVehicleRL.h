@@ -29,6 +29,9 @@ struct btWheelInfoRL : public btWheelInfo {
 // This is a modified version of btRaycastVehicle to more accurately follow Rocket League
 class btVehicleRL : public btActionInterface {
 public:
+	// Cars always have 4 wheels, this only sizes per-wheel scratch arrays
+	constexpr static int MAX_WHEELS = 4;
+
 	btAlignedObjectArray<btVector3> m_forwardWS;
 	btAlignedObjectArray<btVector3> m_axle;
 	btAlignedObjectArray<float> m_forwardImpulse;
@@ -88,6 +91,16 @@ public:
 
 	float rayCast(btWheelInfoRL& wheel, struct SuspensionCollisionGrid* grid);
 
+	// Returns the length of the wheel's suspension ray, and where it goes
+	float _getSuspensionRay(const btWheelInfoRL& wheel, btVector3& source, btVector3& target) const;
+
+	// Updates the wheel's contact and suspension from what its suspension ray hit (object is NULL on a miss)
+	// Returns the hit depth along the ray, or -1 on a miss
+	float _applyRayResult(
+		btWheelInfoRL& wheel, const btVector3& target, float realRayLength,
+		btCollisionObject* object, const btVehicleRaycaster::btVehicleRaycasterResult& rayResults, const btVector3& upDir
+	);
+
 	void updateVehicleFirst(float step, struct SuspensionCollisionGrid* grid);
 	void updateVehicleSecond(float step);
 
@@ -103,6 +116,11 @@ public:
 
 	void updateWheelTransform(int wheelIndex);
 
+	// Same as updateWheelTransform() for every wheel, but only reads the chassis transform once
+	void updateWheelTransforms();
+
+	void _updateWheelWorldTransform(btWheelInfoRL& wheel);
+
 	//	void	setRaycastWheelInfo( int wheelIndex , bool isInContact, const btVector3& hitPoint, const btVector3& hitNormal,float depth);
 
 	btWheelInfoRL& addWheel(const btVector3& connectionPointCS0, const btVector3& wheelDirectionCS0, const btVector3& wheelAxleCS, float suspensionRestLength, float wheelRadius, const btVehicleTuning& tuning, bool isFrontWheel);
@@ -118,6 +136,7 @@ public:
 	btWheelInfoRL& getWheelInfo(int index);
 
 	void updateWheelTransformsWS(btWheelInfoRL& wheel);
+	void updateWheelTransformsWS(btWheelInfoRL& wheel, const btTransform& chassisTrans);
 
 	void setBrake(float brake, int wheelIndex);
 